@@ -77,6 +77,10 @@ void _enter_irq(u32_t ipending)
 	read_timer_start_of_isr();
 #endif
 
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+	_latency_hist_isr_start();
+#endif
+
 	_kernel.nested++;
 
 #ifdef CONFIG_IRQ_OFFLOAD
@@ -96,6 +100,9 @@ void _enter_irq(u32_t ipending)
 #ifdef CONFIG_EXECUTION_BENCHMARKING
 		extern void read_timer_end_of_isr(void);
 		read_timer_end_of_isr();
+#endif
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+		_latency_hist_isr_handler(index);
 #endif
 		ite->isr(ite->arg);
 		sys_trace_isr_exit();
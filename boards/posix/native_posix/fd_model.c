@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Model of host file descriptors raising interrupts
+ *
+ * A driver backed by a host file descriptor (like a TAP device) can have an
+ * interrupt raised when the descriptor becomes readable, instead of polling
+ * it from a thread.
+ *
+ * The watched descriptors are checked each time the HW models are about to
+ * advance the simulated time. In real time mode the HW models block on them
+ * until the host time of the next event, so a descriptor becoming readable in
+ * between raises its interrupt at once, at the simulated time matching the
+ * host time.
+ *
+ * A watch is one shot: after raising its interrupt, the descriptor is not
+ * checked again until the driver arms it again with hwfd_watch(), normally
+ * once it has read everything pending on it.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <sys/select.h>
+#include "hw_models_top.h"
+#include "timer_model.h"
+#include "irq_ctrl.h"
+#include "fd_model.h"
+#include "zephyr/types.h"
+#include "misc/util.h"
+
+#define HWFD_MAX_WATCHES 4
+
+u64_t hwfd_timer = NEVER;
+
+static struct {
+	int fd;
+	unsigned int irq;
+	bool armed;
+	bool ready;
+} watches[HWFD_MAX_WATCHES];
+
+static int num_watches;
+
+void hwfd_init(void)
+{
+	hwfd_timer = NEVER;
+	num_watches = 0;
+}
+
+void hwfd_cleanup(void)
+{
+
+}
+
+/**
+ * Raise <irq> once <fd> is readable
+ *
+ * May be called from SW threads. If <fd> is already watched, its watch is
+ * armed again.
+ *
+ * Returns 0, or -ENOMEM if too many descriptors are watched
+ */
+int hwfd_watch(int fd, unsigned int irq)
+{
+	int i;
+
+	for (i = 0; i < num_watches; i++) {
+		if (watches[i].fd == fd) {
+			break;
+		}
+	}
+
+	if (i == num_watches) {
+		if (num_watches == HWFD_MAX_WATCHES) {
+			return -ENOMEM;
+		}
+
+		num_watches++;
+	}
+
+	watches[i].fd = fd;
+	watches[i].irq = irq;
+	watches[i].armed = true;
+	watches[i].ready = false;
+
+	return 0;
+}
+
+void hwfd_unwatch(int fd)
+{
+	for (int i = 0; i < num_watches; i++) {
+		if (watches[i].fd == fd) {
+			watches[i] = watches[--num_watches];
+			return;
+		}
+	}
+}
+
+/**
+ * Wait for the armed descriptors until the simulated time <time> is due,
+ * without blocking when not in real time mode
+ *
+ * If some become readable, the fd timer is set to the current simulated time
+ */
+void hwfd_wait_until(u64_t time)
+{
+	struct timeval timeout, *timeoutp = &timeout;
+	s64_t wait;
+	fd_set rset;
+	int max_fd = -1;
+	int i, ret;
+
+	FD_ZERO(&rset);
+
+	for (i = 0; i < num_watches; i++) {
+		if (watches[i].armed) {
+			FD_SET(watches[i].fd, &rset);
+			max_fd = max(max_fd, watches[i].fd);
+		}
+	}
+
+	if (max_fd < 0 || hwfd_timer != NEVER) {
+		return;
+	}
+
+	wait = hwtimer_get_real_time_until(time);
+	if (wait < 0) {
+		timeoutp = NULL;
+	} else {
+		timeout.tv_sec = wait / 1000000;
+		timeout.tv_usec = wait % 1000000;
+	}
+
+	ret = select(max_fd + 1, &rset, NULL, NULL, timeoutp);
+	if (ret <= 0) {
+		/* timed out, or interrupted by a signal */
+		return;
+	}
+
+	for (i = 0; i < num_watches; i++) {
+		if (watches[i].armed && FD_ISSET(watches[i].fd, &rset)) {
+			watches[i].armed = false;
+			watches[i].ready = true;
+		}
+	}
+
+	hwfd_timer = min(max(hwtimer_get_simu_time_from_host(),
+			     hwm_get_time()), time);
+	hwm_find_next_timer();
+}
+
+void hwfd_timer_reached(void)
+{
+	hwfd_timer = NEVER;
+
+	for (int i = 0; i < num_watches; i++) {
+		if (watches[i].ready) {
+			watches[i].ready = false;
+			hw_irq_ctrl_set_irq(watches[i].irq);
+		}
+	}
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _NATIVE_POSIX_FD_MODEL_H
+#define _NATIVE_POSIX_FD_MODEL_H
+
+#include "hw_models_top.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void hwfd_init(void);
+void hwfd_cleanup(void);
+void hwfd_wait_until(u64_t time);
+void hwfd_timer_reached(void);
+
+int hwfd_watch(int fd, unsigned int irq);
+void hwfd_unwatch(int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NATIVE_POSIX_FD_MODEL_H */
@@ -15,6 +15,7 @@
 #include "hw_models_top.h"
 #include "timer_model.h"
 #include "irq_ctrl.h"
+#include "fd_model.h"
 #include "posix_board_if.h"
 #include "posix_soc_if.h"
 #include "posix_arch_internal.h"
@@ -26,13 +27,15 @@ static u64_t end_of_time = NEVER; /* When will this device stop */
 /* List of HW model timers: */
 extern u64_t hw_timer_timer; /* When should this timer_model be called */
 extern u64_t irq_ctrl_timer;
+extern u64_t hwfd_timer;
 
-static enum { HWTIMER = 0, IRQCNT, NUMBER_OF_TIMERS, NONE }
+static enum { HWTIMER = 0, IRQCNT, HWFD, NUMBER_OF_TIMERS, NONE }
 	next_timer_index = NONE;
 
 static u64_t *Timer_list[NUMBER_OF_TIMERS] = {
 	&hw_timer_timer,
-	&irq_ctrl_timer
+	&irq_ctrl_timer,
+	&hwfd_timer
 };
 
 static u64_t next_timer_time;
@@ -80,6 +83,9 @@ void hwm_set_sig_handler(void)
 
 static void hwm_sleep_until_next_timer(void)
 {
+	/* host file descriptors may become ready before the next timer */
+	hwfd_wait_until(next_timer_time);
+
 	if (next_timer_time >= simu_time) { /* LCOV_EXCL_BR_LINE */
 		simu_time = next_timer_time;
 	} else {
@@ -134,6 +140,9 @@ void hwm_main_loop(void)
 		case IRQCNT:
 			hw_irq_ctrl_timer_triggered();
 			break;
+		case HWFD:
+			hwfd_timer_reached();
+			break;
 		default:
 			/* LCOV_EXCL_START */
 			posix_print_error_and_exit(
@@ -175,6 +184,7 @@ void hwm_init(void)
 	hwm_set_sig_handler();
 	hwtimer_init();
 	hw_irq_ctrl_init();
+	hwfd_init();
 
 	hwm_find_next_timer();
 }
@@ -188,6 +198,7 @@ void hwm_cleanup(void)
 {
 	hwtimer_cleanup();
 	hw_irq_ctrl_cleanup();
+	hwfd_cleanup();
 }
 
 
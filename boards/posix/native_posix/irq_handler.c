@@ -38,6 +38,10 @@ static inline void vector_to_irq(int irq_nbr, int *may_swap)
 
 	sys_trace_isr_enter();
 
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+	_latency_hist_isr_start();
+#endif
+
 	if (irq_vector_table[irq_nbr].func == NULL) { /* LCOV_EXCL_BR_LINE */
 		/* LCOV_EXCL_START */
 		posix_print_error_and_exit("Received irq %i without a "
@@ -45,6 +49,9 @@ static inline void vector_to_irq(int irq_nbr, int *may_swap)
 					irq_nbr);
 		/* LCOV_EXCL_STOP */
 	} else {
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+		_latency_hist_isr_handler(irq_nbr);
+#endif
 		if (irq_vector_table[irq_nbr].flags & ISR_FLAG_DIRECT) {
 			*may_swap |= ((direct_irq_f_ptr)
 					irq_vector_table[irq_nbr].func)();
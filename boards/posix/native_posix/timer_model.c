@@ -278,6 +278,43 @@ s64_t hwtimer_get_pending_silent_ticks(void)
 }
 
 
+/**
+ * Return how long, in host microseconds, the HW models should block before
+ * reaching the simulated time <time>: 0 when not running in real time mode or
+ * when <time> has already passed, and -1 if <time> is never.
+ */
+s64_t hwtimer_get_real_time_until(u64_t time)
+{
+	s64_t diff;
+
+	if (!real_time_mode) {
+		return 0;
+	}
+
+	if (time == NEVER) {
+		return -1;
+	}
+
+	diff = (time - last_radj_stime) / clock_ratio + last_radj_rtime
+	       - get_host_us_time();
+
+	return max(diff, 0);
+}
+
+/**
+ * Return the simulated time matching the current host time, or the current
+ * simulated time when not running in real time mode
+ */
+u64_t hwtimer_get_simu_time_from_host(void)
+{
+	if (!real_time_mode) {
+		return hwm_get_time();
+	}
+
+	return (s64_t)(get_host_us_time() - last_radj_rtime) * clock_ratio
+	       + last_radj_stime;
+}
+
 /**
  * During boot set the real time clock simulated time not start
  * from the real host time
@@ -22,6 +22,8 @@ void hwtimer_wake_in_time(u64_t time);
 void hwtimer_set_silent_ticks(s64_t sys_ticks);
 void hwtimer_enable(u64_t period);
 s64_t hwtimer_get_pending_silent_ticks(void);
+s64_t hwtimer_get_real_time_until(u64_t time);
+u64_t hwtimer_get_simu_time_from_host(void);
 
 void hwtimer_reset_rtc(void);
 void hwtimer_set_rtc_offset(s64_t offset);
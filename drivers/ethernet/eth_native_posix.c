@@ -35,6 +35,8 @@
 
 #include "eth_native_posix_priv.h"
 #include "ethernet/eth_stats.h"
+#include "fd_model.h"
+#include "soc.h"
 
 #if defined(CONFIG_NET_L2_ETHERNET)
 #define _ETH_MTU 1500
@@ -42,6 +44,8 @@
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
 
+#define ETH_IRQ_PRIO 2
+
 #if defined(CONFIG_NET_VLAN)
 #define ETH_HDR_LEN sizeof(struct net_eth_vlan_hdr)
 #else
@@ -85,6 +89,7 @@ struct eth_context {
 	struct net_if *iface;
 	const char *if_name;
 	int dev_fd;
+	struct k_sem rx_ready;
 	bool init_done;
 	bool status;
 	bool promisc_mode;
@@ -203,24 +208,15 @@ static void update_gptp(struct net_if *iface, struct net_pkt *pkt,
 #define update_gptp(iface, pkt, send)
 #endif /* CONFIG_NET_GPTP */
 
-static int eth_send(struct net_if *iface, struct net_pkt *pkt)
+static int eth_send_iov(struct net_if *iface, struct net_pkt *pkt,
+			const struct net_iovec *iov, int iovcnt)
 {
 	struct eth_context *ctx = get_context(iface);
-	struct net_buf *frag;
 	int count = 0;
-	int ret;
-
-	/* First fragment contains link layer (Ethernet) headers.
-	 */
-	count = net_pkt_ll_reserve(pkt) + pkt->frags->len;
-	memcpy(ctx->send, net_pkt_ll(pkt), count);
+	int ret, i;
 
-	/* Then the remaining data */
-	frag = pkt->frags->frags;
-	while (frag) {
-		memcpy(ctx->send + count, frag->data, frag->len);
-		count += frag->len;
-		frag = frag->frags;
+	for (i = 0; i < iovcnt; i++) {
+		count += iov[i].len;
 	}
 
 	eth_stats_update_bytes_tx(iface, count);
@@ -241,7 +237,7 @@ static int eth_send(struct net_if *iface, struct net_pkt *pkt)
 
 	SYS_LOG_DBG("Send pkt %p len %d", pkt, count);
 
-	ret = eth_write_data(ctx->dev_fd, ctx->send, count);
+	ret = eth_writev_data(ctx->dev_fd, iov, iovcnt);
 	if (ret < 0) {
 		SYS_LOG_DBG("Cannot send pkt %p (%d)", pkt, ret);
 	} else {
@@ -251,6 +247,33 @@ static int eth_send(struct net_if *iface, struct net_pkt *pkt)
 	return ret < 0 ? ret : 0;
 }
 
+/* Frames with too many fragments for eth_send_iov() are copied first */
+static int eth_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct eth_context *ctx = get_context(iface);
+	struct net_iovec iov;
+	struct net_buf *frag;
+	int count = 0;
+
+	/* First fragment contains link layer (Ethernet) headers.
+	 */
+	count = net_pkt_ll_reserve(pkt) + pkt->frags->len;
+	memcpy(ctx->send, net_pkt_ll(pkt), count);
+
+	/* Then the remaining data */
+	frag = pkt->frags->frags;
+	while (frag) {
+		memcpy(ctx->send + count, frag->data, frag->len);
+		count += frag->len;
+		frag = frag->frags;
+	}
+
+	iov.base = ctx->send;
+	iov.len = count;
+
+	return eth_send_iov(iface, pkt, &iov, 1);
+}
+
 static int eth_init(struct device *dev)
 {
 	ARG_UNUSED(dev);
@@ -296,6 +319,11 @@ static int read_data(struct eth_context *ctx, int fd)
 
 	ret = eth_read_data(fd, ctx->recv, sizeof(ctx->recv));
 	if (ret <= 0) {
+		return -EAGAIN;
+	}
+
+	/* Drop what arrives while the interface is down */
+	if (!net_if_is_up(ctx->iface)) {
 		return 0;
 	}
 
@@ -370,6 +398,13 @@ static int read_data(struct eth_context *ctx, int fd)
 	return 0;
 }
 
+static void eth_isr(void *arg)
+{
+	struct eth_context *ctx = arg;
+
+	k_sem_give(&ctx->rx_ready);
+}
+
 static void eth_rx(struct eth_context *ctx)
 {
 	int ret;
@@ -377,19 +412,27 @@ static void eth_rx(struct eth_context *ctx)
 	SYS_LOG_DBG("Starting ZETH RX thread");
 
 	while (1) {
-		if (net_if_is_up(ctx->iface)) {
-			ret = eth_wait_data(ctx->dev_fd);
-			if (!ret) {
-				read_data(ctx, ctx->dev_fd);
-			}
-		}
-
-		k_sleep(K_MSEC(50));
+		/* The TAP device raises its interrupt once readable. The
+		 * watch is one shot, so everything pending is read before
+		 * arming it again.
+		 */
+		hwfd_watch(ctx->dev_fd, ETH_NATIVE_POSIX_IRQ);
+		k_sem_take(&ctx->rx_ready, K_FOREVER);
+
+		do {
+			ret = read_data(ctx, ctx->dev_fd);
+		} while (ret != -EAGAIN);
 	}
 }
 
 static void create_rx_handler(struct eth_context *ctx)
 {
+	k_sem_init(&ctx->rx_ready, 0, 1);
+
+	IRQ_CONNECT(ETH_NATIVE_POSIX_IRQ, ETH_IRQ_PRIO, eth_isr,
+		    &eth_context_data, 0);
+	irq_enable(ETH_NATIVE_POSIX_IRQ);
+
 	k_thread_create(&rx_thread_data, eth_rx_stack,
 			K_THREAD_STACK_SIZEOF(eth_rx_stack),
 			(k_thread_entry_t)eth_rx,
@@ -565,6 +608,7 @@ static int eth_stop_device(struct device *dev)
 static const struct ethernet_api eth_if_api = {
 	.iface_api.init = eth_iface_init,
 	.iface_api.send = eth_send,
+	.iface_api.send_iov = eth_send_iov,
 
 	.get_capabilities = eth_posix_native_get_capabilities,
 	.set_config = set_config,
@@ -16,6 +16,7 @@
 /* Host include files */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdarg.h>
 #include <errno.h>
 #include <string.h>
@@ -24,6 +25,7 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <net/if.h>
 #include <time.h>
 #include "posix_trace.h"
@@ -56,7 +58,10 @@ int eth_iface_create(const char *if_name, bool tun_only)
 	struct ifreq ifr;
 	int fd, ret = -EINVAL;
 
-	fd = open(CONFIG_ETH_NATIVE_POSIX_DEV_NAME, O_RDWR);
+	/* The driver reads until there is nothing left, and is told by the
+	 * fd model when there is more
+	 */
+	fd = open(CONFIG_ETH_NATIVE_POSIX_DEV_NAME, O_RDWR | O_NONBLOCK);
 	if (fd < 0) {
 		return -errno;
 	}
@@ -131,39 +136,29 @@ int eth_start_script(const char *if_name)
 	}
 }
 
-int eth_wait_data(int fd)
-{
-	struct timeval timeout;
-	fd_set rset;
-	int ret;
-
-	FD_ZERO(&rset);
-
-	FD_SET(fd, &rset);
-
-	timeout.tv_sec = 0;
-	timeout.tv_usec = 0;
-
-	ret = select(fd + 1, &rset, NULL, NULL, &timeout);
-	if (ret < 0 && errno != EINTR) {
-		return -errno;
-	} else if (ret > 0) {
-		if (FD_ISSET(fd, &rset)) {
-			return 0;
-		}
-	}
-
-	return -EAGAIN;
-}
-
 ssize_t eth_read_data(int fd, void *buf, size_t buf_len)
 {
 	return read(fd, buf, buf_len);
 }
 
-ssize_t eth_write_data(int fd, void *buf, size_t buf_len)
+/* Same as in net/net_if.h, which cannot be included here. The host writes
+ * it as its own struct iovec.
+ */
+struct net_iovec {
+	void *base;
+	size_t len;
+};
+
+_Static_assert(sizeof(struct net_iovec) == sizeof(struct iovec) &&
+	       offsetof(struct net_iovec, base) ==
+	       offsetof(struct iovec, iov_base) &&
+	       offsetof(struct net_iovec, len) ==
+	       offsetof(struct iovec, iov_len),
+	       "struct net_iovec does not match struct iovec");
+
+ssize_t eth_writev_data(int fd, const struct net_iovec *iov, int iovcnt)
 {
-	return write(fd, buf, buf_len);
+	return writev(fd, (const struct iovec *)iov, iovcnt);
 }
 
 #if defined(CONFIG_NET_GPTP)
@@ -11,13 +11,14 @@
 #ifndef _ETH_NATIVE_POSIX_PRIV_H
 #define _ETH_NATIVE_POSIX_PRIV_H
 
+struct net_iovec;
+
 int eth_iface_create(const char *if_name, bool tun_only);
 int eth_iface_remove(int fd);
 int eth_setup_host(const char *if_name);
 int eth_start_script(const char *if_name);
-int eth_wait_data(int fd);
 ssize_t eth_read_data(int fd, void *buf, size_t buf_len);
-ssize_t eth_write_data(int fd, void *buf, size_t buf_len);
+ssize_t eth_writev_data(int fd, const struct net_iovec *iov, int iovcnt);
 int eth_if_up(const char *if_name);
 int eth_if_down(const char *if_name);
 
@@ -32,6 +32,39 @@ static void loopback_init(struct net_if *iface)
 	/* RFC 7042, s.2.1.1. address to use in documentation */
 	net_if_set_link_addr(iface, "\x00\x00\x5e\x00\x53\xff", 6,
 			     NET_LINK_DUMMY);
+
+	/* Sent fragments are received as they are, see loopback_rx_pkt() */
+	atomic_set_bit(iface->if_dev->flags, NET_IF_TX_SG);
+}
+
+/* The fragments of a packet held by nobody else are moved to the received
+ * packet. Otherwise, as for TCP segments kept for retransmission, the data
+ * is copied.
+ */
+static struct net_pkt *loopback_rx_pkt(struct net_pkt *pkt)
+{
+	struct net_pkt *rx;
+	struct net_buf *frag;
+
+	if (pkt->ref > 1) {
+		return net_pkt_clone(pkt, K_MSEC(100));
+	}
+
+	for (frag = pkt->frags; frag; frag = frag->frags) {
+		if (frag->ref > 1) {
+			return net_pkt_clone(pkt, K_MSEC(100));
+		}
+	}
+
+	rx = net_pkt_get_reserve_rx(0, K_MSEC(100));
+	if (!rx) {
+		return NULL;
+	}
+
+	net_pkt_frag_add(rx, pkt->frags);
+	pkt->frags = NULL;
+
+	return rx;
 }
 
 static int loopback_send(struct net_if *iface, struct net_pkt *pkt)
@@ -69,7 +102,7 @@ static int loopback_send(struct net_if *iface, struct net_pkt *pkt)
 	 * must be dropped. This is very much needed for TCP packets where
 	 * the packet is reference counted in various stages of sending.
 	 */
-	cloned = net_pkt_clone(pkt, K_MSEC(100));
+	cloned = loopback_rx_pkt(pkt);
 	if (!cloned) {
 		res = -ENOMEM;
 		goto out;
@@ -78,6 +111,7 @@ static int loopback_send(struct net_if *iface, struct net_pkt *pkt)
 	res = net_recv_data(iface, cloned);
 	if (res < 0) {
 		SYS_LOG_ERR("Data receive failed.");
+		net_pkt_unref(cloned);
 		goto out;
 	}
 
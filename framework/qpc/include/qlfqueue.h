@@ -0,0 +1,72 @@
+/**
+* @file
+* @brief QP lock-free event queue for active objects
+* @ingroup qf
+* @cond
+******************************************************************************
+* Copyright (c) 2018 hackin zhao
+*
+* SPDX-License-Identifier: Apache-2.0
+******************************************************************************
+* @endcond
+*/
+#ifndef qlfqueue_h
+#define qlfqueue_h
+
+/**
+* @description
+* This header file must be included in the QF ports that use the lock-free
+* event queue (#QF_EQUEUE_TYPE defined as ::QLFQueue) for active objects,
+* after qequeue.h. The lock-free queue replaces only the queues of the
+* active objects: the "raw" queues used by QActive_defer()/QActive_recall()
+* are still ::QEQueue.
+*/
+
+#include <atomic.h>
+
+/****************************************************************************/
+/*! Lock-free multiple-producer, single-consumer event queue */
+/**
+* @description
+* The queue is a ring buffer of event pointers, an empty entry holding
+* a NULL pointer. Producers reserve an entry and claim its index with
+* a single compare-and-swap on the @c state word, which packs the index of
+* the next entry to fill (upper 16 bits) with the number of free entries
+* (lower 16 bits), so the queue length is limited to 0xFFFF. The consumer
+* owns the @c tail index and frees the entries it takes with an atomic
+* increment. No critical section is needed, except to increment the
+* reference counter of dynamic events.
+*
+* Unlike ::QEQueue, there is no separate front event: a queue of length
+* @c qLen holds at most @c qLen events.
+*
+* A queue of length 0 only counts the events posted, which the ::QTicker
+* active object uses.
+*/
+typedef struct QLFQueue {
+    /*! pointer to the start of the ring buffer */
+    QEvt const **ring;
+
+    /*! length of the ring buffer */
+    QEQueueCtr end;
+
+    /*! offset of where the next event will be extracted from the buffer,
+    * used only by the consumer (tick rate of ::QTicker)
+    */
+    QEQueueCtr tail;
+
+    /*! offset of the next entry to fill and number of free entries */
+    atomic_t state;
+
+    /*! minimum number of free entries ever in the ring buffer */
+    atomic_t nMin;
+
+    /*! set while the consumer is about to block on the empty queue */
+    atomic_t waiting;
+} QLFQueue;
+
+/*! Initializes the lock-free event queue. */
+void QLFQueue_init(QLFQueue * const me, QEvt const *qSto[],
+                   uint_fast16_t const qLen);
+
+#endif /* qlfqueue_h */
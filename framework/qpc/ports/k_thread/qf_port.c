@@ -0,0 +1,208 @@
+/**
+* @file
+* @brief QF/C port to Zephyr kernel threads (k_thread)
+* @ingroup ports
+* @cond
+******************************************************************************
+* Copyright (c) 2018 hackin zhao
+*
+* SPDX-License-Identifier: Apache-2.0
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL /* this is QP implementation */
+#include "qf_port.h" /* QF port */
+#include "qassert.h"
+#include "qf_pkg.h"
+#ifdef Q_SPY /* QS software tracing enabled? */
+#include "qs_port.h" /* include QS port */
+#else
+#include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+Q_DEFINE_THIS_MODULE("qf_port")
+
+/* Local objects -----------------------------------------------------------*/
+static struct k_timer l_tickTimer;
+static struct k_sem l_stopSem;
+static s32_t l_tickPeriod; /* in milliseconds */
+static bool l_isRunning;
+static bool l_isTickIdle;
+
+/*..........................................................................*/
+static bool noTimeEvtsActive(void)
+{
+    uint_fast8_t tickRate;
+
+    for (tickRate = 0U; tickRate < (uint_fast8_t)QF_MAX_TICK_RATE;
+         ++tickRate)
+    {
+        if (!QF_noTimeEvtsActiveX(tickRate)) {
+            return false;
+        }
+    }
+    return true;
+}
+/*..........................................................................*/
+static void tick_expiry(struct k_timer *timer)
+{
+    QF_CRIT_STAT_
+
+    QF_onClockTick(); /* clock tick callback (must call QF_TICK_X()) */
+
+    /* no time events armed at any tick rate? see NOTE03 */
+    QF_CRIT_ENTRY_();
+    if (noTimeEvtsActive()) {
+        l_isTickIdle = true;
+        k_timer_stop(timer);
+    }
+    QF_CRIT_EXIT_();
+}
+/*..........................................................................*/
+void QF_tickResume_(void)
+{
+    /* called from QF_TIMEEVT_ARMED_() inside a critical section */
+    if (l_isTickIdle && l_isRunning) {
+        l_isTickIdle = false;
+        k_timer_start(&l_tickTimer, l_tickPeriod, l_tickPeriod);
+    }
+}
+/*..........................................................................*/
+void QF_init(void)
+{
+    extern uint_fast8_t QF_maxPool_;
+    extern QTimeEvt QF_timeEvtHead_[QF_MAX_TICK_RATE];
+
+    /* clear the internal QF variables, so that the framework can (re)start
+    * correctly even if the startup code is not called to clear the
+    * uninitialized data (as is required by the C Standard).
+    */
+    QF_maxPool_ = (uint_fast8_t)0;
+    QF_bzero(&QF_timeEvtHead_[0], (uint_fast16_t)sizeof(QF_timeEvtHead_));
+    QF_bzero(&QF_active_[0], (uint_fast16_t)sizeof(QF_active_));
+
+    k_timer_init(&l_tickTimer, &tick_expiry, NULL);
+    k_sem_init(&l_stopSem, 0, 1);
+
+    l_tickPeriod = K_MSEC(10); /* default clock tick */
+    l_isRunning = false;
+    l_isTickIdle = false;
+}
+/*..........................................................................*/
+int_t QF_run(void)
+{
+    uint_fast8_t p;
+
+    QF_onStartup(); /* invoke startup callback */
+
+    /* start the threads of the active objects started before QF_run(),
+    * which have been created suspended, see NOTE01
+    */
+    l_isRunning = true;
+    for (p = (uint_fast8_t)1; p <= (uint_fast8_t)QF_MAX_ACTIVE; ++p) {
+        if (QF_active_[p] != (QActive *)0) {
+            k_thread_start(&QF_active_[p]->thread);
+        }
+    }
+
+    /* the clock tick is delivered from the system timer, see NOTE02 */
+    k_timer_start(&l_tickTimer, l_tickPeriod, l_tickPeriod);
+
+    k_sem_take(&l_stopSem, K_FOREVER); /* wait for QF_stop() */
+
+    k_timer_stop(&l_tickTimer);
+    QF_onCleanup(); /* invoke cleanup callback */
+
+    return (int_t)0; /* return success */
+}
+/*..........................................................................*/
+void QF_setTickRate(uint32_t ticksPerSec)
+{
+    /* k_timer periods are expressed in milliseconds */
+    Q_REQUIRE_ID(100, (ticksPerSec > 0U) && (ticksPerSec <= 1000U));
+
+    l_tickPeriod = (s32_t)(1000U / ticksPerSec);
+
+    if (l_isRunning && !l_isTickIdle) {
+        k_timer_start(&l_tickTimer, l_tickPeriod, l_tickPeriod);
+    }
+}
+/*..........................................................................*/
+void QF_stop(void)
+{
+    l_isRunning = false;
+    k_sem_give(&l_stopSem); /* unblock QF_run() */
+}
+/*..........................................................................*/
+static void thread_entry(void *p1, void *p2, void *p3)
+{
+    QActive *act = (QActive *)p1;
+
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    /* loop until the active object is removed in QActive_stop() */
+    do {
+        QEvt const *e = QActive_get_(act); /* wait for the event */
+        QHSM_DISPATCH(&act->super, e); /* dispatch to the HSM */
+        QF_gc(e); /* check if the event is garbage, and collect it if so */
+    } while (QF_active_[act->prio] == act);
+}
+/*..........................................................................*/
+void QActive_start_(QActive * const me, uint_fast8_t prio,
+                    QEvt const *qSto[], uint_fast16_t qLen,
+                    void *stkSto, uint_fast16_t stkSize,
+                    QEvt const *ie)
+{
+    /* k_threads need a stack defined with K_THREAD_STACK_DEFINE() and a
+    * QF priority that maps onto a preemptible priority, see NOTE2 in
+    * qf_port.h
+    */
+    Q_REQUIRE_ID(600, (stkSto != (void *)0)
+                      && (stkSize > 0U)
+                      && (prio < (uint_fast8_t)CONFIG_NUM_PREEMPT_PRIORITIES));
+
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+    QLFQueue_init(&me->eQueue, qSto, qLen);
+#else
+    QEQueue_init(&me->eQueue, qSto, qLen);
+#endif
+    k_sem_init(&me->osObject, 0, 1);
+
+    me->prio = (uint8_t)prio;
+    QF_add_(me); /* make QF aware of this active object */
+
+    QHSM_INIT(&me->super, ie); /* take the top-most initial tran. */
+    QS_FLUSH(); /* flush the QS trace buffer to the host */
+
+    k_thread_create(&me->thread, (k_thread_stack_t *)stkSto,
+                    (size_t)stkSize, &thread_entry, me, NULL, NULL,
+                    QF_K_PRIO(prio), 0,
+                    l_isRunning ? K_NO_WAIT : K_FOREVER);
+}
+/*..........................................................................*/
+void QActive_stop(QActive * const me)
+{
+    QF_remove_(me); /* stop the thread loop of this active object */
+}
+
+/*****************************************************************************
+* NOTE01:
+* Active objects started before QF_run() must not process any event before
+* the application calls QF_run(), so their threads are created with a
+* K_FOREVER delay and started all at once here. Active objects started later
+* run right away.
+*
+* NOTE02:
+* The QF clock tick runs in the system timer expiry handler, in ISR context,
+* where posting and publishing events is allowed. Unlike a ticker thread
+* polling the clock, a periodic k_timer does not keep the CPU busy between
+* ticks and lets the kernel idle.
+*
+* NOTE03:
+* Ticking while no time event is armed, at any tick rate, would only wake
+* the CPU up for nothing. The tick timer is then stopped, and restarted by
+* QF_TIMEEVT_ARMED_() as soon as a time event gets armed, the first tick
+* occurring one period later. Note that QF_onClockTick() is not called
+* while idle, so any polling done there also stops.
+*/
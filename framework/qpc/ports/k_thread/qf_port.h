@@ -0,0 +1,130 @@
+/**
+* @file
+* @brief QF/C port to Zephyr kernel threads (k_thread)
+* @ingroup ports
+* @cond
+******************************************************************************
+* Copyright (c) 2018 hackin zhao
+*
+* SPDX-License-Identifier: Apache-2.0
+******************************************************************************
+* @endcond
+*/
+#ifndef qf_port_h
+#define qf_port_h
+
+/* Zephyr event queue and thread types, see NOTE1 */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+#define QF_EQUEUE_TYPE       QLFQueue
+#else
+#define QF_EQUEUE_TYPE       QEQueue
+#endif
+#define QF_OS_OBJECT_TYPE    struct k_sem
+#define QF_THREAD_TYPE       struct k_thread
+
+/* The maximum number of active objects in the application, see NOTE2 */
+#define QF_MAX_ACTIVE        32
+
+/* The number of system clock tick rates */
+#define QF_MAX_TICK_RATE     2
+
+/* various QF object sizes configuration for this port */
+#define QF_EVENT_SIZ_SIZE    4
+#define QF_EQUEUE_CTR_SIZE   4
+#define QF_MPOOL_SIZ_SIZE    4
+#define QF_MPOOL_CTR_SIZE    4
+#define QF_TIMEEVT_CTR_SIZE  4
+
+/* QF critical section for Zephyr, see NOTE3 */
+#define QF_CRIT_STAT_TYPE    unsigned int
+#define QF_CRIT_ENTRY(stat_) ((stat_) = irq_lock())
+#define QF_CRIT_EXIT(stat_)  irq_unlock(stat_)
+
+#include <kernel.h>    /* Zephyr kernel API */
+#include "qep_port.h"  /* QEP port */
+#include "qequeue.h"   /* Zephyr port needs event-queue */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+#include "qlfqueue.h"  /* lock-free event-queue */
+#endif
+#include "qmpool.h"    /* Zephyr port needs memory-pool */
+#include "qf.h"        /* QF platform-independent public interface */
+
+void QF_setTickRate(uint32_t ticksPerSec); /* set clock tick rate */
+void QF_onClockTick(void); /* clock tick callback (provided in the app) */
+
+/* Zephyr preemptible priority of the thread of the QF priority prio_ */
+#define QF_K_PRIO(prio_) \
+    K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1 - (int)(prio_))
+
+/****************************************************************************/
+/* interface used only inside QF implementation, but not in applications */
+#ifdef QP_IMPL
+
+    /* QF-specific scheduler locking (not used at this point) */
+    #define QF_SCHED_STAT_
+    #define QF_SCHED_LOCK_(dummy) ((void)0)
+    #define QF_SCHED_UNLOCK_()    ((void)0)
+
+    /* Zephyr active object event queue customization, see NOTE1 */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+    #define QACTIVE_EQUEUE_WAIT_(me_) \
+        k_sem_take(&(me_)->osObject, K_FOREVER)
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) \
+        k_sem_give(&(me_)->osObject)
+#else
+    #define QACTIVE_EQUEUE_WAIT_(me_) \
+        while ((me_)->eQueue.frontEvt == (QEvt *)0) { \
+            QF_CRIT_EXIT_(); \
+            k_sem_take(&(me_)->osObject, K_FOREVER); \
+            QF_CRIT_ENTRY_(); \
+        }
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) \
+        Q_ASSERT_ID(410, QF_active_[(me_)->prio] != (QActive *)0); \
+        k_sem_give(&(me_)->osObject)
+#endif
+
+    /* resume the clock tick stopped while idle, see NOTE03 in qf_port.c */
+    #define QF_TIMEEVT_ARMED_(dummy) QF_tickResume_()
+
+    void QF_tickResume_(void);
+
+    /* native QF event pool operations */
+    #define QF_EPOOL_TYPE_  QMPool
+    #define QF_EPOOL_INIT_(p_, poolSto_, poolSize_, evtSize_) \
+        QMPool_init(&(p_), poolSto_, poolSize_, evtSize_)
+    #define QF_EPOOL_EVENT_SIZE_(p_)  ((p_).blockSize)
+    #define QF_EPOOL_GET_(p_, e_, m_) ((e_) = (QEvt *)QMPool_get(&(p_), (m_)))
+    #define QF_EPOOL_PUT_(p_, e_)     (QMPool_put(&(p_), e_))
+
+#endif /* QP_IMPL */
+
+/*****************************************************************************
+*
+* NOTE1:
+* Each active object runs in its own k_thread and keeps the native QF event
+* queue, so that posting LIFO, the queue margins and the QF_getQueueMin()
+* statistics work as with any other QF port, and events are passed by
+* pointer without any copy. The osObject is a binary k_sem, which is given
+* only when an event is posted to an empty queue: the thread of an active
+* object that has events to process never goes through the kernel. A stale
+* give can at worst wake the thread once more, which then finds the queue
+* empty and waits again.
+*
+* With CONFIG_QPC_EQUEUE_LOCKFREE, the event queue is the lock-free
+* QLFQueue instead, and the k_sem is only given when the thread of the
+* active object is about to block, see qf_lfq.c.
+*
+* NOTE2:
+* QF priorities map to Zephyr preemptible thread priorities, the highest QF
+* priority being the most urgent one: the QF priority prio runs at
+* K_PRIO_PREEMPT(CONFIG_NUM_PREEMPT_PRIORITIES - 1 - prio). The priorities
+* used by the application must therefore stay below
+* CONFIG_NUM_PREEMPT_PRIORITIES, which QActive_start_() asserts.
+*
+* NOTE3:
+* The QF critical section locks interrupts, the only way to protect data
+* shared with the ISRs posting events. The interrupt lock state is saved in
+* a local variable, so that critical sections can nest.
+*/
+
+#endif /* qf_port_h */
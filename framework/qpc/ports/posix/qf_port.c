@@ -54,12 +54,38 @@ Q_DEFINE_THIS_MODULE("qf_port")
 
 /* Global objects ----------------------------------------------------------*/
 pthread_mutex_t QF_pThreadMutex_;
+pthread_cond_t QF_pThreadTickCond_;
 
 /* Local objects -----------------------------------------------------------*/
 static pthread_mutex_t l_startupMutex;
 static bool l_isRunning;
 static struct timespec l_tick;
-enum { NANOSLEEP_NSEC_PER_SEC = 1000000000 }; /* see NOTE05 */
+enum { NANOSLEEP_NSEC_PER_SEC = 1000000000 };
+
+/*..........................................................................*/
+static void timespec_add(struct timespec *ts, struct timespec const *inc)
+{
+    ts->tv_sec += inc->tv_sec;
+    ts->tv_nsec += inc->tv_nsec;
+    while (ts->tv_nsec >= NANOSLEEP_NSEC_PER_SEC) {
+        ts->tv_nsec -= NANOSLEEP_NSEC_PER_SEC;
+        ++ts->tv_sec;
+    }
+}
+/*..........................................................................*/
+static bool noTimeEvtsActive(void)
+{
+    uint_fast8_t tickRate;
+
+    for (tickRate = 0U; tickRate < (uint_fast8_t)QF_MAX_TICK_RATE;
+         ++tickRate)
+    {
+        if (!QF_noTimeEvtsActiveX(tickRate)) {
+            return false;
+        }
+    }
+    return true;
+}
 
 /*..........................................................................*/
 void QF_init(void)
@@ -73,6 +99,9 @@ void QF_init(void)
     /* init the global mutex with the default non-recursive initializer */
     pthread_mutex_init(&QF_pThreadMutex_, NULL);
 
+    /* init the condition the idle ticker thread waits on, see NOTE06 */
+    pthread_cond_init(&QF_pThreadTickCond_, NULL);
+
     /* init the startup mutex with the default non-recursive initializer */
     pthread_mutex_init(&l_startupMutex, NULL);
 
@@ -96,6 +125,7 @@ void QF_init(void)
 int_t QF_run(void)
 {
     struct sched_param sparam;
+    struct timespec deadline;
 
     QF_onStartup(); /* invoke startup callback */
 
@@ -113,15 +143,34 @@ int_t QF_run(void)
     pthread_mutex_unlock(&l_startupMutex);
 
     l_isRunning = true;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
     while (l_isRunning) { /* the clock tick loop... */
-        uint16_t i = 0xffff;
-        QF_onClockTick(); /* clock tick callback (must call QF_TICK_X()) */
 
-        //nanosleep(&l_tick, NULL); /* sleep for the number of ticks, NOTE05 */
-        while (i--)
-            ;
+        /* no time events armed at any tick rate? see NOTE06 */
+        pthread_mutex_lock(&QF_pThreadMutex_);
+        if (noTimeEvtsActive()) {
+            do {
+                pthread_cond_wait(&QF_pThreadTickCond_, &QF_pThreadMutex_);
+            } while (l_isRunning && noTimeEvtsActive());
+            pthread_mutex_unlock(&QF_pThreadMutex_);
+
+            /* restart the tick phase from the time event arming */
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+        }
+        else {
+            pthread_mutex_unlock(&QF_pThreadMutex_);
+        }
+
+        /* sleep until the next tick deadline, see NOTE02 */
+        timespec_add(&deadline, &l_tick);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+
+        if (l_isRunning) {
+            QF_onClockTick(); /* clock tick callback (must call QF_TICK_X())*/
+        }
     }
     QF_onCleanup(); /* invoke cleanup callback */
+    pthread_cond_destroy(&QF_pThreadTickCond_);
     pthread_mutex_destroy(&l_startupMutex);
     pthread_mutex_destroy(&QF_pThreadMutex_);
 
@@ -130,12 +179,16 @@ int_t QF_run(void)
 /*..........................................................................*/
 void QF_setTickRate(uint32_t ticksPerSec)
 {
+    l_tick.tv_sec = 0;
     l_tick.tv_nsec = NANOSLEEP_NSEC_PER_SEC / ticksPerSec;
 }
 /*..........................................................................*/
 void QF_stop(void)
 {
+    pthread_mutex_lock(&QF_pThreadMutex_);
     l_isRunning = false; /* stop the loop in QF_run() */
+    pthread_cond_signal(&QF_pThreadTickCond_); /* wake up an idle ticker */
+    pthread_mutex_unlock(&QF_pThreadMutex_);
 }
 /*..........................................................................*/
 static void* thread_routine(void* arg)
@@ -153,7 +206,11 @@ static void* thread_routine(void* arg)
         QF_gc(e); /* check if the event is garbage, and collect it if so */
     } while (act->thread != (uint8_t)0);
     QF_remove_(act); /* remove this object from the framework */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+    sem_destroy(&act->osObject); /* cleanup the semaphore */
+#else
     pthread_cond_destroy(&act->osObject); /* cleanup the condition variable */
+#endif
     return (void*)0; /* return success */
 }
 /*..........................................................................*/
@@ -169,8 +226,13 @@ void QActive_start_(QActive* const me, uint_fast8_t prio,
     /* p-threads allocate stack internally */
     Q_REQUIRE_ID(600, stkSto == (void*)0);
 
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+    QLFQueue_init(&me->eQueue, qSto, qLen);
+    sem_init(&me->osObject, 0, 0U);
+#else
     QEQueue_init(&me->eQueue, qSto, qLen);
     pthread_cond_init(&me->osObject, 0);
+#endif
 
     me->prio = (uint8_t)prio;
     QF_add_(me); /* make QF aware of this active object */
@@ -228,17 +290,16 @@ void QActive_stop(QActive* const me)
 * insufficient privileges.
 *
 * NOTE02:
-* On some Linux systems nanosleep() might actually not deliver the finest
-* time granularity. For example, on some Linux implementations, nanosleep()
-* could not block for shorter intervals than 20ms, while the underlying
-* clock tick period was only 10ms. Sometimes, the select() system call can
-* provide a finer granularity.
+* The ticker thread sleeps until absolute deadlines, each one period after
+* the previous one, with clock_nanosleep(TIMER_ABSTIME). The tick rate set
+* by QF_setTickRate() thus neither depends on the CPU speed nor drifts with
+* the time spent in QF_onClockTick(), and the CPU is free to idle between
+* the ticks. The deadlines have the millisecond resolution of the POSIX
+* clock and are served with the granularity of the kernel system clock.
 *
 * NOTE03:
-* Any blocking system call, such as nanosleep() or select() system call can
-* be interrupted by a signal, such as ^C from the keyboard. In this case this
-* QF port breaks out of the event-loop and returns to main() that exits and
-* terminates all spawned p-threads.
+* QF_stop() only stops the clock tick loop at the next tick, or right away
+* when the ticker thread is idle.
 *
 * NOTE04:
 * According to the man pages (for pthread_attr_setschedpolicy) the only value
@@ -255,8 +316,11 @@ void QActive_stop(QActive* const me)
 * three highest Linux priorities for the ISR-like threads (e.g., the ticker,
 * I/O), and the rest highest-priorities for the active objects.
 *
-* NOTE05:
-* In some (older) Linux kernels, the POSIX nanosleep() system call might
-* deliver only 2*actual-system-tick granularity. To compensate for this,
-* you would need to reduce (by 2) the constant NANOSLEEP_NSEC_PER_SEC.
+* NOTE06:
+* Ticking while no time event is armed, at any tick rate, would only wake the
+* ticker thread for nothing. The ticker thread then waits on the
+* QF_pThreadTickCond_ condition instead, which QF_TIMEEVT_ARMED_() signals
+* as soon as a time event gets armed, and the tick restarts one period after
+* that. Note that QF_onClockTick() is not called while idle, so any polling
+* done there also stops.
 */
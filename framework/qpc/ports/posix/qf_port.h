@@ -40,8 +40,13 @@
 #define qf_port_h
 
 /* POSIX event queue and thread types */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+#define QF_EQUEUE_TYPE       QLFQueue
+#define QF_OS_OBJECT_TYPE    sem_t
+#else
 #define QF_EQUEUE_TYPE       QEQueue
 #define QF_OS_OBJECT_TYPE    pthread_cond_t
+#endif
 #define QF_THREAD_TYPE       uint8_t
 
 /* The maximum number of active objects in the application */
@@ -67,8 +72,14 @@
 #define QF_CRIT_EXIT(dummy)  QF_INT_ENABLE()
 
 #include <pthread.h>   /* POSIX-thread API */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+#include <semaphore.h> /* POSIX semaphores */
+#endif
 #include "qep_port.h"  /* QEP port */
 #include "qequeue.h"   /* POSIX needs event-queue */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+#include "qlfqueue.h"  /* lock-free event-queue, see NOTE2 */
+#endif
 #include "qmpool.h"    /* POSIX needs memory-pool */
 #include "qf.h"        /* QF platform-independent public interface */
 
@@ -76,6 +87,7 @@ void QF_setTickRate(uint32_t ticksPerSec); /* set clock tick rate */
 void QF_onClockTick(void); /* clock tick callback (provided in the app) */
 
 extern pthread_mutex_t QF_pThreadMutex_; /* mutex for QF critical section */
+extern pthread_cond_t QF_pThreadTickCond_; /* idle ticker thread condition */
 
 /****************************************************************************/
 /* interface used only inside QF implementation, but not in applications */
@@ -87,12 +99,25 @@ extern pthread_mutex_t QF_pThreadMutex_; /* mutex for QF critical section */
     #define QF_SCHED_UNLOCK_()    ((void)0)
 
     /* POSIX active object event queue customization... */
+#ifdef CONFIG_QPC_EQUEUE_LOCKFREE
+    #define QACTIVE_EQUEUE_WAIT_(me_) \
+        sem_wait(&(me_)->osObject)
+    #define QACTIVE_EQUEUE_SIGNAL_(me_) \
+        sem_post(&(me_)->osObject)
+#else
     #define QACTIVE_EQUEUE_WAIT_(me_) \
         while ((me_)->eQueue.frontEvt == (QEvt *)0) \
             pthread_cond_wait(&(me_)->osObject, &QF_pThreadMutex_)
     #define QACTIVE_EQUEUE_SIGNAL_(me_) \
         Q_ASSERT_ID(410, QF_active_[(me_)->prio] != (QActive *)0); \
         pthread_cond_signal(&(me_)->osObject)
+#endif
+
+    /* resume the clock tick of an idle ticker thread, see NOTE06 in
+    * qf_port.c
+    */
+    #define QF_TIMEEVT_ARMED_(dummy) \
+        pthread_cond_signal(&QF_pThreadTickCond_)
 
     /* native QF event pool operations */
     #define QF_EPOOL_TYPE_  QMPool
@@ -132,6 +157,13 @@ extern pthread_mutex_t QF_pThreadMutex_; /* mutex for QF critical section */
 * also subject to priority inversions. However, the p-thread mutex
 * implementation, such as POSIX threads, should support the priority-
 * inheritance protocol.
+*
+* NOTE2:
+* With CONFIG_QPC_EQUEUE_LOCKFREE, the event queues of the active objects
+* are the lock-free QLFQueue, so that posting an event does not lock
+* QF_pThreadMutex_ (except to count the references to a dynamic event), and
+* each active object blocks on its own POSIX semaphore instead of waiting
+* on a condition variable with the shared mutex.
 */
 
 #endif /* qf_port_h */
@@ -0,0 +1,462 @@
+/**
+* @file
+* @brief ::QActive services and ::QTicker on top of the lock-free ::QLFQueue
+* @ingroup qf
+* @cond
+******************************************************************************
+* Copyright (c) 2018 hackin zhao
+*
+* SPDX-License-Identifier: Apache-2.0
+******************************************************************************
+* @endcond
+*/
+#define QP_IMPL           /* this is QP implementation */
+#include "qf_port.h"      /* QF port */
+#include "qf_pkg.h"       /* QF package-scope interface */
+#include "qassert.h"      /* QP embedded systems-friendly assertions */
+#ifdef Q_SPY              /* QS software tracing enabled? */
+    #include "qs_port.h"  /* include QS port */
+#else
+    #include "qs_dummy.h" /* disable the QS software tracing */
+#endif /* Q_SPY */
+
+Q_DEFINE_THIS_MODULE("qf_lfq")
+
+/* packing of the QLFQueue state word, see qlfqueue.h */
+#define LFQ_HEAD_(state_)   ((QEQueueCtr)((uint32_t)(state_) >> 16))
+#define LFQ_NFREE_(state_)  ((QEQueueCtr)((uint32_t)(state_) & 0xFFFFU))
+#define LFQ_STATE_(head_, nFree_) \
+    ((atomic_val_t)(((uint32_t)(head_) << 16) | (uint32_t)(nFree_)))
+
+/* load and store the ring buffer entries shared with the producers */
+#define LFQ_LOAD_(q_, i_) \
+    __atomic_load_n(&QF_PTR_AT_((q_)->ring, (i_)), __ATOMIC_SEQ_CST)
+#define LFQ_STORE_(q_, i_, e_) \
+    __atomic_store_n(&QF_PTR_AT_((q_)->ring, (i_)), (e_), __ATOMIC_SEQ_CST)
+
+/*! the event returned by QActive_get_() to a ::QTicker */
+static QEvt const l_tickEvt = { (QSignal)0, (uint8_t)0, (uint8_t)0 };
+
+/****************************************************************************/
+/**
+* @description
+* Initializes the lock-free event queue of an active object with the ring
+* buffer @p qSto of @p qLen entries, which all become free. A queue of
+* length 0 only counts the events posted to it, see ::QTicker.
+*
+* @param[in,out] me   pointer (see @ref oop)
+* @param[in]     qSto pointer to the ring buffer storage
+* @param[in]     qLen length of the ring buffer storage (in events)
+*/
+void QLFQueue_init(QLFQueue * const me, QEvt const *qSto[],
+                   uint_fast16_t const qLen)
+{
+    uint_fast16_t i;
+
+    /** @pre the length must fit the lower half of the state word */
+    Q_REQUIRE_ID(100, qLen <= (uint_fast16_t)0xFFFFU);
+
+    me->ring = &qSto[0];
+    me->end  = (QEQueueCtr)qLen;
+    if (qLen != (uint_fast16_t)0) {
+        me->tail = (QEQueueCtr)0;
+        for (i = (uint_fast16_t)0; i < qLen; ++i) {
+            qSto[i] = (QEvt const *)0; /* free entry */
+        }
+    }
+    atomic_set(&me->state, LFQ_STATE_(0U, qLen));
+    atomic_set(&me->nMin, (atomic_val_t)qLen);
+    atomic_clear(&me->waiting);
+}
+
+/*..........................................................................*/
+/* record a new low-watermark of free entries */
+static void QLFQueue_updateMin_(QLFQueue * const me, QEQueueCtr const nFree) {
+    atomic_val_t nMin;
+
+    do {
+        nMin = atomic_get(&me->nMin);
+        if ((QEQueueCtr)nMin <= nFree) {
+            break;
+        }
+    } while (!atomic_cas(&me->nMin, nMin, (atomic_val_t)nFree));
+}
+
+/*..........................................................................*/
+/* wake up the consumer if it is about to block, see NOTE1 */
+static void QActive_wakeUp_(QActive * const me) {
+    if (atomic_cas(&me->eQueue.waiting, 1, 0)) {
+        QACTIVE_EQUEUE_SIGNAL_(me);
+    }
+}
+
+/****************************************************************************/
+/**
+* @description
+* Direct event posting is the simplest asynchronous communication method
+* available in QF. The lock-free version reserves a free entry and claims
+* its index with a single compare-and-swap, so that concurrent producers
+* only retry on contention and never serialize on the QF critical section.
+*
+* @param[in,out] me     pointer (see @ref oop)
+* @param[in]     e      pointer to the event to be posted
+* @param[in]     margin number of required free slots in the queue after
+*                       posting the event.
+*
+* @returns
+* 'true' (success) if the posting succeeded (with the provided margin) and
+* 'false' (failure) when the posting fails.
+*
+* @attention
+* This function should be called only via the macro QACTIVE_POST()
+* or QACTIVE_POST_X().
+*
+* @sa QActive_post_() in qf_actq.c
+*/
+#ifndef Q_SPY
+bool QActive_post_(QActive * const me, QEvt const * const e,
+                   uint_fast16_t const margin)
+#else
+bool QActive_post_(QActive * const me, QEvt const * const e,
+                   uint_fast16_t const margin, void const * const sender)
+#endif
+{
+    QLFQueue * const q = &me->eQueue;
+    QEQueueCtr minFree = (margin == QF_NO_MARGIN)
+                         ? (QEQueueCtr)0 : (QEQueueCtr)margin;
+    QEQueueCtr nFree;
+    QEQueueCtr head;
+    QEQueueCtr next;
+    atomic_val_t state;
+    QS_CRIT_STAT_
+    QS_TEST_PROBE_DEF(&QActive_post_)
+
+    /** @pre event pointer must be valid */
+    Q_REQUIRE_ID(200, e != (QEvt const *)0);
+
+    /* reserve a free entry and claim its index at once */
+    do {
+        state = atomic_get(&q->state);
+        nFree = LFQ_NFREE_(state);
+
+        /* test-probe#1 for faking queue overflow */
+        QS_TEST_PROBE_ID(1,
+            nFree = (QEQueueCtr)0;
+        )
+
+        if (nFree <= minFree) { /* cannot post? */
+            if (margin == QF_NO_MARGIN) {
+                Q_ERROR_ID(210); /* must be able to post the event */
+            }
+
+            QS_BEGIN_(QS_QF_ACTIVE_POST_ATTEMPT,
+                      QS_priv_.locFilter[AO_OBJ], me)
+                QS_TIME_();           /* timestamp */
+                QS_OBJ_(sender);      /* the sender object */
+                QS_SIG_(e->sig);      /* the signal of the event */
+                QS_OBJ_(me);          /* this active object (recipient) */
+                QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+                QS_EQC_(nFree);       /* number of free entries */
+                QS_EQC_(margin);      /* margin requested */
+            QS_END_()
+
+            QF_gc(e); /* recycle the event to avoid a leak */
+            return false;
+        }
+
+        head = LFQ_HEAD_(state);
+        next = head + (QEQueueCtr)1;
+        if (next == q->end) { /* need to wrap head? */
+            next = (QEQueueCtr)0;
+        }
+    } while (!atomic_cas(&q->state, state, LFQ_STATE_(next, nFree - 1U)));
+
+    QLFQueue_updateMin_(q, nFree - 1U);
+
+    /* is it a pool event? */
+    if (e->poolId_ != (uint8_t)0) {
+        QF_CRIT_STAT_
+        QF_CRIT_ENTRY_();
+        QF_EVT_REF_CTR_INC_(e); /* increment the reference counter */
+        QF_CRIT_EXIT_();
+    }
+
+    QS_BEGIN_(QS_QF_ACTIVE_POST_FIFO, QS_priv_.locFilter[AO_OBJ], me)
+        QS_TIME_();               /* timestamp */
+        QS_OBJ_(sender);          /* the sender object */
+        QS_SIG_(e->sig);          /* the signal of the event */
+        QS_OBJ_(me);              /* this active object (recipient) */
+        QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+        QS_EQC_(nFree);           /* number of free entries */
+        QS_EQC_((QEQueueCtr)atomic_get(&q->nMin)); /* min number of free */
+    QS_END_()
+
+    LFQ_STORE_(q, head, e); /* publish the event in the claimed entry */
+    QActive_wakeUp_(me);
+
+    return true;
+}
+
+/****************************************************************************/
+/**
+* @description
+* posts an event to the event queue of the active object @p me using the
+* Last-In-First-Out (LIFO) policy.
+*
+* @note
+* On the lock-free queue, the LIFO policy is restricted to self-posting:
+* only the thread of the active object @p me, as in QActive_recall(), can
+* insert an event in front of its own queue.
+*
+* @param[in] me pointer (see @ref oop)
+* @param[in  e  pointer to the event to post to the queue
+*
+* @attention
+* This function should be called only via the macro QACTIVE_POST_LIFO().
+*/
+void QActive_postLIFO_(QActive * const me, QEvt const * const e) {
+    QLFQueue * const q = &me->eQueue;
+    QEQueueCtr nFree;
+    atomic_val_t state;
+    QS_CRIT_STAT_
+    QS_TEST_PROBE_DEF(&QActive_postLIFO_)
+
+    /* reserve a free entry, the producers' index is left alone */
+    do {
+        state = atomic_get(&q->state);
+        nFree = LFQ_NFREE_(state);
+
+        /* test-probe#1 for faking queue overflow */
+        QS_TEST_PROBE_ID(1,
+            nFree = (QEQueueCtr)0;
+        )
+
+        /* the queue must be able to accept the event (cannot overflow) */
+        Q_ASSERT_ID(310, nFree != (QEQueueCtr)0);
+    } while (!atomic_cas(&q->state, state, state - 1));
+
+    QLFQueue_updateMin_(q, nFree - 1U);
+
+    /* is it a dynamic event? */
+    if (e->poolId_ != (uint8_t)0) {
+        QF_CRIT_STAT_
+        QF_CRIT_ENTRY_();
+        QF_EVT_REF_CTR_INC_(e); /* increment the reference counter */
+        QF_CRIT_EXIT_();
+    }
+
+    QS_BEGIN_(QS_QF_ACTIVE_POST_LIFO, QS_priv_.locFilter[AO_OBJ], me)
+        QS_TIME_();                  /* timestamp */
+        QS_SIG_(e->sig);             /* the signal of this event */
+        QS_OBJ_(me);                 /* this active object */
+        QS_2U8_(e->poolId_, e->refCtr_);/* pool Id & ref Count of the event */
+        QS_EQC_(nFree);              /* number of free entries */
+        QS_EQC_((QEQueueCtr)atomic_get(&q->nMin)); /* min number of free */
+    QS_END_()
+
+    /* the entry in front of the tail is free, see NOTE2 */
+    if (q->tail == (QEQueueCtr)0) { /* need to wrap the tail? */
+        q->tail = q->end;
+    }
+    --q->tail;
+    LFQ_STORE_(q, q->tail, e);
+}
+
+/****************************************************************************/
+/**
+* @description
+* Blocks the thread of the active object until an event is available, and
+* returns it.
+*
+* @param[in,out] me  pointer (see @ref oop)
+*
+* @returns
+* a pointer to the received event. The returned pointer is guaranteed to be
+* valid (can't be NULL).
+*/
+QEvt const *QActive_get_(QActive * const me) {
+    QLFQueue * const q = &me->eQueue;
+    QEvt const *e;
+    QS_CRIT_STAT_
+
+    /* a queue without ring buffer only counts the posted events */
+    if (q->end == (QEQueueCtr)0) {
+        while (atomic_get(&q->state) == 0) {
+            atomic_set(&q->waiting, 1);
+            if (atomic_get(&q->state) == 0) {
+                QACTIVE_EQUEUE_WAIT_(me);
+            }
+            else {
+                (void)atomic_cas(&q->waiting, 1, 0);
+            }
+        }
+        return &l_tickEvt;
+    }
+
+    /* wait for the event at the tail to be published, see NOTE1 */
+    for (;;) {
+        e = LFQ_LOAD_(q, q->tail);
+        if (e != (QEvt const *)0) {
+            break;
+        }
+
+        atomic_set(&q->waiting, 1);
+        e = LFQ_LOAD_(q, q->tail);
+        if (e != (QEvt const *)0) {
+            (void)atomic_cas(&q->waiting, 1, 0);
+            break;
+        }
+
+        QACTIVE_EQUEUE_WAIT_(me);
+    }
+
+    LFQ_STORE_(q, q->tail, (QEvt const *)0); /* free the entry */
+    ++q->tail;
+    if (q->tail == q->end) { /* need to wrap the tail? */
+        q->tail = (QEQueueCtr)0;
+    }
+    (void)atomic_inc(&q->state); /* one more free entry */
+
+    QS_BEGIN_(QS_QF_ACTIVE_GET, QS_priv_.locFilter[AO_OBJ], me)
+        QS_TIME_();                   /* timestamp */
+        QS_SIG_(e->sig);              /* the signal of this event */
+        QS_OBJ_(me);                  /* this active object */
+        QS_2U8_(e->poolId_, e->refCtr_); /* pool Id & ref Count */
+        QS_EQC_(LFQ_NFREE_(atomic_get(&q->state))); /* number of free */
+    QS_END_()
+
+    return e;
+}
+
+/****************************************************************************/
+/**
+* @description
+* Queries the minimum of free ever present in the given event queue of
+* an active object with priority @p prio, since the active object
+* was started.
+*
+* @param[in] prio  Priority of the active object, whose queue is queried
+*
+* @returns
+* the minimum of free ever present in the given event queue of an active
+* object with priority @p prio, since the active object was started.
+*/
+uint_fast16_t QF_getQueueMin(uint_fast8_t const prio) {
+    Q_REQUIRE_ID(400, (prio <= (uint_fast8_t)QF_MAX_ACTIVE)
+                      && (QF_active_[prio] != (QActive *)0));
+
+    return (uint_fast16_t)atomic_get(&QF_active_[prio]->eQueue.nMin);
+}
+
+/****************************************************************************/
+static void QTicker_init_(QHsm * const me, QEvt const * const e);
+static void QTicker_dispatch_(QHsm * const me, QEvt const * const e);
+
+#ifdef Q_SPY
+    /*! virtual function to asynchronously post (FIFO) an event to an AO */
+    static bool QTicker_post_(QActive * const me, QEvt const * const e,
+                   uint_fast16_t const margin, void const * const sender);
+#else
+    static bool QTicker_post_(QActive * const me, QEvt const * const e,
+                   uint_fast16_t const margin);
+#endif
+
+static void QTicker_postLIFO_(QActive * const me, QEvt const * const e);
+
+/*! Perform downcast to QTicker pointer. */
+#define QTICKER_CAST(me_)  ((QTicker *)(me_))
+
+/*..........................................................................*/
+/*! "constructor" of QTicker */
+void QTicker_ctor(QTicker * const me, uint8_t tickRate) {
+    static QActiveVtbl const vtbl = {  /* QActiveVtbl virtual table */
+        { &QTicker_init_,
+          &QTicker_dispatch_ },
+        &QActive_start_,
+        &QTicker_post_,
+        &QTicker_postLIFO_
+    };
+    QActive_ctor(me, Q_STATE_CAST(0)); /* superclass' ctor */
+    me->super.vptr = &vtbl.super; /* hook the vptr */
+
+    /* reuse eQueue.tail for tick-rate, the ticker queue has no ring */
+    me->eQueue.tail = (QEQueueCtr)tickRate;
+}
+/*..........................................................................*/
+static void QTicker_init_(QHsm * const me, QEvt const * const e) {
+    (void)e;
+
+    /** @pre the ticker must be started without a queue storage */
+    Q_REQUIRE_ID(500, QTICKER_CAST(me)->eQueue.end == (QEQueueCtr)0);
+}
+/*..........................................................................*/
+static void QTicker_dispatch_(QHsm * const me, QEvt const * const e) {
+    atomic_val_t n;
+
+    (void)e; /* unused parameter */
+
+    /* # ticks since last call */
+    n = atomic_set(&QTICKER_CAST(me)->eQueue.state, 0);
+
+    for (; n > 0; --n) {
+        QF_TICK_X((uint_fast8_t)QTICKER_CAST(me)->eQueue.tail, me);
+    }
+}
+/*..........................................................................*/
+#ifndef Q_SPY
+static bool QTicker_post_(QActive * const me, QEvt const * const e,
+                          uint_fast16_t const margin)
+#else
+static bool QTicker_post_(QActive * const me, QEvt const * const e,
+                          uint_fast16_t const margin,
+                          void const * const sender)
+#endif
+{
+    QS_CRIT_STAT_
+
+    (void)e; /* unused parameter */
+    (void)margin; /* unused parameter */
+
+    /* account for one more tick event */
+    if (atomic_inc(&me->eQueue.state) == 0) {
+        QActive_wakeUp_(me);
+    }
+
+    QS_BEGIN_(QS_QF_ACTIVE_POST_FIFO, QS_priv_.locFilter[AO_OBJ], me)
+        QS_TIME_();           /* timestamp */
+        QS_OBJ_(sender);      /* the sender object */
+        QS_SIG_((QSignal)0);  /* the signal of the event */
+        QS_OBJ_(me);          /* this active object */
+        QS_2U8_((uint8_t)0, (uint8_t)0); /* pool Id & refCtr of the evt */
+        QS_EQC_((QEQueueCtr)0); /* number of free entries */
+        QS_EQC_((QEQueueCtr)0); /* min number of free entries */
+    QS_END_()
+
+    return true; /* the event is always posted correctly */
+}
+/*..........................................................................*/
+static void QTicker_postLIFO_(QActive * const me, QEvt const * const e) {
+    (void)me;
+    (void)e;
+    Q_ERROR_ID(900);
+}
+
+/*****************************************************************************
+* NOTE1:
+* The consumer announces that it is about to block by setting the waiting
+* flag, then looks at the queue again before blocking, while a producer
+* first publishes its event, then clears the waiting flag and signals the
+* consumer if it was set. With sequentially consistent atomics, either the
+* consumer sees the event, or the producer sees the flag: a wake-up can be
+* spurious, when the consumer finds the event on its second look or when
+* the event published is not the one at the tail, but never lost. The
+* kernel object is only signaled when the consumer is about to block, so
+* a busy active object never enters the kernel on the post path.
+*
+* NOTE2:
+* Each entry reserved in the state word is either claimed by a producer or
+* taken by a LIFO post, and the consumer frees an entry only after clearing
+* it. The number of entries holding or about to hold an event is thus never
+* larger than the number of reserved entries, so after a successful
+* reservation the entry in front of the tail is free.
+*/
@@ -335,6 +335,7 @@ void QTimeEvt_armX(QTimeEvt * const me,
         */
         me->next = (QTimeEvt *)QF_timeEvtHead_[tickRate].act;
         QF_timeEvtHead_[tickRate].act = me;
+        QF_TIMEEVT_ARMED_(tickRate);
     }
 
     QS_BEGIN_NOCRIT_(QS_QF_TIMEEVT_ARM, QS_priv_.locFilter[TE_OBJ], me)
@@ -466,6 +467,7 @@ bool QTimeEvt_rearm(QTimeEvt * const me, QTimeEvtCtr const nTicks) {
             */
             me->next = (QTimeEvt *)QF_timeEvtHead_[tickRate].act;
             QF_timeEvtHead_[tickRate].act = me;
+            QF_TIMEEVT_ARMED_(tickRate);
         }
     }
     /* the time event is armed */
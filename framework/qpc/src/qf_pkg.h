@@ -86,6 +86,15 @@
     #define QF_CRIT_EXIT_()     QF_CRIT_EXIT(critStat_)
 #endif
 
+#ifndef QF_TIMEEVT_ARMED_
+    /*! Port hook called inside the critical section each time a time event
+    * is linked into the "freshly armed" list of the tick rate tickRate_.
+    * A port suspending the clock tick while no time events are armed
+    * (tickless idle) uses it to resume the clock tick.
+    */
+    #define QF_TIMEEVT_ARMED_(tickRate_) ((void)0)
+#endif
+
 
 /* package-scope objects ****************************************************/
 
@@ -365,6 +365,10 @@ struct _timeout {
 	sys_dlist_t *wait_q;
 	s32_t delta_ticks_from_prev;
 	_timeout_func_t func;
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	/* absolute expiry, in timing wheel ticks */
+	u32_t expiry;
+#endif
 };
 
 extern s32_t _timeout_remaining_get(struct _timeout *timeout);
@@ -399,6 +403,47 @@ struct __thread_entry {
 #endif
 
 /* can be used for creating 'dummy' threads, e.g. for pending on objects */
+#ifdef CONFIG_SCHED_EDF
+struct _thread_edf {
+	/* starts a new job every period */
+	struct _timeout release;
+
+	/* period, budget and budget left in the current job, in ticks */
+	s32_t period;
+	s32_t budget;
+	s32_t remaining;
+
+	/* relative deadline in cycles, and utilization in 1/1000 */
+	u32_t deadline;
+	u32_t utilization;
+
+	/* current job is complete, thread waits for its next period */
+	u8_t job_done;
+
+	u32_t jobs;
+	u32_t misses;
+	u32_t overruns;
+};
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+struct _thread_runtime_stats {
+	/* cycles spent running */
+	u64_t execution_cycles;
+
+	/* sum of the ready to running latencies, in cycles */
+	u64_t latency_total;
+
+	/* cycle count when made ready, while latency_pending is set */
+	u32_t ready_stamp;
+
+	u32_t latency_max;
+	u32_t latency_count;
+	u32_t switches;
+	u8_t latency_pending;
+};
+#endif
+
 struct _thread_base {
 
 	/* this thread's entry in a ready/wait queue */
@@ -451,19 +496,30 @@ struct _thread_base {
 	int prio_deadline;
 #endif
 
+#ifdef CONFIG_SCHED_EDF
+	struct _thread_edf edf;
+#endif
+
 	u32_t order_key;
 
 #ifdef CONFIG_SMP
 	/* True for the per-CPU idle threads */
 	u8_t is_idle;
 
-	/* CPU index on which thread was last run */
+	/* CPU index on which thread was last run, or whose run queue
+	 * holds the thread
+	 */
 	u8_t cpu;
 
 	/* Recursive count of irq_lock() calls */
 	u8_t global_lock_count;
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPUs the thread may run on, one bit per CPU index */
+	u32_t cpu_mask;
+#endif
+
 	/* data returned by APIs */
 	void *swap_data;
 
@@ -581,6 +637,16 @@ struct k_thread {
 	/** resource pool */
 	struct k_mem_pool *resource_pool;
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+	/** CPU usage and scheduling latency accounting */
+	struct _thread_runtime_stats rt_stats;
+#endif
+
+#if defined(CONFIG_LATENCY_HISTOGRAMS)
+	/** cycle count when woken up by a semaphore */
+	u32_t wake_stamp;
+#endif
+
 	/** arch-specifics: must always be at the end */
 	struct _thread_arch arch;
 };
@@ -1076,6 +1142,141 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
 #endif
 
+/**
+ * @brief Earliest-deadline-first statistics of a thread
+ */
+struct k_thread_edf_stats {
+	/** Jobs started, one per period */
+	u32_t jobs;
+	/** Jobs not completed by their deadline */
+	u32_t misses;
+	/** Jobs throttled for using up their budget */
+	u32_t overruns;
+};
+
+#ifdef CONFIG_SCHED_EDF
+/**
+ * @brief Admit a thread in the earliest-deadline-first class
+ *
+ * This makes @a thread periodic: a new job starts every @a period
+ * milliseconds, which must complete within @a deadline milliseconds
+ * and may run for at most @a budget milliseconds. The thread is moved
+ * to priority CONFIG_SCHED_EDF_PRIORITY, where threads are scheduled
+ * in the order of the absolute deadline of their current job. A
+ * thread which exhausts its budget is throttled until its next period.
+ *
+ * The first job starts immediately. A thread signals the completion of
+ * a job with k_thread_edf_wait().
+ *
+ * The thread is only admitted if the sum of budget over deadline of
+ * all EDF threads stays within CONFIG_SCHED_EDF_UTILIZATION_MAX.
+ * Passing a zero @a period removes the thread from the class, leaving
+ * its priority unchanged.
+ *
+ * @param thread Thread to admit.
+ * @param period Period of the jobs, in milliseconds.
+ * @param budget Maximum run time of a job, in milliseconds.
+ * @param deadline Deadline of a job relative to its start, in
+ *                 milliseconds, or 0 for the period.
+ *
+ * @retval 0 Thread admitted, or removed from the class.
+ * @retval -EINVAL Budget and deadline do not fit in the period.
+ * @retval -EBUSY Admission would exceed the utilization bound.
+ */
+__syscall int k_thread_edf_set(k_tid_t thread, s32_t period, s32_t budget,
+			       s32_t deadline);
+
+/**
+ * @brief Complete the current EDF job
+ *
+ * The calling thread, which must be in the earliest-deadline-first
+ * class, sleeps until its next job starts. Completing a job after its
+ * deadline counts as a miss.
+ *
+ * @return N/A
+ */
+__syscall void k_thread_edf_wait(void);
+
+/**
+ * @brief Get the earliest-deadline-first statistics of a thread
+ *
+ * @param thread Thread to query.
+ * @param stats Filled with the statistics of @a thread.
+ *
+ * @return N/A
+ */
+__syscall void k_thread_edf_stats_get(k_tid_t thread,
+				      struct k_thread_edf_stats *stats);
+#endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/**
+ * @brief Restrict the CPUs a thread may run on
+ *
+ * Bit N of @a mask allows @a thread to run on the CPU of index N; new
+ * threads may run on all CPUs. A ready thread is moved to the run queue
+ * of an allowed CPU right away, a thread running on a CPU it is no
+ * longer allowed on migrates at its next context switch.
+ *
+ * @param thread Thread to restrict.
+ * @param mask CPU affinity mask.
+ *
+ * @retval 0 Affinity changed.
+ * @retval -EINVAL @a mask selects no existing CPU.
+ */
+__syscall int k_thread_cpu_mask_set(k_tid_t thread, u32_t mask);
+#endif
+
+/**
+ * @brief Thread runtime statistics
+ *
+ * All times are in hardware cycles, see k_cycle_get_32().
+ */
+struct k_thread_runtime_stats {
+	/** Time spent running, interrupts included */
+	u64_t execution_cycles;
+	/** Time spent in the idle thread, only set for the whole system */
+	u64_t idle_cycles;
+	/** Number of times switched in */
+	u32_t switches;
+	/** Longest time from being made ready to being switched in */
+	u32_t latency_max;
+	/** Average time from being made ready to being switched in */
+	u32_t latency_avg;
+};
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Get the runtime statistics of a thread
+ *
+ * Reports the time @a thread has been running, how often it has been
+ * switched in, and how long it waited to run after being made ready,
+ * for example by a semaphore it pended on being given. Threads
+ * preempted while running are not counted as waiting.
+ *
+ * @param thread Thread to query.
+ * @param stats Filled with the statistics of @a thread.
+ *
+ * @return N/A
+ */
+__syscall void k_thread_runtime_stats_get(k_tid_t thread,
+					  struct k_thread_runtime_stats *stats);
+
+/**
+ * @brief Get the runtime statistics of the whole system
+ *
+ * Execution time, switches and latencies are accounted over all
+ * threads, including ones which have since terminated, the execution
+ * time covering all time elapsed since boot.
+ *
+ * @param stats Filled with the statistics of the system.
+ *
+ * @return N/A
+ */
+__syscall void k_thread_runtime_stats_all_get(
+	struct k_thread_runtime_stats *stats);
+#endif
+
 /**
  * @brief Suspend a thread.
  *
@@ -2539,6 +2740,15 @@ typedef void (*k_work_handler_t)(struct k_work *work);
 struct k_work_q {
 	struct k_queue queue;
 	struct k_thread thread;
+#ifdef CONFIG_WORK_Q_POOL
+	/* pool threads, NULL if the workqueue is served by its own thread */
+	struct k_thread *pool;
+	u32_t backlog;
+	u32_t backlog_max;
+	u32_t handler_max;
+	u32_t items;
+	u32_t stamp;
+#endif
 };
 
 enum {
@@ -2549,6 +2759,9 @@ struct k_work {
 	void *_reserved;		/* Used by k_queue implementation. */
 	k_work_handler_t handler;
 	atomic_t flags[1];
+#ifdef CONFIG_WORK_Q_POOL
+	int prio;
+#endif
 };
 
 struct k_delayed_work {
@@ -2559,6 +2772,11 @@ struct k_delayed_work {
 
 extern struct k_work_q k_sys_work_q;
 
+#ifdef CONFIG_WORK_Q_POOL
+extern void _k_work_q_pool_insert(struct k_work_q *work_q,
+				  struct k_work *work);
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -2632,6 +2850,12 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
 					  struct k_work *work)
 {
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+#ifdef CONFIG_WORK_Q_POOL
+		if (work_q->pool) {
+			_k_work_q_pool_insert(work_q, work);
+			return;
+		}
+#endif
 		k_queue_append(&work_q->queue, work);
 	}
 }
@@ -2675,6 +2899,87 @@ extern void k_work_q_start(struct k_work_q *work_q,
 			   k_thread_stack_t *stack,
 			   size_t stack_size, int prio);
 
+#ifdef CONFIG_WORK_Q_POOL
+/**
+ * @brief Workqueue statistics.
+ *
+ * Apart from @a backlog, the statistics cover the time since the previous
+ * call to k_work_q_stats_get(), or since the workqueue was started.
+ */
+struct k_work_q_stats {
+	/** Number of work items pending */
+	u32_t backlog;
+	/** Highest number of work items pending */
+	u32_t backlog_max;
+	/** Longest time spent in a work handler, in microseconds */
+	u32_t handler_max_us;
+	/** Number of work items processed */
+	u32_t items;
+	/** Number of work items processed per second */
+	u32_t items_per_sec;
+};
+
+/**
+ * @brief Start a workqueue served by a pool of threads.
+ *
+ * This routine starts workqueue @a work_q, whose work items are processed
+ * by @a num_threads threads sharing its queue. Pending work items are
+ * processed in the order of their priority, and in submission order among
+ * work items of the same priority. Each thread processes up to
+ * CONFIG_WORK_Q_POOL_BATCH work items before yielding the CPU.
+ *
+ * The workqueue can be used as any other workqueue, including for delayed
+ * work items. The thread embedded in @a work_q is not used.
+ *
+ * @param work_q Address of workqueue.
+ * @param threads Array of @a num_threads threads.
+ * @param stacks Array of @a num_threads stacks, as defined by
+ *		K_THREAD_STACK_ARRAY_DEFINE()
+ * @param stack_size Size of each stack (in bytes), which must be the same
+ *		constant passed to K_THREAD_STACK_ARRAY_DEFINE().
+ * @param num_threads Number of threads.
+ * @param prio Priority of the workqueue's threads.
+ *
+ * @return N/A
+ */
+extern void k_work_q_pool_start(struct k_work_q *work_q,
+				struct k_thread *threads,
+				k_thread_stack_t *stacks, size_t stack_size,
+				int num_threads, int prio);
+
+/**
+ * @brief Get the statistics of a workqueue pool.
+ *
+ * This routine gets the statistics of workqueue @a work_q, started with
+ * k_work_q_pool_start(), and starts a new period for them.
+ *
+ * @param work_q Address of workqueue.
+ * @param stats Address where to store the statistics.
+ *
+ * @return N/A
+ */
+extern void k_work_q_stats_get(struct k_work_q *work_q,
+			       struct k_work_q_stats *stats);
+
+/**
+ * @brief Set the priority of a work item.
+ *
+ * This routine sets the priority of work item @a work for its next
+ * submissions to a workqueue pool. As for threads, lower values are
+ * higher priorities. Work items are initialized with priority 0.
+ * Other workqueues process their work items in submission order.
+ *
+ * @param work Address of work item, which must not be pending.
+ * @param prio Priority.
+ *
+ * @return N/A
+ */
+static inline void k_work_prio_set(struct k_work *work, int prio)
+{
+	work->prio = prio;
+}
+#endif /* CONFIG_WORK_Q_POOL */
+
 /**
  * @brief Initialize a delayed work item.
  *
@@ -2845,6 +3150,10 @@ struct k_mutex {
 	u32_t lock_count;
 	int owner_orig_prio;
 
+#ifdef CONFIG_LOCK_STATS
+	struct k_lock_stats stats;
+#endif
+
 	_OBJECT_TRACING_NEXT_PTR(k_mutex);
 };
 
@@ -2857,6 +3166,7 @@ struct k_mutex {
 	.owner = NULL, \
 	.lock_count = 0, \
 	.owner_orig_prio = K_LOWEST_THREAD_PRIO, \
+	_LOCK_STATS_INIT(obj) \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -2933,6 +3243,142 @@ __syscall int k_mutex_lock(struct k_mutex *mutex, s32_t timeout);
  */
 __syscall void k_mutex_unlock(struct k_mutex *mutex);
 
+/**
+ * @}
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+/* set in the lock word while the kernel mutex tracks the owner */
+#define _K_UMUTEX_CONTENDED BIT(0)
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief User Mutex APIs
+ * @defgroup umutex_apis User Mutex APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief User mutex.
+ *
+ * A user mutex lives in memory the threads using it can access, and is
+ * locked and unlocked with an atomic operation on its lock word, which
+ * holds the owner thread. The kernel is only entered when the mutex is
+ * contended, at which point the kernel mutex backing it takes over the
+ * ownership, so that waiters block in priority order and raise the
+ * priority of the owner like they do for any mutex.
+ *
+ * The atomic operations are only done in user mode on architectures
+ * providing them as instructions (CONFIG_ATOMIC_OPERATIONS_BUILTIN).
+ */
+struct k_umutex {
+	/** Owner thread, 0 if unlocked */
+	atomic_t val;
+	/** Kernel mutex backing the user mutex when contended */
+	struct k_mutex *mutex;
+};
+
+/**
+ * @brief Statically initialize a user mutex.
+ *
+ * @param kmutex Address of the kernel mutex backing the user mutex.
+ */
+#define K_UMUTEX_INITIALIZER(kmutex) \
+	{ \
+	.val = ATOMIC_INIT(0), \
+	.mutex = (kmutex), \
+	}
+
+/**
+ * @brief Initialize a user mutex.
+ *
+ * This routine initializes user mutex @a umutex. Kernel mutex @a mutex
+ * must be initialized, and must not be used for anything else. Threads
+ * using the user mutex need access to both.
+ *
+ * @param umutex Address of the user mutex.
+ * @param mutex Address of the kernel mutex backing the user mutex.
+ *
+ * @return N/A
+ */
+static inline void k_umutex_init(struct k_umutex *umutex,
+				 struct k_mutex *mutex)
+{
+	atomic_set(&umutex->val, 0);
+	umutex->mutex = mutex;
+}
+
+/**
+ * @internal
+ */
+__syscall int k_umutex_lock_contended(struct k_umutex *umutex,
+				      s32_t timeout);
+
+/**
+ * @internal
+ */
+__syscall int k_umutex_unlock_contended(struct k_umutex *umutex);
+
+/**
+ * @brief Lock a user mutex.
+ *
+ * This routine locks user mutex @a umutex, without entering the kernel if
+ * it is unlocked. User mutexes are not recursive.
+ *
+ * The calling thread passes its own thread ID, which user threads can get
+ * once with k_current_get() rather than making a system call each time.
+ *
+ * @param umutex Address of the user mutex.
+ * @param self Thread ID of the calling thread.
+ * @param timeout Waiting period to lock the mutex (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Mutex locked.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EDEADLK The calling thread already owns the mutex.
+ * @retval -EINVAL The lock word is corrupted, or holds a thread the calling
+ *                 thread has no permission on.
+ */
+static inline int k_umutex_lock(struct k_umutex *umutex, k_tid_t self,
+				s32_t timeout)
+{
+	if (likely(atomic_cas(&umutex->val, 0, (atomic_val_t)self))) {
+		return 0;
+	}
+
+	return k_umutex_lock_contended(umutex, timeout);
+}
+
+/**
+ * @brief Unlock a user mutex.
+ *
+ * This routine unlocks user mutex @a umutex, which the calling thread must
+ * own, without entering the kernel unless other threads wait for it.
+ *
+ * @param umutex Address of the user mutex.
+ * @param self Thread ID of the calling thread, as passed to
+ *             k_umutex_lock().
+ *
+ * @retval 0 Mutex unlocked.
+ * @retval -EPERM The calling thread does not own the mutex.
+ */
+static inline int k_umutex_unlock(struct k_umutex *umutex, k_tid_t self)
+{
+	if (likely(atomic_cas(&umutex->val, (atomic_val_t)self, 0))) {
+		return 0;
+	}
+
+	return k_umutex_unlock_contended(umutex);
+}
+
 /**
  * @}
  */
@@ -3403,6 +3849,84 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Send several messages to a message queue.
+ *
+ * This routine sends up to @a num_msgs messages, stored back to back at
+ * @a data, to message queue @a q in a single critical section. Messages
+ * are handed to waiting receivers first, then copied into the ring buffer
+ * until it is full, and waiting threads are rescheduled once.
+ *
+ * The routine only waits when not a single message can be sent, in which
+ * case it sends the first message as k_msgq_put() would.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Pointer to the messages.
+ * @param num_msgs Number of messages to send.
+ * @param timeout Waiting period to send the first message (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @return Number of messages sent (at least one) if successful.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_msgq_put_n(struct k_msgq *q, void *data, u32_t num_msgs,
+			   s32_t timeout);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a num_msgs messages from message queue
+ * @a q in a single critical section, storing them back to back at
+ * @a data. The ring buffer space released is refilled with the messages
+ * of waiting senders, and waiting threads are rescheduled once.
+ *
+ * The routine only waits when the queue is empty, in which case it
+ * receives a single message as k_msgq_get() would.
+ *
+ * If @a data is NULL the messages are discarded, which releases messages
+ * inspected in place with k_msgq_peek_n(). Waiting requires a buffer.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold the received messages, or NULL.
+ * @param num_msgs Maximum number of messages to receive.
+ * @param timeout Waiting period to receive a message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of messages received (at least one) if successful.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+__syscall int k_msgq_get_n(struct k_msgq *q, void *data, u32_t num_msgs,
+			   s32_t timeout);
+
+/**
+ * @brief Inspect messages in place in a message queue.
+ *
+ * This routine returns the address of the oldest message of message queue
+ * @a q in its ring buffer, and how many of the following messages are
+ * stored contiguously from there, without copying nor removing them. The
+ * run stops at the end of the ring buffer, a second call after releasing
+ * the run returns the messages that wrapped around.
+ *
+ * The messages stay valid until they are received, so there must be a
+ * single receiver, which releases them with k_msgq_get_n() and a NULL
+ * buffer once done. User threads need read access to the ring buffer.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold the address of the first message.
+ * @param num_msgs Maximum number of messages to inspect.
+ *
+ * @return Number of contiguous messages at @a data, 0 if the queue is
+ *         empty.
+ */
+__syscall u32_t k_msgq_peek_n(struct k_msgq *q, void **data, u32_t num_msgs);
+
 /**
  * @brief Purge a message queue.
  *
@@ -3871,12 +4395,104 @@ __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 			     size_t size, struct k_sem *sem);
 
+/**
+ * @brief Claim free space of a pipe's buffer to write data in place.
+ *
+ * This routine gives the caller a contiguous region of the free space of
+ * @a pipe's buffer, which is filled in place and then committed with
+ * k_pipe_put_commit(), without the copy k_pipe_put() does. It waits for
+ * space if the buffer is full.
+ *
+ * A pipe must not be written with k_pipe_put() while a region is claimed.
+ * The buffer of a pipe is not accessible to user threads, so this routine
+ * is only available to supervisor threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold the start of the region.
+ * @param size On entry, maximum number of bytes to claim. On return, number
+ *             of bytes claimed, which may be less when the free space wraps
+ *             around the end of the buffer.
+ * @param timeout Waiting period to wait for free space (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 A region was claimed.
+ * @retval -EINVAL The pipe has no buffer, or @a size is 0.
+ * @retval -EAGAIN The buffer is full, or waiting period timed out.
+ */
+extern int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t *size,
+			    s32_t timeout);
+
+/**
+ * @brief Commit data written in place to a pipe.
+ *
+ * This routine makes @a size bytes at the start of the region claimed by
+ * k_pipe_put_claim() available to readers, and wakes up those waiting for
+ * data.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes written, at most the number of bytes claimed.
+ *
+ * @retval 0 The data was committed.
+ * @retval -EINVAL @a size exceeds the free space of the claimed region.
+ */
+extern int k_pipe_put_commit(struct k_pipe *pipe, size_t size);
+
+/**
+ * @brief Claim data of a pipe's buffer to read it in place.
+ *
+ * This routine gives the caller a contiguous region of the data in @a pipe's
+ * buffer, which is read in place and then released with
+ * k_pipe_get_commit(), without the copy k_pipe_get() does. It waits for
+ * data if the buffer is empty.
+ *
+ * A pipe must not be read with k_pipe_get() while a region is claimed.
+ * This routine is only available to supervisor threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold the start of the region.
+ * @param size On entry, maximum number of bytes to claim. On return, number
+ *             of bytes claimed, which may be less when the data wraps around
+ *             the end of the buffer.
+ * @param timeout Waiting period to wait for data (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 A region was claimed.
+ * @retval -EINVAL The pipe has no buffer, or @a size is 0.
+ * @retval -EAGAIN The buffer is empty, or waiting period timed out.
+ */
+extern int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t *size,
+			    s32_t timeout);
+
+/**
+ * @brief Release data read in place from a pipe.
+ *
+ * This routine frees @a size bytes at the start of the region claimed by
+ * k_pipe_get_claim(), and wakes up the writers waiting for space.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes read, at most the number of bytes claimed.
+ *
+ * @retval 0 The data was released.
+ * @retval -EINVAL @a size exceeds the data of the claimed region.
+ */
+extern int k_pipe_get_commit(struct k_pipe *pipe, size_t size);
+
 /** @} */
 
 /**
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+struct _mem_slab_magazine {
+#ifdef CONFIG_SMP
+	atomic_t lock;
+#endif
+	u32_t count;
+	void *blocks[CONFIG_MEM_SLAB_MAGAZINE_SIZE];
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	u32_t num_blocks;
@@ -3884,8 +4500,19 @@ struct k_mem_slab {
 	char *buffer;
 	char *free_list;
 	u32_t num_used;
+#ifdef CONFIG_MEM_SLAB_LAZY_INIT
+	/* blocks of the buffer handed out at least once, in order */
+	u32_t num_carved;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab);
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	/* free blocks cached per CPU, still counted in num_used */
+	struct _mem_slab_magazine magazines[CONFIG_MP_NUM_CPUS];
+	/* threads waiting, or about to wait, for a block */
+	u32_t num_waiters;
+#endif
 };
 
 #define _K_MEM_SLAB_INITIALIZER(obj, slab_buffer, slab_block_size, \
@@ -4010,7 +4637,18 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	u32_t num_used = slab->num_used;
+	int i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		num_used -= slab->magazines[i].count;
+	}
+
+	return num_used;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4026,7 +4664,7 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
 /** @} */
@@ -4196,6 +4834,22 @@ extern void k_free(void *ptr);
  */
 extern void *k_calloc(size_t nmemb, size_t size);
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+struct sys_tlsf_stats;
+
+/**
+ * @brief Get heap usage statistics
+ *
+ * This routine reports the free and used bytes of the heap, the largest
+ * block k_malloc() can currently return and the resulting fragmentation.
+ *
+ * @param stats Filled with the heap statistics.
+ *
+ * @return N/A
+ */
+extern void k_malloc_stats_get(struct sys_tlsf_stats *stats);
+#endif
+
 /** @} */
 
 /* polling API - PRIVATE */
@@ -4501,6 +5155,93 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
 
 __syscall int k_poll_signal(struct k_poll_signal *signal, int result);
 
+/**
+ * @brief Poll set
+ *
+ * A poll set keeps its events registered with their objects between waits.
+ * An object signaling an event of the set puts it on the ready list of the
+ * set, so that waiting on the set costs a time proportional to the number of
+ * ready events, not to the number of events in the set.
+ */
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+
+	/* poller of the events of the set, with no thread */
+	struct _poller poller;
+
+	/* events signaled since the last wait */
+	sys_dlist_t ready;
+
+	/* events returned by the last wait, re-armed by the next one */
+	sys_dlist_t returned;
+
+	/* threads waiting on the set */
+	_wait_q_t wait_q;
+};
+
+/**
+ * @brief Initialize a poll set.
+ *
+ * @param set Poll set to initialize.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set);
+
+/**
+ * @brief Add a poll event to a poll set.
+ *
+ * The event, initialized with k_poll_event_init(), stays registered with its
+ * object until it is removed from the set. It must not be passed to k_poll()
+ * or added to another set in the meantime.
+ *
+ * @param set Poll set.
+ * @param event Event to add.
+ *
+ * @retval 0 The event was added.
+ * @retval -EINVAL The event is of type K_POLL_TYPE_IGNORE.
+ * @retval -EBUSY The event is already being polled.
+ */
+extern int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event);
+
+/**
+ * @brief Remove a poll event from a poll set.
+ *
+ * @param set Poll set.
+ * @param event Event to remove.
+ *
+ * @retval 0 The event was removed.
+ * @retval -EINVAL The event is not in the set.
+ */
+extern int k_poll_set_remove(struct k_poll_set *set,
+			     struct k_poll_event *event);
+
+/**
+ * @brief Wait for events of a poll set to be ready.
+ *
+ * Stores pointers to the ready events of the set in @a events, with their
+ * state field set like k_poll() does.
+ *
+ * Events are level-triggered: those returned are checked again by the next
+ * call on the set, and returned again if their condition still is met. The
+ * caller thus must take the semaphore, get the data or reset the signal of
+ * each returned event before waiting again.
+ *
+ * Unlike k_poll(), this routine is not available to user threads.
+ *
+ * @param set Poll set.
+ * @param events Array filled with the ready events.
+ * @param num_events Maximum number of events to return.
+ * @param timeout Waiting period for an event to be ready (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of events returned, which can be 0 when another thread
+ *         waiting on the set took the ready events first.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **events,
+			   int num_events, s32_t timeout);
+
 /**
  * @internal
  */
@@ -33,5 +33,7 @@
 #include <misc/printk.h>
 #include <arch/cpu.h>
 #include <misc/rb.h>
+#include <lock_stats.h>
+#include <latency_hist.h>
 
 #endif /* _KERNEL_INCLUDES__H */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Latency histograms
+ *
+ * With CONFIG_LATENCY_HISTOGRAMS, the kernel keeps histograms of the time
+ * from entering an interrupt to calling its handler, for each IRQ line,
+ * and of the time from a wake-up to the code woken up running, for each
+ * wake-up source. Otherwise none of this takes any space or time.
+ */
+
+#ifndef _LATENCY_HIST_H
+#define _LATENCY_HIST_H
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Wake-up sources with a latency histogram
+ */
+enum k_latency_src {
+	/** From k_sem_give() to the thread it woke up running */
+	K_LATENCY_SEM_WAKE,
+	/** From the tick a k_timer expired at being announced to its expiry
+	 * function being called
+	 */
+	K_LATENCY_TIMER_EXPIRY,
+
+	K_LATENCY_SRC_NUM
+};
+
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+
+/**
+ * @brief Latency histogram
+ *
+ * Latencies are counted in buckets of hardware cycles growing as powers
+ * of two: bucket 0 counts latencies of 0 cycles, and bucket i latencies
+ * from 2^(i-1) up to 2^i - 1 cycles. The last bucket also counts all
+ * longer latencies.
+ */
+struct k_latency_hist {
+	/** Number of latencies in each bucket */
+	u32_t count[CONFIG_LATENCY_HIST_BUCKETS];
+	/** Longest latency, in cycles */
+	u32_t max;
+};
+
+/**
+ * @brief Get the interrupt latency histogram of an IRQ line
+ *
+ * Copies the histogram of the time from entering an interrupt to calling
+ * the handler of line @a irq, which is recorded on the ARM, Nios II and
+ * POSIX architectures.
+ *
+ * @param irq IRQ line number.
+ * @param hist Filled with the histogram.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @a irq is not below CONFIG_LATENCY_HIST_NUM_IRQS.
+ */
+extern int k_latency_hist_irq_get(unsigned int irq,
+				  struct k_latency_hist *hist);
+
+/**
+ * @brief Get the latency histogram of a wake-up source
+ *
+ * @param src Wake-up source.
+ * @param hist Filled with the histogram.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @a src is not a wake-up source.
+ */
+extern int k_latency_hist_get(enum k_latency_src src,
+			      struct k_latency_hist *hist);
+
+/**
+ * @brief Clear all latency histograms
+ *
+ * @return N/A
+ */
+extern void k_latency_hist_reset(void);
+
+/**
+ * @brief Print all non empty latency histograms
+ *
+ * @return N/A
+ */
+extern void k_latency_hist_dump(void);
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+extern void _latency_hist_isr_start(void);
+extern void _latency_hist_isr_handler(unsigned int irq);
+extern void _latency_hist_tick_start(void);
+extern void _latency_hist_timer_expiry(void);
+extern void _latency_hist_record(enum k_latency_src src, u32_t start);
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+#endif /* CONFIG_LATENCY_HISTOGRAMS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LATENCY_HIST_H */
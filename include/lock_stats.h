@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock contention statistics
+ *
+ * With CONFIG_LOCK_STATS, spinlocks and mutexes embed a struct k_lock_stats
+ * recording how they are used. Otherwise none of this takes any space or
+ * time.
+ */
+
+#ifndef _LOCK_STATS_H
+#define _LOCK_STATS_H
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statistics of a lock
+ *
+ * All times are in hardware cycles, see k_cycle_get_32().
+ */
+struct k_lock_stats {
+	/** Name of the lock, may be NULL */
+	const char *name;
+	/** Number of times the lock was acquired */
+	u32_t acquisitions;
+	/** Number of times the lock had to be waited for */
+	u32_t contended;
+	/** Time spent waiting for the lock */
+	u64_t wait_cycles;
+	/** Longest wait for the lock */
+	u32_t wait_max;
+	/** Longest time the lock was held */
+	u32_t hold_max;
+
+	/* PRIVATE - DO NOT TOUCH */
+	u32_t hold_start;
+	struct k_lock_stats *next;
+	bool registered;
+};
+
+#ifdef CONFIG_LOCK_STATS
+
+/**
+ * @brief Name a spinlock or a mutex in the lock statistics
+ *
+ * Mutexes defined with K_MUTEX_DEFINE() and spinlocks initialized with
+ * K_SPINLOCK_INITIALIZER() are named after their variable.
+ *
+ * @param lock Address of the lock.
+ * @param lock_name Static name of the lock.
+ */
+#define k_lock_stats_name_set(lock, lock_name) \
+	((lock)->stats.name = (lock_name))
+
+/**
+ * @brief Remove a spinlock or a mutex from the lock statistics
+ *
+ * Locks register themselves the first time they are acquired. A lock that
+ * is not statically allocated must be removed before its memory is freed
+ * or reused, like when it goes out of scope. k_mutex_init() removes the
+ * mutex it initializes.
+ *
+ * @param lock Address of the lock.
+ */
+#define k_lock_stats_remove(lock) _lock_stats_remove(&(lock)->stats)
+
+/**
+ * @brief Print the statistics of the most waited for locks
+ *
+ * Locks appear once they have been acquired, ordered by the total time
+ * spent waiting for them.
+ *
+ * @param num Maximum number of locks to print.
+ */
+extern void k_lock_stats_dump(int num);
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+#define _LOCK_STATS_INIT(obj) .stats = { .name = #obj },
+
+#define _LOCK_STATS_START(var) u32_t var = k_cycle_get_32()
+
+#define _LOCK_STATS_ACQUIRED(lock, start, is_contended) \
+	_lock_stats_acquired(&(lock)->stats, start, is_contended)
+
+#define _LOCK_STATS_RELEASED(lock) _lock_stats_released(&(lock)->stats)
+
+#define _LOCK_STATS_RESET(lock) _lock_stats_reset(&(lock)->stats)
+
+extern void _lock_stats_acquired(struct k_lock_stats *stats, u32_t start,
+				 bool contended);
+extern void _lock_stats_released(struct k_lock_stats *stats);
+extern void _lock_stats_remove(struct k_lock_stats *stats);
+extern void _lock_stats_reset(struct k_lock_stats *stats);
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+#else
+
+#define k_lock_stats_name_set(lock, lock_name) do { } while (false)
+#define k_lock_stats_remove(lock) do { } while (false)
+
+#define _LOCK_STATS_INIT(obj)
+#define _LOCK_STATS_START(var)
+#define _LOCK_STATS_ACQUIRED(lock, start, is_contended) do { } while (false)
+#define _LOCK_STATS_RELEASED(lock) do { } while (false)
+#define _LOCK_STATS_RESET(lock) do { } while (false)
+
+#endif /* CONFIG_LOCK_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LOCK_STATS_H */
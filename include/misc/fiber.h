@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Fibers
+ *
+ * Fibers are cooperative contexts with their own stack, multiplexed on a
+ * single host thread. They only give up the host thread when yielding or
+ * waiting, and wait for kernel objects through a poll set of the host, so
+ * that the host thread blocks only when none of its fibers can run.
+ *
+ * Fibers are created before their host runs, or by other fibers of the
+ * same host. The blocking functions below may only be called by fibers.
+ */
+
+#ifndef _MISC_FIBER_H
+#define _MISC_FIBER_H
+
+#include <kernel.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*sys_fiber_entry_t)(void *arg);
+
+struct sys_fiber_host;
+
+/**
+ * @brief Fiber
+ */
+struct sys_fiber {
+	/* PRIVATE - DO NOT TOUCH */
+	sys_dnode_t node;
+	struct sys_fiber_host *host;
+	void *sp;
+	u32_t *stack_base;
+	sys_fiber_entry_t entry;
+	void *arg;
+
+	/* events waited for, until the deadline when timed */
+	struct k_poll_event *events;
+	int num_events;
+	bool timed;
+	s64_t deadline;
+	int result;
+};
+
+/**
+ * @brief Host thread of fibers
+ */
+struct sys_fiber_host {
+	/* PRIVATE - DO NOT TOUCH */
+	sys_snode_t node;
+	k_tid_t thread;
+	void *sp;
+	struct sys_fiber *current;
+	sys_dlist_t ready;
+	sys_dlist_t waiting;
+	struct k_poll_set set;
+	u32_t num_fibers;
+};
+
+/**
+ * @brief Statically define a fiber stack
+ *
+ * @param sym Name of the stack.
+ * @param size Size of the stack in bytes.
+ */
+#define SYS_FIBER_STACK_DEFINE(sym, size) char __aligned(8) sym[size]
+
+/**
+ * @brief Initialize a fiber host
+ *
+ * @param host Address of the host.
+ *
+ * @return N/A
+ */
+void sys_fiber_host_init(struct sys_fiber_host *host);
+
+/**
+ * @brief Run fibers
+ *
+ * The calling thread becomes the host thread, and runs the fibers of
+ * @a host until they have all returned.
+ *
+ * @param host Address of the host.
+ *
+ * @return N/A
+ */
+void sys_fiber_host_run(struct sys_fiber_host *host);
+
+/**
+ * @brief Create a fiber
+ *
+ * The fiber is ready to run and starts by calling @a entry, its end
+ * being the return from @a entry. Its stack is not touched beyond a
+ * sentinel word at its base, checked at every switch when assertions
+ * are enabled.
+ *
+ * @param host Host running the fiber.
+ * @param fiber Address of the fiber.
+ * @param stack Stack of the fiber.
+ * @param stack_size Size of the stack in bytes.
+ * @param entry Function to run.
+ * @param arg Argument passed to @a entry.
+ *
+ * @return N/A
+ */
+void sys_fiber_create(struct sys_fiber_host *host, struct sys_fiber *fiber,
+		      void *stack, size_t stack_size, sys_fiber_entry_t entry,
+		      void *arg);
+
+/**
+ * @brief Get the running fiber
+ *
+ * @return Fiber running on the calling thread, or NULL if none.
+ */
+struct sys_fiber *sys_fiber_current(void);
+
+/**
+ * @brief Let the other ready fibers of the host run
+ *
+ * @return N/A
+ */
+void sys_fiber_yield(void);
+
+/**
+ * @brief Wait for any of a set of events
+ *
+ * Like k_poll(), but only suspends the calling fiber. The state of the
+ * events reports which ones are ready.
+ *
+ * @param events Array of events, in K_POLL_MODE_NOTIFY_ONLY mode.
+ * @param num_events Number of events, 0 to only sleep until @a timeout.
+ * @param timeout Waiting period in milliseconds, or one of the special
+ * values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 One or more events are ready.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int sys_fiber_poll(struct k_poll_event *events, int num_events,
+		   s32_t timeout);
+
+/**
+ * @brief Put the calling fiber to sleep
+ *
+ * @param duration Number of milliseconds to sleep.
+ *
+ * @return N/A
+ */
+void sys_fiber_sleep(s32_t duration);
+
+/**
+ * @brief Take a semaphore from a fiber
+ *
+ * Like k_sem_take(), but only suspends the calling fiber.
+ *
+ * @param sem Address of the semaphore.
+ * @param timeout Waiting period in milliseconds, or one of the special
+ * values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Semaphore taken.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int sys_fiber_sem_take(struct k_sem *sem, s32_t timeout);
+
+/**
+ * @brief Get an element from a queue from a fiber
+ *
+ * Like k_queue_get(), but only suspends the calling fiber.
+ *
+ * @param queue Address of the queue.
+ * @param timeout Waiting period in milliseconds, or one of the special
+ * values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Address of the data item if successful; NULL if returned
+ * without waiting, or waiting period timed out.
+ */
+void *sys_fiber_queue_get(struct k_queue *queue, s32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MISC_FIBER_H */
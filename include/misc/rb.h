@@ -38,6 +38,11 @@
  * structure of the tree being generated dynamically via a stack as
  * the tree is recursed.  So the overall memory overhead of a node is
  * just two pointers, identical with a doubly-linked list.
+ *
+ * The tree caches its lowest and highest-sorted nodes, and can keep
+ * data about the subtree of each node up to date through an optional
+ * callback (see rb_augment_t), on which interval or priority indexes
+ * can be built.
  */
 
 #ifndef _RB_H
@@ -62,10 +67,26 @@ struct rbnode {
  */
 typedef int (*rb_lessthan_t)(struct rbnode *a, struct rbnode *b);
 
+/**
+ * @typedef rb_augment_t
+ * @brief Red/black tree augmentation callback
+ *
+ * Optional.  Called on a node whose subtree changed, to recompute the
+ * data the user keeps in the enclosing struct about that subtree (for
+ * example the highest end of the intervals below the node, for an
+ * interval tree) from the node and its children, which can be read
+ * with _rb_child().  The children of a node are always updated before
+ * the node itself.
+ */
+typedef void (*rb_augment_t)(struct rbnode *node);
+
 struct rbtree {
 	struct rbnode *root;
 	rb_lessthan_t lessthan_fn;
 	int max_depth;
+	/* Cached lowest and highest-sorted nodes */
+	struct rbnode *minmax[2];
+	rb_augment_t augment_fn;
 };
 
 typedef void (*rb_visit_t)(struct rbnode *node, void *cookie);
@@ -87,18 +108,22 @@ void rb_remove(struct rbtree *tree, struct rbnode *node);
 
 /**
  * @brief Returns the lowest-sorted member of the tree
+ *
+ * The node is cached in the tree, this runs in constant time.
  */
 static inline struct rbnode *rb_get_min(struct rbtree *tree)
 {
-	return _rb_get_minmax(tree, 0);
+	return tree->minmax[0];
 }
 
 /**
  * @brief Returns the highest-sorted member of the tree
+ *
+ * The node is cached in the tree, this runs in constant time.
  */
 static inline struct rbnode *rb_get_max(struct rbtree *tree)
 {
-	return _rb_get_minmax(tree, 1);
+	return tree->minmax[1];
 }
 
 /**
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SYS_TLSF_H
+#define SYS_TLSF_H
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Two-level segregated fit heap: free blocks are kept in lists indexed by a
+ * first level (power of two size class) and a second level (linear split of
+ * that class), with a bitmap per level, so that a suitable block is found
+ * with two find-first-set operations.
+ */
+
+#define _TLSF_SL_INDEX_COUNT_LOG2 4
+#define _TLSF_SL_INDEX_COUNT (1 << _TLSF_SL_INDEX_COUNT_LOG2)
+
+#define _TLSF_ALIGN_SIZE_LOG2 (sizeof(void *) == 8 ? 3 : 2)
+#define _TLSF_ALIGN_SIZE (1 << _TLSF_ALIGN_SIZE_LOG2)
+
+#define _TLSF_FL_INDEX_SHIFT (_TLSF_SL_INDEX_COUNT_LOG2 + _TLSF_ALIGN_SIZE_LOG2)
+#define _TLSF_FL_INDEX_COUNT \
+	(CONFIG_TLSF_FL_INDEX_MAX - _TLSF_FL_INDEX_SHIFT + 1)
+
+struct _tlsf_block;
+
+struct sys_tlsf {
+	char *buf;
+	size_t size;
+	size_t free_bytes;
+	size_t used_bytes;
+	u32_t fl_bitmap;
+	u32_t sl_bitmap[_TLSF_FL_INDEX_COUNT];
+	struct _tlsf_block *blocks[_TLSF_FL_INDEX_COUNT][_TLSF_SL_INDEX_COUNT];
+};
+
+struct sys_tlsf_stats {
+	/** Bytes available in free blocks */
+	size_t free_bytes;
+	/** Bytes handed out, including per block overhead */
+	size_t used_bytes;
+	/** Largest allocation that can currently succeed */
+	size_t largest_free;
+	/** Share of free memory outside of the largest free block, in % */
+	u32_t fragmentation;
+};
+
+/**
+ * @brief Initialize a TLSF heap
+ *
+ * Lays out a single free block covering @a bytes of @a mem. Blocks larger
+ * than 2^CONFIG_TLSF_FL_INDEX_MAX bytes cannot be represented, any memory
+ * past that size is left unused.
+ *
+ * The heap does no locking of its own: callers sharing a heap between
+ * contexts must serialize the calls. All operations but
+ * sys_tlsf_stats_get() run in constant time.
+ *
+ * @param heap Heap to initialize
+ * @param mem Memory backing the heap
+ * @param bytes Size of @a mem
+ *
+ * @return 0 on success, -EINVAL if @a mem is too small to hold a block
+ */
+int sys_tlsf_init(struct sys_tlsf *heap, void *mem, size_t bytes);
+
+/**
+ * @brief Allocate memory from a TLSF heap
+ *
+ * @param heap Heap to allocate from
+ * @param size Number of bytes requested
+ *
+ * @return Pointer to memory aligned on pointer size, or NULL if no free
+ *	   block is large enough or @a size is zero
+ */
+void *sys_tlsf_alloc(struct sys_tlsf *heap, size_t size);
+
+/**
+ * @brief Return memory to a TLSF heap
+ *
+ * The freed block is merged with its free physical neighbours.
+ *
+ * @param heap Heap @a ptr was allocated from
+ * @param ptr Memory returned by sys_tlsf_alloc(), or NULL
+ */
+void sys_tlsf_free(struct sys_tlsf *heap, void *ptr);
+
+/**
+ * @brief Tell whether a pointer lies within a TLSF heap
+ *
+ * @param heap Heap to check
+ * @param ptr Pointer to check
+ *
+ * @return true if @a ptr points into the memory backing @a heap
+ */
+static inline bool sys_tlsf_contains(struct sys_tlsf *heap, void *ptr)
+{
+	return (char *)ptr >= heap->buf && (char *)ptr < heap->buf + heap->size;
+}
+
+/**
+ * @brief Get usage statistics of a TLSF heap
+ *
+ * Walks the free list holding the largest free blocks, so it takes time
+ * proportional to its length.
+ *
+ * @param heap Heap to inspect
+ * @param stats Filled with the current statistics
+ */
+void sys_tlsf_stats_get(struct sys_tlsf *heap, struct sys_tlsf_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYS_TLSF_H */
@@ -184,6 +184,9 @@ enum {
 	/* interface is in promiscuous mode */
 	NET_IF_PROMISC,
 
+	/* driver sends packets straight from their fragments */
+	NET_IF_TX_SG,
+
 	/* Total number of flags - must be at the end of the enum */
 	NET_IF_NUM_FLAGS
 };
@@ -1758,9 +1761,46 @@ void net_if_unset_promisc(struct net_if *iface);
  */
 bool net_if_is_promisc(struct net_if *iface);
 
+/**
+ * @brief Check if the driver sends packets from their fragments.
+ *
+ * @details Such a driver does not need the fragments of a packet to be
+ * filled up, so the stack does not compact them before sending.
+ *
+ * @param iface Pointer to network interface
+ *
+ * @return True if the driver does scatter-gather transmission, False
+ *         otherwise.
+ */
+static inline bool net_if_is_tx_sg(struct net_if *iface)
+{
+	return atomic_test_bit(iface->if_dev->flags, NET_IF_TX_SG);
+}
+
+/** Most I/O vector entries given to net_if_api.send_iov */
+#define NET_IF_MAX_IOV 16
+
+/** I/O vector entry, one per fragment of a sent packet */
+struct net_iovec {
+	void *base;
+	size_t len;
+};
+
 struct net_if_api {
 	void (*init)(struct net_if *iface);
 	int (*send)(struct net_if *iface, struct net_pkt *pkt);
+
+	/** Optional: send a packet from an I/O vector over its fragments,
+	 * the first entry starting with the link layer header. The
+	 * interface gets the NET_IF_TX_SG flag. send() is still used for
+	 * packets with more than NET_IF_MAX_IOV fragments.
+	 *
+	 * As with send(), the packet belongs to the driver on success: it
+	 * unrefs the packet, releasing the fragments, once they have been
+	 * transmitted.
+	 */
+	int (*send_iov)(struct net_if *iface, struct net_pkt *pkt,
+			const struct net_iovec *iov, int iovcnt);
 };
 
 #if defined(CONFIG_NET_DHCPV4)
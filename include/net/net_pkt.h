@@ -1129,6 +1129,20 @@ int net_frag_linear_copy(struct net_buf *dst, struct net_buf *src,
 int net_frag_linearize(u8_t *dst, size_t dst_len,
 		       struct net_pkt *src, u16_t offset, u16_t len);
 
+/**
+ * @brief Get an I/O vector over the fragments of a packet.
+ *
+ * @details The first entry starts with the link layer header reserved in
+ * front of the first fragment. Empty fragments are skipped.
+ *
+ * @param pkt Network packet.
+ * @param iov I/O vector to fill
+ * @param iovcnt Number of entries in the I/O vector
+ *
+ * @return Number of entries filled, -E2BIG if there are not enough of them
+ */
+int net_pkt_get_iovec(struct net_pkt *pkt, struct net_iovec *iov, int iovcnt);
+
 /**
  * @brief Compact the fragment list of a packet.
  *
@@ -56,6 +56,9 @@ static inline int clock_settime(clockid_t clock_id, const struct timespec *ts)
 }
 
 int clock_gettime(clockid_t clock_id, struct timespec *ts);
+int clock_nanosleep(clockid_t clock_id, int flags,
+		    const struct timespec *rqtp, struct timespec *rmtp);
+int nanosleep(const struct timespec *rqtp, struct timespec *rmtp);
 /* Timer APIs */
 int timer_create(clockid_t clockId, struct sigevent *evp, timer_t *timerid);
 int timer_delete(timer_t timerid);
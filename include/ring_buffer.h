@@ -200,6 +200,192 @@ int sys_ring_buf_put(struct ring_buf *buf, u16_t type, u8_t value,
 int sys_ring_buf_get(struct ring_buf *buf, u16_t *type, u8_t *value,
 		     u32_t *data, u8_t *size32);
 
+/**
+ * @brief A structure to represent a byte ring buffer
+ *
+ * A byte ring buffer has a single producer and a single consumer, for
+ * instance an ISR and a thread, which need no locking between them. The
+ * positions run freely and are only reduced modulo the size when indexing
+ * @a buf, which lets the buffer be filled up to its full size.
+ */
+struct byte_ring {
+	u32_t head;	/**< Read position, only written by the consumer */
+	u32_t tail;	/**< Write position, only written by the producer */
+	u32_t mask;	/**< Size of buf minus 1, the size is a power of 2 */
+	u8_t *buf;	/**< Memory region for stored bytes */
+};
+
+/**
+ * @brief Statically define and initialize a byte ring buffer.
+ *
+ * This macro establishes a byte ring buffer of 2^pow bytes, where @a pow
+ * is the specified ring buffer size exponent.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct byte_ring <name>; @endcode
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define SYS_BYTE_RING_DECLARE_POW2(name, pow) \
+	static u8_t _byte_ring_data_##name[1 << (pow)]; \
+	struct byte_ring name = { \
+		.mask = (1 << (pow)) - 1, \
+		.buf = _byte_ring_data_##name \
+	};
+
+/**
+ * @brief Initialize a byte ring buffer.
+ *
+ * This routine initializes a byte ring buffer, prior to its first use. It
+ * is only used for ring buffers not defined using
+ * SYS_BYTE_RING_DECLARE_POW2.
+ *
+ * @param ring Address of ring buffer.
+ * @param size Ring buffer size (in bytes), which must be a power of 2.
+ * @param data Ring buffer data area (typically u8_t data[size]).
+ */
+static inline void sys_byte_ring_init(struct byte_ring *ring, u32_t size,
+				      u8_t *data)
+{
+	__ASSERT(is_power_of_two(size), "size is not a power of 2");
+
+	ring->head = 0;
+	ring->tail = 0;
+	ring->mask = size - 1;
+	ring->buf = data;
+}
+
+/**
+ * @brief Determine the number of bytes stored in a byte ring buffer.
+ *
+ * @param ring Address of ring buffer.
+ *
+ * @return Number of bytes available to the consumer.
+ */
+static inline u32_t sys_byte_ring_used_get(struct byte_ring *ring)
+{
+	return *(volatile u32_t *)&ring->tail -
+	       *(volatile u32_t *)&ring->head;
+}
+
+/**
+ * @brief Determine free space in a byte ring buffer.
+ *
+ * @param ring Address of ring buffer.
+ *
+ * @return Number of bytes available to the producer.
+ */
+static inline u32_t sys_byte_ring_space_get(struct byte_ring *ring)
+{
+	return ring->mask + 1 - sys_byte_ring_used_get(ring);
+}
+
+/**
+ * @brief Determine if a byte ring buffer is empty.
+ *
+ * @param ring Address of ring buffer.
+ *
+ * @return 1 if the ring buffer is empty, or 0 if not.
+ */
+static inline int sys_byte_ring_is_empty(struct byte_ring *ring)
+{
+	return sys_byte_ring_used_get(ring) == 0;
+}
+
+/**
+ * @brief Claim free space in a byte ring buffer, for the producer.
+ *
+ * This routine provides the largest contiguous free region of byte ring
+ * buffer @a ring, up to @a size bytes, for the producer to fill in place.
+ * The bytes are made available to the consumer by
+ * sys_byte_ring_put_commit(). Claiming again before committing provides
+ * the same region.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Area to store the address of the region.
+ * @param size Maximum number of bytes wanted.
+ *
+ * @return Size of the region (in bytes), 0 if the ring buffer is full.
+ */
+u32_t sys_byte_ring_put_claim(struct byte_ring *ring, u8_t **data,
+			      u32_t size);
+
+/**
+ * @brief Make bytes written to a byte ring buffer available.
+ *
+ * This routine makes the first @a size bytes of the region claimed by
+ * sys_byte_ring_put_claim() available to the consumer.
+ *
+ * @param ring Address of ring buffer.
+ * @param size Number of bytes written.
+ *
+ * @retval 0 The bytes were committed.
+ * @retval -EINVAL @a size exceeds the free space.
+ */
+int sys_byte_ring_put_commit(struct byte_ring *ring, u32_t size);
+
+/**
+ * @brief Claim stored bytes in a byte ring buffer, for the consumer.
+ *
+ * This routine provides the largest contiguous region of bytes stored in
+ * byte ring buffer @a ring, up to @a size bytes, for the consumer to read
+ * in place. The bytes are released to the producer by
+ * sys_byte_ring_get_commit().
+ *
+ * @param ring Address of ring buffer.
+ * @param data Area to store the address of the region.
+ * @param size Maximum number of bytes wanted.
+ *
+ * @return Size of the region (in bytes), 0 if the ring buffer is empty.
+ */
+u32_t sys_byte_ring_get_claim(struct byte_ring *ring, u8_t **data,
+			      u32_t size);
+
+/**
+ * @brief Release bytes read from a byte ring buffer.
+ *
+ * This routine releases the first @a size bytes of the region claimed by
+ * sys_byte_ring_get_claim() to the producer.
+ *
+ * @param ring Address of ring buffer.
+ * @param size Number of bytes read.
+ *
+ * @retval 0 The bytes were released.
+ * @retval -EINVAL @a size exceeds the bytes stored.
+ */
+int sys_byte_ring_get_commit(struct byte_ring *ring, u32_t size);
+
+/**
+ * @brief Write bytes to a byte ring buffer.
+ *
+ * This routine copies as many bytes of @a data as fit to byte ring buffer
+ * @a ring. It must only be called by the producer.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Address of the bytes to write.
+ * @param size Number of bytes to write.
+ *
+ * @return Number of bytes written.
+ */
+u32_t sys_byte_ring_put(struct byte_ring *ring, const u8_t *data, u32_t size);
+
+/**
+ * @brief Read bytes from a byte ring buffer.
+ *
+ * This routine copies up to @a size bytes from byte ring buffer @a ring.
+ * It must only be called by the consumer.
+ *
+ * @param ring Address of ring buffer.
+ * @param data Area to store the bytes.
+ * @param size Size of the area (in bytes).
+ *
+ * @return Number of bytes read.
+ */
+u32_t sys_byte_ring_get(struct byte_ring *ring, u8_t *data, u32_t size);
+
 /**
  * @}
  */
@@ -7,6 +7,7 @@
 #define _SPINLOCK_H
 
 #include <atomic.h>
+#include <lock_stats.h>
 
 struct k_spinlock_key {
 	int key;
@@ -21,8 +22,13 @@ struct k_spinlock {
 	int saved_key;
 #endif
 #endif
+#ifdef CONFIG_LOCK_STATS
+	struct k_lock_stats stats;
+#endif
 };
 
+#define K_SPINLOCK_INITIALIZER(obj) { _LOCK_STATS_INIT(obj) }
+
 static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 {
 	k_spinlock_key_t k;
@@ -33,19 +39,28 @@ static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 	 */
 	k.key = _arch_irq_lock();
 
+	_LOCK_STATS_START(start);
+
 #ifdef CONFIG_SMP
 # ifdef CONFIG_DEBUG
 	l->saved_key = k.key;
 # endif
-	while (!atomic_cas(&l->locked, 0, 1)) {
+	if (!atomic_cas(&l->locked, 0, 1)) {
+		while (!atomic_cas(&l->locked, 0, 1)) {
+		}
+		_LOCK_STATS_ACQUIRED(l, start, true);
+		return k;
 	}
 #endif
 
+	_LOCK_STATS_ACQUIRED(l, start, false);
 	return k;
 }
 
 static inline void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key)
 {
+	_LOCK_STATS_RELEASED(l);
+
 #ifdef CONFIG_SMP
 # ifdef CONFIG_DEBUG
 	/* This doesn't attempt to catch all mismatches, just spots
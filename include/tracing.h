@@ -114,6 +114,7 @@ void z_sys_trace_thread_switched_in(void);
 
 
 
+#ifndef CONFIG_THREAD_RUNTIME_STATS
 #define z_sys_trace_idle()
 
 #define z_sys_trace_isr_enter()
@@ -121,6 +122,7 @@ void z_sys_trace_thread_switched_in(void);
 #define z_sys_trace_isr_exit_to_scheduler()
 
 #define z_sys_trace_thread_switched_in()
+#endif
 
 #endif
 #endif
@@ -46,6 +46,9 @@
 /* Thread is suspended */
 #define _THREAD_SUSPENDED (BIT(4))
 
+/* Thread is out of EDF budget or waits for its next period */
+#define _THREAD_THROTTLED (BIT(5))
+
 /* Thread is present in the ready queue */
 #define _THREAD_QUEUED (BIT(6))
 
@@ -83,6 +86,24 @@ struct _ready_q {
 
 typedef struct _ready_q _ready_q_t;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+#define _TIMEOUT_WHEEL_BITS 5
+#define _TIMEOUT_WHEEL_SLOTS (1 << _TIMEOUT_WHEEL_BITS)
+
+struct _timeout_wheel {
+	/* tick the wheel has been advanced to */
+	u32_t now;
+
+	/* one bit per non-empty slot, for each level */
+	u32_t bitmap[CONFIG_TIMEOUT_WHEEL_LEVELS];
+
+	sys_dlist_t slots[CONFIG_TIMEOUT_WHEEL_LEVELS][_TIMEOUT_WHEEL_SLOTS];
+
+	/* timeouts expiring beyond the range of the top level */
+	sys_dlist_t overflow;
+};
+#endif
+
 struct _cpu {
 	/* nested interrupt count */
 	u32_t nested;
@@ -102,6 +123,17 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	u8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* preemptible threads ready to run on this CPU */
+	struct _ready_q ready_q;
+
+	/* number of threads in ready_q */
+	u32_t nr_ready;
+
+	/* ticks since this CPU last balanced the run queues */
+	s32_t balance_ticks;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -127,7 +159,7 @@ struct _kernel {
 #endif
 	};
 
-#ifdef CONFIG_SYS_CLOCK_EXISTS
+#if defined(CONFIG_SYS_CLOCK_EXISTS) && !defined(CONFIG_TIMEOUT_QUEUE_WHEEL)
 	/* queue of timeouts */
 	sys_dlist_t timeout_q;
 #endif
@@ -162,6 +194,14 @@ struct _kernel {
 
 	/* arch-specific part of _kernel */
 	struct _kernel_arch arch;
+
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	/*
+	 * timing wheel of timeouts: big, keep it last so that it does not
+	 * push the fields above out of reach of assembly code
+	 */
+	struct _timeout_wheel timeout_wheel;
+#endif
 };
 
 typedef struct _kernel _kernel_t;
@@ -178,6 +218,7 @@ extern struct _kernel _kernel;
 
 #define _ready_q _kernel.ready_q
 #define _timeout_q _kernel.timeout_q
+#define _timeout_wheel _kernel.timeout_wheel
 
 #include <kernel_arch_func.h>
 
@@ -48,6 +48,16 @@ struct k_thread *_find_first_thread_to_unpend(_wait_q_t *wait_q,
 					      struct k_thread *from);
 void idle(void *a, void *b, void *c);
 void z_reset_timeslice(void);
+#ifdef CONFIG_SCHED_EDF
+void _sched_edf_tick(s32_t ticks);
+void _sched_edf_thread_abort(struct k_thread *thread);
+#endif
+#ifdef CONFIG_SCHED_CPU_RUNQ
+void _sched_cpu_runq_balance(s32_t ticks);
+#endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+void _thread_runtime_stats_ready(struct k_thread *thread);
+#endif
 
 /* find which one is the next thread to run */
 /* must be called with interrupts locked */
@@ -76,7 +86,7 @@ static inline int _is_thread_prevented_from_running(struct k_thread *thread)
 	u8_t state = thread->base.thread_state;
 
 	return state & (_THREAD_PENDING | _THREAD_PRESTART | _THREAD_DEAD |
-			_THREAD_DUMMY | _THREAD_SUSPENDED);
+			_THREAD_DUMMY | _THREAD_SUSPENDED | _THREAD_THROTTLED);
 
 }
 
@@ -21,6 +21,19 @@
 extern "C" {
 #endif
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+/* timing wheel backend, see kernel/timeout_wheel.c */
+extern void _timeout_wheel_init(void);
+extern void _timeout_wheel_add(struct _timeout *timeout, s32_t ticks);
+extern void _timeout_wheel_remove(struct _timeout *timeout);
+extern s32_t _timeout_wheel_remaining(struct _timeout *timeout);
+extern s32_t _timeout_wheel_next_expiry(void);
+extern void _timeout_wheel_advance(s32_t ticks, sys_dlist_t *expired);
+#ifdef CONFIG_KERNEL_DEBUG
+extern void _timeout_wheel_dump(void);
+#endif
+#endif
+
 /* initialize the timeouts part of k_thread when enabled in the kernel */
 
 static inline void _init_timeout(struct _timeout *t, _timeout_func_t func)
@@ -123,6 +136,9 @@ static inline int _abort_timeout(struct _timeout *timeout)
 		return _INACTIVE;
 	}
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	_timeout_wheel_remove(timeout);
+#else
 	if (!sys_dlist_is_tail(&_timeout_q, &timeout->node)) {
 		sys_dnode_t *next_node =
 			sys_dlist_peek_next(&_timeout_q, &timeout->node);
@@ -131,6 +147,7 @@ static inline int _abort_timeout(struct _timeout *timeout)
 		next->delta_ticks_from_prev += timeout->delta_ticks_from_prev;
 	}
 	sys_dlist_remove(&timeout->node);
+#endif
 	timeout->delta_ticks_from_prev = _INACTIVE;
 
 	return 0;
@@ -160,7 +177,9 @@ static inline void _dump_timeout(struct _timeout *timeout, int extra_tab)
 
 static inline void _dump_timeout_q(void)
 {
-#ifdef CONFIG_KERNEL_DEBUG
+#if defined(CONFIG_KERNEL_DEBUG) && defined(CONFIG_TIMEOUT_QUEUE_WHEEL)
+	_timeout_wheel_dump();
+#elif defined(CONFIG_KERNEL_DEBUG)
 	struct _timeout *timeout;
 
 	K_DEBUG("_timeout_q: %p, head: %p, tail: %p\n",
@@ -189,6 +208,10 @@ static inline void _dump_timeout_q(void)
  * they were queued. This could be changed at the cost of potential longer
  * interrupt latency.
  *
+ * With CONFIG_TIMEOUT_QUEUE_WHEEL, the timeout is hashed into the timing
+ * wheel in constant time instead, and timeouts expiring on the same tick are
+ * processed in the order they were queued.
+ *
  * Must be called with interrupts locked.
  */
 
@@ -218,7 +241,9 @@ static inline void _add_timeout(struct k_thread *thread,
 	}
 
 	s32_t *delta = &timeout->delta_ticks_from_prev;
+#ifndef CONFIG_TIMEOUT_QUEUE_WHEEL
 	struct _timeout *in_q;
+#endif
 
 #ifdef CONFIG_TICKLESS_KERNEL
 	/*
@@ -236,6 +261,9 @@ static inline void _add_timeout(struct k_thread *thread,
 	}
 	adjusted_timeout = *delta;
 #endif
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	_timeout_wheel_add(timeout, *delta);
+#else
 	SYS_DLIST_FOR_EACH_CONTAINER(&_timeout_q, in_q, node) {
 		if (*delta <= in_q->delta_ticks_from_prev) {
 			in_q->delta_ticks_from_prev -= *delta;
@@ -250,6 +278,7 @@ static inline void _add_timeout(struct k_thread *thread,
 	sys_dlist_append(&_timeout_q, &timeout->node);
 
 inserted:
+#endif
 	K_DEBUG("after adding timeout %p\n", timeout);
 	_dump_timeout(timeout, 0);
 	_dump_timeout_q();
@@ -280,10 +309,18 @@ static inline void _add_thread_timeout(struct k_thread *thread,
 
 static inline s32_t _get_next_timeout_expiry(void)
 {
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+	unsigned int key = irq_lock();
+	s32_t ticks = _timeout_wheel_next_expiry();
+
+	irq_unlock(key);
+	return ticks;
+#else
 	struct _timeout *t = (struct _timeout *)
 			     sys_dlist_peek_head(&_timeout_q);
 
 	return t ? t->delta_ticks_from_prev : K_FOREVER;
+#endif
 }
 
 #ifdef __cplusplus
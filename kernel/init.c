@@ -24,6 +24,7 @@
 #include <init.h>
 #include <linker/linker-defs.h>
 #include <ksched.h>
+#include <wait_q.h>
 #include <version.h>
 #include <string.h>
 #include <misc/dlist.h>
@@ -119,7 +120,11 @@ k_tid_t const _idle_thread3 = (k_tid_t)&_idle_thread3_s;
 K_THREAD_STACK_DEFINE(_interrupt_stack3, CONFIG_ISR_STACK_SIZE);
 #endif
 
-#ifdef CONFIG_SYS_CLOCK_EXISTS
+#if defined(CONFIG_TIMEOUT_QUEUE_WHEEL)
+	#define initialize_timeouts() do { \
+		_timeout_wheel_init(); \
+	} while ((0))
+#elif defined(CONFIG_SYS_CLOCK_EXISTS)
 	#define initialize_timeouts() do { \
 		sys_dlist_init(&_timeout_q); \
 	} while ((0))
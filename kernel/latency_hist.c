@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Latency histograms
+ *
+ * Histograms are updated with atomic operations, from any context and
+ * without locking, so that they can be left enabled in production. The
+ * longest latency is a best effort: concurrent updates may lose one.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <atomic.h>
+#include <misc/printk.h>
+#include <latency_hist.h>
+
+#define NUM_BUCKETS CONFIG_LATENCY_HIST_BUCKETS
+#define NUM_IRQS CONFIG_LATENCY_HIST_NUM_IRQS
+
+struct latency_hist {
+	atomic_t count[NUM_BUCKETS];
+	atomic_t max;
+};
+
+static struct latency_hist irq_hist[NUM_IRQS];
+static struct latency_hist src_hist[K_LATENCY_SRC_NUM];
+
+/* cycle count when entering the interrupt not yet dispatched, or 0 */
+static u32_t isr_start[CONFIG_MP_NUM_CPUS];
+
+/* cycle count when the tick being processed was announced */
+static u32_t tick_start;
+
+static const char * const src_names[K_LATENCY_SRC_NUM] = {
+	[K_LATENCY_SEM_WAKE] = "sem wake",
+	[K_LATENCY_TIMER_EXPIRY] = "timer expiry",
+};
+
+static void hist_add(struct latency_hist *hist, u32_t latency)
+{
+	unsigned int bucket = find_msb_set(latency);
+
+	if (bucket >= NUM_BUCKETS) {
+		bucket = NUM_BUCKETS - 1;
+	}
+
+	atomic_inc(&hist->count[bucket]);
+	if (latency > (u32_t)atomic_get(&hist->max)) {
+		atomic_set(&hist->max, latency);
+	}
+}
+
+static void hist_copy(struct k_latency_hist *dst, struct latency_hist *src)
+{
+	for (int i = 0; i < NUM_BUCKETS; i++) {
+		dst->count[i] = atomic_get(&src->count[i]);
+	}
+	dst->max = atomic_get(&src->max);
+}
+
+void _latency_hist_isr_start(void)
+{
+	isr_start[_current_cpu->id] = k_cycle_get_32();
+}
+
+void _latency_hist_isr_handler(unsigned int irq)
+{
+	u32_t *start = &isr_start[_current_cpu->id];
+
+	/* an interrupt nested before the handler was called consumed the
+	 * start time, leaving nothing to measure
+	 */
+	if (*start == 0 || irq >= NUM_IRQS) {
+		return;
+	}
+
+	hist_add(&irq_hist[irq], k_cycle_get_32() - *start);
+	*start = 0;
+}
+
+void _latency_hist_tick_start(void)
+{
+	tick_start = k_cycle_get_32();
+}
+
+void _latency_hist_timer_expiry(void)
+{
+	_latency_hist_record(K_LATENCY_TIMER_EXPIRY, tick_start);
+}
+
+void _latency_hist_record(enum k_latency_src src, u32_t start)
+{
+	hist_add(&src_hist[src], k_cycle_get_32() - start);
+}
+
+int k_latency_hist_irq_get(unsigned int irq, struct k_latency_hist *hist)
+{
+	if (irq >= NUM_IRQS) {
+		return -EINVAL;
+	}
+
+	hist_copy(hist, &irq_hist[irq]);
+	return 0;
+}
+
+int k_latency_hist_get(enum k_latency_src src, struct k_latency_hist *hist)
+{
+	if ((unsigned int)src >= K_LATENCY_SRC_NUM) {
+		return -EINVAL;
+	}
+
+	hist_copy(hist, &src_hist[src]);
+	return 0;
+}
+
+static void hist_clear(struct latency_hist *hist)
+{
+	for (int i = 0; i < NUM_BUCKETS; i++) {
+		atomic_clear(&hist->count[i]);
+	}
+	atomic_clear(&hist->max);
+}
+
+void k_latency_hist_reset(void)
+{
+	for (int i = 0; i < NUM_IRQS; i++) {
+		hist_clear(&irq_hist[i]);
+	}
+	for (int i = 0; i < K_LATENCY_SRC_NUM; i++) {
+		hist_clear(&src_hist[i]);
+	}
+}
+
+static void hist_dump(const char *name, int irq, struct latency_hist *src)
+{
+	struct k_latency_hist hist;
+	u32_t total = 0;
+	int i;
+
+	hist_copy(&hist, src);
+	for (i = 0; i < NUM_BUCKETS; i++) {
+		total += hist.count[i];
+	}
+
+	if (total == 0) {
+		return;
+	}
+
+	if (name) {
+		printk("%s", name);
+	} else {
+		printk("irq %d", irq);
+	}
+	printk(": %u samples, max %u cycles\n", total, hist.max);
+
+	for (i = 0; i < NUM_BUCKETS; i++) {
+		if (hist.count[i] == 0) {
+			continue;
+		}
+
+		if (i == NUM_BUCKETS - 1) {
+			printk("  >= %10u cycles: %u\n", 1u << (i - 1),
+			       hist.count[i]);
+		} else {
+			printk("  <  %10u cycles: %u\n", 1u << i,
+			       hist.count[i]);
+		}
+	}
+}
+
+void k_latency_hist_dump(void)
+{
+	for (int i = 0; i < NUM_IRQS; i++) {
+		hist_dump(NULL, i, &irq_hist[i]);
+	}
+	for (int i = 0; i < K_LATENCY_SRC_NUM; i++) {
+		hist_dump(src_names[i], 0, &src_hist[i]);
+	}
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock contention statistics
+ *
+ * The statistics of a lock are updated by the lock's holder, under the lock
+ * itself. Locks link themselves in a registry the first time they are
+ * acquired, from any context, so that the registry has its own raw lock
+ * rather than being a k_spinlock. Initializing a mutex, or removing a lock
+ * explicitly, unlinks it.
+ */
+
+#include <kernel.h>
+#include <atomic.h>
+#include <string.h>
+#include <misc/printk.h>
+
+static atomic_t registry_busy;
+static struct k_lock_stats *registry;
+
+/* interrupts register locks too, and must not spin on their own CPU */
+static unsigned int registry_lock(void)
+{
+	unsigned int key = _arch_irq_lock();
+
+	while (!atomic_cas(&registry_busy, 0, 1)) {
+	}
+
+	return key;
+}
+
+static void registry_unlock(unsigned int key)
+{
+	atomic_clear(&registry_busy);
+	_arch_irq_unlock(key);
+}
+
+static void lock_stats_register(struct k_lock_stats *stats)
+{
+	unsigned int key = registry_lock();
+
+	if (!stats->registered) {
+		stats->next = registry;
+		registry = stats;
+		stats->registered = true;
+	}
+
+	registry_unlock(key);
+}
+
+void _lock_stats_remove(struct k_lock_stats *stats)
+{
+	struct k_lock_stats **link;
+	unsigned int key = registry_lock();
+
+	/* the registered flag of a lock being initialized is garbage, the
+	 * registry is searched instead
+	 */
+	for (link = &registry; *link; link = &(*link)->next) {
+		if (*link == stats) {
+			*link = stats->next;
+			break;
+		}
+	}
+
+	stats->registered = false;
+
+	registry_unlock(key);
+}
+
+void _lock_stats_reset(struct k_lock_stats *stats)
+{
+	_lock_stats_remove(stats);
+	memset(stats, 0, sizeof(*stats));
+}
+
+void _lock_stats_acquired(struct k_lock_stats *stats, u32_t start,
+			  bool contended)
+{
+	u32_t now = k_cycle_get_32();
+	u32_t wait = now - start;
+
+	if (unlikely(!stats->registered)) {
+		lock_stats_register(stats);
+	}
+
+	stats->acquisitions++;
+	stats->wait_cycles += wait;
+	if (wait > stats->wait_max) {
+		stats->wait_max = wait;
+	}
+	if (contended) {
+		stats->contended++;
+	}
+
+	stats->hold_start = now;
+}
+
+void _lock_stats_released(struct k_lock_stats *stats)
+{
+	u32_t hold = k_cycle_get_32() - stats->hold_start;
+
+	if (hold > stats->hold_max) {
+		stats->hold_max = hold;
+	}
+}
+
+static u32_t cycles_to_us(u64_t cycles)
+{
+	return (u32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC);
+}
+
+/* whether lock a, waited for wait_a cycles, is listed before lock b */
+static bool ranks_before(struct k_lock_stats *a, u64_t wait_a,
+			 struct k_lock_stats *b, u64_t wait_b)
+{
+	if (wait_a != wait_b) {
+		return wait_a > wait_b;
+	}
+
+	return a > b;
+}
+
+void k_lock_stats_dump(int num)
+{
+	struct k_lock_stats *stats, *next, *prev = NULL;
+	struct k_lock_stats copy;
+	u64_t wait, next_wait = 0, prev_wait = 0;
+	unsigned int key;
+
+	printk("lock                   acquired  contended"
+	       " wait tot us wait max us hold max us\n");
+
+	/* selects the next most waited for lock at each pass, and prints a
+	 * copy of it once the registry is unlocked: locks may be removed
+	 * in between, prev is only compared
+	 */
+	while (num-- > 0) {
+		key = registry_lock();
+
+		next = NULL;
+		for (stats = registry; stats; stats = stats->next) {
+			wait = stats->wait_cycles;
+			if ((!prev || ranks_before(prev, prev_wait,
+						   stats, wait)) &&
+			    (!next || ranks_before(stats, wait,
+						   next, next_wait))) {
+				next = stats;
+				next_wait = wait;
+			}
+		}
+
+		if (next) {
+			copy = *next;
+		}
+
+		registry_unlock(key);
+
+		if (!next) {
+			break;
+		}
+
+		if (copy.name) {
+			printk("%-20s", copy.name);
+		} else {
+			printk("%p          ", next);
+		}
+		printk(" %10u %10u %11u %11u %11u\n", copy.acquisitions,
+		       copy.contended, cycles_to_us(next_wait),
+		       cycles_to_us(copy.wait_max),
+		       cycles_to_us(copy.hold_max));
+
+		prev = next;
+		prev_wait = next_wait;
+	}
+}
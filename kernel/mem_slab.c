@@ -13,6 +13,7 @@
 #include <misc/dlist.h>
 #include <ksched.h>
 #include <init.h>
+#include <string.h>
 
 extern struct k_mem_slab _k_mem_slab_list_start[];
 extern struct k_mem_slab _k_mem_slab_list_end[];
@@ -21,6 +22,27 @@ extern struct k_mem_slab _k_mem_slab_list_end[];
 struct k_mem_slab *_trace_list_k_mem_slab;
 #endif	/* CONFIG_OBJECT_TRACING */
 
+#ifdef CONFIG_MEM_SLAB_LAZY_INIT
+/*
+ * Blocks are carved from the buffer when the free list runs empty, so a
+ * slab only needs its counters cleared, which its static initializer
+ * already does.
+ */
+static void create_free_list(struct k_mem_slab *slab)
+{
+	slab->free_list = NULL;
+	slab->num_carved = 0;
+}
+
+static inline char *carve_block(struct k_mem_slab *slab)
+{
+	if (slab->num_carved == slab->num_blocks) {
+		return NULL;
+	}
+
+	return slab->buffer + slab->block_size * slab->num_carved++;
+}
+#else
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -44,6 +66,31 @@ static void create_free_list(struct k_mem_slab *slab)
 	}
 }
 
+static inline char *carve_block(struct k_mem_slab *slab)
+{
+	return NULL;
+}
+#endif /* CONFIG_MEM_SLAB_LAZY_INIT */
+
+/* takes a free block, called with interrupts locked */
+static inline char *take_block(struct k_mem_slab *slab)
+{
+	char *block = slab->free_list;
+
+	if (block != NULL) {
+		slab->free_list = *(char **)block;
+	} else {
+		block = carve_block(slab);
+		if (block == NULL) {
+			return NULL;
+		}
+	}
+
+	slab->num_used++;
+	return block;
+}
+
+#if !defined(CONFIG_MEM_SLAB_LAZY_INIT) || defined(CONFIG_OBJECT_TRACING)
 /**
  * @brief Complete initialization of statically defined memory slabs.
  *
@@ -60,7 +107,9 @@ static int init_mem_slab_module(struct device *dev)
 	for (slab = _k_mem_slab_list_start;
 	     slab < _k_mem_slab_list_end;
 	     slab++) {
+#ifndef CONFIG_MEM_SLAB_LAZY_INIT
 		create_free_list(slab);
+#endif
 		SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 	}
 	return 0;
@@ -68,6 +117,7 @@ static int init_mem_slab_module(struct device *dev)
 
 SYS_INIT(init_mem_slab_module, PRE_KERNEL_1,
 	 CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+#endif /* !CONFIG_MEM_SLAB_LAZY_INIT || CONFIG_OBJECT_TRACING */
 
 void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 		    size_t block_size, u32_t num_blocks)
@@ -77,30 +127,170 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->buffer = buffer;
 	slab->num_used = 0;
 	create_free_list(slab);
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	memset(slab->magazines, 0, sizeof(slab->magazines));
+	slab->num_waiters = 0;
+#endif
 	_waitq_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 
 	_k_object_init(slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+/*
+ * Each CPU caches up to MAGAZINE_SIZE free blocks of a slab in a magazine.
+ * A CPU takes and puts blocks in its own magazine with only its own
+ * interrupts locked, and the magazine lock, which no other CPU takes on
+ * the fast path. Everything else is done under the global lock, always
+ * taken before a magazine lock: moving half a magazine to or from the slab
+ * free list at once, and taking back the blocks cached by all CPUs when
+ * the free list runs out. Cached blocks are accounted as used in
+ * num_used, k_mem_slab_num_used_get() subtracts them.
+ *
+ * A thread about to wait for a block is counted in num_waiters, under the
+ * global lock, before the magazines are emptied, so that no block freed
+ * on another CPU can be cached while it waits.
+ */
+#define MAGAZINE_SIZE CONFIG_MEM_SLAB_MAGAZINE_SIZE
+#define MAGAZINE_BATCH (MAGAZINE_SIZE / 2)
+
+static inline struct _mem_slab_magazine *local_magazine(struct k_mem_slab *slab)
+{
+	return &slab->magazines[_current_cpu->id];
+}
+
+static inline void magazine_lock(struct _mem_slab_magazine *mag)
+{
+#ifdef CONFIG_SMP
+	while (!atomic_cas(&mag->lock, 0, 1)) {
+	}
+#endif
+}
+
+static inline void magazine_unlock(struct _mem_slab_magazine *mag)
+{
+#ifdef CONFIG_SMP
+	atomic_clear(&mag->lock);
+#endif
+}
+
+/* called with the global lock held and mag locked */
+static void magazine_refill(struct k_mem_slab *slab,
+			    struct _mem_slab_magazine *mag)
+{
+	char *block;
+
+	while (mag->count < MAGAZINE_BATCH) {
+		block = take_block(slab);
+		if (block == NULL) {
+			break;
+		}
+		mag->blocks[mag->count++] = block;
+	}
+}
+
+/* called with the global lock held and mag locked */
+static void magazine_drain(struct k_mem_slab *slab,
+			   struct _mem_slab_magazine *mag, u32_t keep)
+{
+	while (mag->count > keep) {
+		char *block = mag->blocks[--mag->count];
+
+		*(char **)block = slab->free_list;
+		slab->free_list = block;
+		slab->num_used--;
+	}
+}
+
+/* takes the blocks cached by all CPUs, called with the global lock held */
+static void magazines_flush(struct k_mem_slab *slab)
+{
+	struct _mem_slab_magazine *mag;
+	int i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		mag = &slab->magazines[i];
+		magazine_lock(mag);
+		magazine_drain(slab, mag, 0);
+		magazine_unlock(mag);
+	}
+}
+
+/* takes a free block, called with the global lock held */
+static char *take_block_cached(struct k_mem_slab *slab, s32_t timeout)
+{
+	struct _mem_slab_magazine *mag = local_magazine(slab);
+	char *block = NULL;
+
+	magazine_lock(mag);
+	magazine_refill(slab, mag);
+	if (mag->count != 0) {
+		block = mag->blocks[--mag->count];
+	}
+	magazine_unlock(mag);
+
+	if (block != NULL) {
+		return block;
+	}
+
+	/* from now on, frees do not cache blocks if this thread waits */
+	slab->num_waiters++;
+	magazines_flush(slab);
+
+	block = take_block(slab);
+	if (block != NULL || timeout == K_NO_WAIT) {
+		slab->num_waiters--;
+	}
+
+	return block;
+}
+#endif /* CONFIG_MEM_SLAB_MAGAZINE */
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
-	unsigned int key = irq_lock();
+	unsigned int key;
 	int result;
 
-	if (slab->free_list != NULL) {
-		/* take a free block */
-		*mem = slab->free_list;
-		slab->free_list = *(char **)(slab->free_list);
-		slab->num_used++;
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	struct _mem_slab_magazine *mag;
+
+	key = _arch_irq_lock();
+	mag = local_magazine(slab);
+	magazine_lock(mag);
+
+	if (mag->count != 0) {
+		*mem = mag->blocks[--mag->count];
+		magazine_unlock(mag);
+		_arch_irq_unlock(key);
+		return 0;
+	}
+
+	magazine_unlock(mag);
+	_arch_irq_unlock(key);
+
+	key = irq_lock();
+
+	*mem = take_block_cached(slab, timeout);
+#else
+	key = irq_lock();
+
+	*mem = take_block(slab);
+#endif
+	if (*mem != NULL) {
+		/* took a free block */
 		result = 0;
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
-		*mem = NULL;
 		result = -ENOMEM;
 	} else {
 		/* wait for a free block or timeout */
 		result = _pend_current_thread(key, &slab->wait_q, timeout);
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+		key = irq_lock();
+		slab->num_waiters--;
+		irq_unlock(key);
+#endif
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
@@ -114,14 +304,44 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
-	int key = irq_lock();
-	struct k_thread *pending_thread = _unpend_first_thread(&slab->wait_q);
+	int key;
+	struct k_thread *pending_thread;
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	struct _mem_slab_magazine *mag;
+
+	key = _arch_irq_lock();
+	mag = local_magazine(slab);
+	magazine_lock(mag);
+
+	/* waiting threads and full magazines are served from the slow path */
+	if (slab->num_waiters == 0 && mag->count < MAGAZINE_SIZE) {
+		mag->blocks[mag->count++] = *mem;
+		magazine_unlock(mag);
+		_arch_irq_unlock(key);
+		return;
+	}
+
+	magazine_unlock(mag);
+	_arch_irq_unlock(key);
+#endif
+
+	key = irq_lock();
+	pending_thread = _unpend_first_thread(&slab->wait_q);
 
 	if (pending_thread) {
 		_set_thread_return_value_with_data(pending_thread, 0, *mem);
 		_ready_thread(pending_thread);
 		_reschedule(key);
 	} else {
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+		mag = local_magazine(slab);
+		magazine_lock(mag);
+		if (mag->count == MAGAZINE_SIZE) {
+			magazine_drain(slab, mag, MAGAZINE_BATCH);
+		}
+		magazine_unlock(mag);
+#endif
 		**(char ***)mem = slab->free_list;
 		slab->free_list = *(char **)mem;
 		slab->num_used--;
@@ -10,6 +10,9 @@
 #include <init.h>
 #include <string.h>
 #include <misc/__assert.h>
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+#include <misc/tlsf.h>
+#endif
 
 /* Linker-defined symbols bound the static pool structs */
 extern struct k_mem_pool _k_mem_pool_list_start[];
@@ -154,8 +157,45 @@ void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
 	return (char *)block.data + sizeof(struct k_mem_block_id);
 }
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+
+BUILD_ASSERT_MSG(CONFIG_HEAP_MEM_POOL_SIZE <= BIT(CONFIG_TLSF_FL_INDEX_MAX),
+		 "heap larger than the TLSF block size limit");
+
+static char __aligned(sizeof(void *)) heap_buf[CONFIG_HEAP_MEM_POOL_SIZE];
+static struct sys_tlsf heap;
+
+static int init_heap(struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	return sys_tlsf_init(&heap, heap_buf, sizeof(heap_buf));
+}
+
+SYS_INIT(init_heap, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+void k_malloc_stats_get(struct sys_tlsf_stats *stats)
+{
+	unsigned int key = irq_lock();
+
+	sys_tlsf_stats_get(&heap, stats);
+	irq_unlock(key);
+}
+
+#endif /* CONFIG_HEAP_MEM_POOL_TLSF */
+
 void k_free(void *ptr)
 {
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+	if (ptr != NULL && sys_tlsf_contains(&heap, ptr)) {
+		unsigned int key = irq_lock();
+
+		sys_tlsf_free(&heap, ptr);
+		irq_unlock(key);
+		return;
+	}
+#endif
+
 	if (ptr != NULL) {
 		/* point to hidden block descriptor at start of block */
 		ptr = (char *)ptr - sizeof(struct k_mem_block_id);
@@ -174,6 +214,26 @@ void k_free(void *ptr)
  * that has the address of the associated memory pool struct.
  */
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+
+/*
+ * Identifies the heap as the resource pool of threads, see
+ * z_thread_malloc(), it is never initialized nor allocated from.
+ */
+static struct k_mem_pool _heap_mem_pool;
+#define _HEAP_MEM_POOL (&_heap_mem_pool)
+
+void *k_malloc(size_t size)
+{
+	unsigned int key = irq_lock();
+	void *ret = sys_tlsf_alloc(&heap, size);
+
+	irq_unlock(key);
+	return ret;
+}
+
+#else
+
 K_MEM_POOL_DEFINE(_heap_mem_pool, 64, CONFIG_HEAP_MEM_POOL_SIZE, 1, 4);
 #define _HEAP_MEM_POOL (&_heap_mem_pool)
 
@@ -182,6 +242,8 @@ void *k_malloc(size_t size)
 	return k_mem_pool_malloc(_HEAP_MEM_POOL, size);
 }
 
+#endif /* CONFIG_HEAP_MEM_POOL_TLSF */
+
 void *k_calloc(size_t nmemb, size_t size)
 {
 	void *ret;
@@ -208,6 +270,12 @@ void *z_thread_malloc(size_t size)
 {
 	void *ret;
 
+#ifdef CONFIG_HEAP_MEM_POOL_TLSF
+	if (_current->resource_pool == _HEAP_MEM_POOL) {
+		return k_malloc(size);
+	}
+#endif
+
 	if (_current->resource_pool) {
 		ret = k_mem_pool_malloc(_current->resource_pool, size);
 	} else {
@@ -245,6 +245,208 @@ Z_SYSCALL_HANDLER(k_msgq_get, msgq_p, data, timeout)
 }
 #endif
 
+/* copy messages into the ring buffer, the caller checked there is room */
+static void ring_put(struct k_msgq *q, const char *data, u32_t num_msgs)
+{
+	size_t len = num_msgs * q->msg_size;
+	size_t run = min(len, (size_t)(q->buffer_end - q->write_ptr));
+
+	(void)memcpy(q->write_ptr, data, run);
+	if (run < len) {
+		(void)memcpy(q->buffer_start, data + run, len - run);
+		q->write_ptr = q->buffer_start + (len - run);
+	} else {
+		q->write_ptr += len;
+		if (q->write_ptr == q->buffer_end) {
+			q->write_ptr = q->buffer_start;
+		}
+	}
+	q->used_msgs += num_msgs;
+}
+
+/* copy messages out of the ring buffer, or drop them if data is NULL */
+static void ring_get(struct k_msgq *q, char *data, u32_t num_msgs)
+{
+	size_t len = num_msgs * q->msg_size;
+	size_t run = min(len, (size_t)(q->buffer_end - q->read_ptr));
+
+	if (data != NULL) {
+		(void)memcpy(data, q->read_ptr, run);
+	}
+	if (run < len) {
+		if (data != NULL) {
+			(void)memcpy(data + run, q->buffer_start, len - run);
+		}
+		q->read_ptr = q->buffer_start + (len - run);
+	} else {
+		q->read_ptr += len;
+		if (q->read_ptr == q->buffer_end) {
+			q->read_ptr = q->buffer_start;
+		}
+	}
+	q->used_msgs -= num_msgs;
+}
+
+int _impl_k_msgq_put_n(struct k_msgq *q, void *data, u32_t num_msgs,
+		       s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	unsigned int key = irq_lock();
+	struct k_thread *pending_thread;
+	char *msg = data;
+	u32_t sent = 0, room;
+	int woken = 0;
+	int result;
+
+	/* receivers only wait on an empty queue: hand them messages first */
+	while (sent < num_msgs && q->used_msgs == 0) {
+		pending_thread = _unpend_first_thread(&q->wait_q);
+		if (!pending_thread) {
+			break;
+		}
+
+		(void)memcpy(pending_thread->base.swap_data, msg, q->msg_size);
+		_set_thread_return_value(pending_thread, 0);
+		_ready_thread(pending_thread);
+		msg += q->msg_size;
+		sent++;
+		woken = 1;
+	}
+
+	room = min(num_msgs - sent, q->max_msgs - q->used_msgs);
+	ring_put(q, msg, room);
+	sent += room;
+
+	if (sent == 0 && num_msgs != 0) {
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -ENOMSG;
+		}
+
+		/* wait for the first message to be put, like k_msgq_put() */
+		_current->base.swap_data = data;
+		result = _pend_current_thread(key, &q->wait_q, timeout);
+		return result ? result : 1;
+	}
+
+	if (woken) {
+		_reschedule(key);
+	} else {
+		irq_unlock(key);
+	}
+
+	return sent;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_put_n, msgq_p, data, num_msgs, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_READ(data, num_msgs, q->msg_size));
+
+	return _impl_k_msgq_put_n(q, (void *)data, num_msgs, timeout);
+}
+#endif
+
+int _impl_k_msgq_get_n(struct k_msgq *q, void *data, u32_t num_msgs,
+		       s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+	__ASSERT(data != NULL || timeout == K_NO_WAIT, "");
+
+	unsigned int key = irq_lock();
+	struct k_thread *pending_thread;
+	u32_t received = min(num_msgs, q->used_msgs);
+	int woken = 0;
+	int result;
+
+	ring_get(q, data, received);
+
+	/*
+	 * Senders only wait on a full queue: refill the released slots
+	 * with their messages.
+	 */
+	while (received != 0 && q->used_msgs < q->max_msgs) {
+		pending_thread = _unpend_first_thread(&q->wait_q);
+		if (!pending_thread) {
+			break;
+		}
+
+		ring_put(q, pending_thread->base.swap_data, 1);
+		_set_thread_return_value(pending_thread, 0);
+		_ready_thread(pending_thread);
+		woken = 1;
+	}
+
+	if (received == 0 && num_msgs != 0) {
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -ENOMSG;
+		}
+
+		/* wait for a single message, like k_msgq_get() */
+		_current->base.swap_data = data;
+		result = _pend_current_thread(key, &q->wait_q, timeout);
+		return result ? result : 1;
+	}
+
+	if (woken) {
+		_reschedule(key);
+	} else {
+		irq_unlock(key);
+	}
+
+	return received;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_get_n, msgq_p, data, num_msgs, timeout)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	if (data != 0) {
+		Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(data, num_msgs,
+						    q->msg_size));
+	} else {
+		Z_OOPS(Z_SYSCALL_VERIFY_MSG(timeout == K_NO_WAIT,
+					    "cannot wait without a buffer"));
+	}
+
+	return _impl_k_msgq_get_n(q, (void *)data, num_msgs, timeout);
+}
+#endif
+
+u32_t _impl_k_msgq_peek_n(struct k_msgq *q, void **data, u32_t num_msgs)
+{
+	unsigned int key = irq_lock();
+	u32_t run = (q->buffer_end - q->read_ptr) / q->msg_size;
+
+	*data = q->read_ptr;
+	num_msgs = min(num_msgs, min(run, q->used_msgs));
+
+	irq_unlock(key);
+
+	return num_msgs;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_msgq_peek_n, msgq_p, data, num_msgs)
+{
+	struct k_msgq *q = (struct k_msgq *)msgq_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(data, sizeof(void *)));
+	Z_OOPS(Z_SYSCALL_MEMORY_READ(q->buffer_start,
+				     q->buffer_end - q->buffer_start));
+
+	return _impl_k_msgq_peek_n(q, (void **)data, num_msgs);
+}
+#endif
+
 void _impl_k_msgq_purge(struct k_msgq *q)
 {
 	unsigned int key = irq_lock();
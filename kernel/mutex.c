@@ -72,6 +72,7 @@ void _impl_k_mutex_init(struct k_mutex *mutex)
 {
 	mutex->owner = NULL;
 	mutex->lock_count = 0;
+	_LOCK_STATS_RESET(mutex);
 
 	sys_trace_void(SYS_TRACE_ID_MUTEX_INIT);
 
@@ -123,6 +124,8 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 	int new_prio;
 	unsigned int key;
 
+	_LOCK_STATS_START(wait_start);
+
 	sys_trace_void(SYS_TRACE_ID_MUTEX_LOCK);
 	_sched_lock();
 
@@ -130,6 +133,10 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 
 		RECORD_STATE_CHANGE();
 
+		if (mutex->lock_count == 0) {
+			_LOCK_STATS_ACQUIRED(mutex, wait_start, false);
+		}
+
 		mutex->owner_orig_prio = mutex->lock_count == 0 ?
 					_current->base.prio :
 					mutex->owner_orig_prio;
@@ -174,6 +181,7 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 		got_mutex ? 'y' : 'n');
 
 	if (got_mutex == 0) {
+		_LOCK_STATS_ACQUIRED(mutex, wait_start, true);
 		k_sched_unlock();
 		sys_trace_end_call(SYS_TRACE_ID_MUTEX_LOCK);
 		return 0;
@@ -230,6 +238,8 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 		return;
 	}
 
+	_LOCK_STATS_RELEASED(mutex);
+
 	key = irq_lock();
 
 	adjust_owner_prio(mutex, mutex->owner_orig_prio);
@@ -272,3 +282,165 @@ Z_SYSCALL_HANDLER(k_mutex_unlock, mutex)
 	return 0;
 }
 #endif
+
+/*
+ * User mutexes are locked in user mode by setting their lock word to the
+ * owner thread. The first thread finding one locked makes the kernel mutex
+ * backing it track the owner, and flags the lock word so that the owner
+ * comes here to unlock it: from then on, ownership is handed over by the
+ * kernel mutex, and the lock word follows it.
+ */
+static struct k_thread *umutex_owner(atomic_val_t val)
+{
+	struct k_thread *thread = (struct k_thread *)
+		(val & ~(atomic_val_t)_K_UMUTEX_CONTENDED);
+
+#ifdef CONFIG_USERSPACE
+	/* the lock word is in user memory: a user thread could otherwise
+	 * forge it to raise the priority of any thread
+	 */
+	struct _k_object *ko = _k_object_find(thread);
+
+	if (_current->base.user_options & K_USER) {
+		if (_k_object_validate(ko, K_OBJ_THREAD, _OBJ_INIT_TRUE)) {
+			return NULL;
+		}
+	} else if (!ko || ko->type != K_OBJ_THREAD ||
+		   !(ko->flags & K_OBJ_FLAG_INITIALIZED)) {
+		return NULL;
+	}
+#endif
+
+	return thread;
+}
+
+static int umutex_lock(atomic_t *word, struct k_mutex *mutex, s32_t timeout)
+{
+	unsigned int key = irq_lock();
+	struct k_thread *owner;
+	atomic_val_t val;
+	int ret;
+
+	while (1) {
+		val = atomic_get(word);
+
+		if (val == 0) {
+			if (atomic_cas(word, 0, (atomic_val_t)_current)) {
+				irq_unlock(key);
+				return 0;
+			}
+			continue;
+		}
+
+		if (val & _K_UMUTEX_CONTENDED) {
+			owner = mutex->owner;
+			break;
+		}
+
+		owner = umutex_owner(val);
+		if (!owner || owner == _current) {
+			break;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -EBUSY;
+		}
+
+		if (atomic_cas(word, val, val | _K_UMUTEX_CONTENDED)) {
+			/* take over the ownership from user mode */
+			mutex->owner = owner;
+			mutex->lock_count = 1;
+			mutex->owner_orig_prio = owner->base.prio;
+			_LOCK_STATS_ACQUIRED(mutex, k_cycle_get_32(), false);
+			break;
+		}
+	}
+
+	if (!owner || owner == _current) {
+		irq_unlock(key);
+		return owner ? -EDEADLK : -EINVAL;
+	}
+
+	/* Stay locked until pending on the kernel mutex: if the owner could
+	 * unlock in between, the lock word would go back to the user mode
+	 * fast path while the kernel mutex is free for this thread to take,
+	 * and both would own the mutex.
+	 */
+	ret = _impl_k_mutex_lock(mutex, timeout);
+	if (ret == 0) {
+		atomic_set(word, (atomic_val_t)_current | _K_UMUTEX_CONTENDED);
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+static int umutex_unlock(atomic_t *word, struct k_mutex *mutex)
+{
+	atomic_val_t val = (atomic_val_t)_current | _K_UMUTEX_CONTENDED;
+	struct k_thread *new_owner;
+	unsigned int key;
+
+	/* only unlocked in user mode while uncontended */
+	if (atomic_get(word) != val) {
+		return -EPERM;
+	}
+
+	/* the new owner must not run before the lock word is updated */
+	_sched_lock();
+	key = irq_lock();
+
+	if (mutex->owner != _current) {
+		irq_unlock(key);
+		k_sched_unlock();
+		return -EPERM;
+	}
+
+	_impl_k_mutex_unlock(mutex);
+	new_owner = mutex->owner;
+	atomic_set(word, new_owner ?
+		   (atomic_val_t)new_owner | _K_UMUTEX_CONTENDED : 0);
+
+	irq_unlock(key);
+	k_sched_unlock();
+
+	return 0;
+}
+
+int _impl_k_umutex_lock_contended(struct k_umutex *umutex, s32_t timeout)
+{
+	return umutex_lock(&umutex->val, umutex->mutex, timeout);
+}
+
+int _impl_k_umutex_unlock_contended(struct k_umutex *umutex)
+{
+	return umutex_unlock(&umutex->val, umutex->mutex);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_umutex_lock_contended, umutex_p, timeout)
+{
+	struct k_umutex *umutex = (struct k_umutex *)umutex_p;
+	struct k_mutex *mutex;
+
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(umutex, sizeof(*umutex)));
+	mutex = umutex->mutex;
+	Z_OOPS(Z_SYSCALL_OBJ(mutex, K_OBJ_MUTEX));
+
+	return umutex_lock(&umutex->val, mutex, (s32_t)timeout);
+}
+
+Z_SYSCALL_HANDLER(k_umutex_unlock_contended, umutex_p)
+{
+	struct k_umutex *umutex = (struct k_umutex *)umutex_p;
+	struct k_mutex *mutex;
+
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(umutex, sizeof(*umutex)));
+	mutex = umutex->mutex;
+	Z_OOPS(Z_SYSCALL_OBJ(mutex, K_OBJ_MUTEX));
+
+	return umutex_unlock(&umutex->val, mutex);
+}
+#endif
@@ -765,6 +765,234 @@ Z_SYSCALL_HANDLER(k_pipe_put, pipe, data, bytes_to_write, bytes_written_p,
 }
 #endif
 
+/**
+ * @brief Wait for a pipe's buffer to leave its full or empty state
+ *
+ * The waiting thread has nothing to transfer: the threads copying data from
+ * or to the pipe wake it up like a satisfied request, after which it checks
+ * the buffer again. Threads queued behind it may have been served first and
+ * brought the buffer back to the same state, in which case it waits again
+ * for the rest of its timeout.
+ *
+ * @return 0 if the buffer is no longer full (or empty), -EAGAIN otherwise
+ */
+static int pipe_claim_wait(struct k_pipe *pipe, _wait_q_t *wait_q,
+			   size_t blocked_used, s32_t timeout)
+{
+	struct k_pipe_desc  pipe_desc;
+	unsigned int  key;
+	s64_t  end = 0;
+
+	if (timeout > 0) {
+		end = k_uptime_get() + timeout;
+	}
+
+	while (1) {
+		key = irq_lock();
+
+		if (pipe->bytes_used != blocked_used) {
+			irq_unlock(key);
+			return 0;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -EAGAIN;
+		}
+
+		pipe_desc.buffer        = NULL;
+		pipe_desc.bytes_to_xfer = 0;
+		_current->base.swap_data = &pipe_desc;
+		_pend_current_thread(key, wait_q, timeout);
+
+		if (timeout != K_FOREVER) {
+			timeout = max(end - k_uptime_get(), 0);
+		}
+	}
+}
+
+/**
+ * @brief Copy data from the pipe's circular buffer to the waiting readers
+ *
+ * Readers only wait on an empty buffer, so that data just committed to the
+ * buffer belongs to them first. Must be called with the scheduler locked.
+ *
+ * @return N/A
+ */
+static void pipe_readers_fill(struct k_pipe *pipe)
+{
+	struct k_thread    *reader;
+	struct k_pipe_desc *desc;
+	unsigned int   key = irq_lock();
+	size_t         bytes_copied;
+	bool           satisfied;
+
+	while (pipe->bytes_used != 0 &&
+	       (reader = _waitq_head(&pipe->wait_q.readers))) {
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		satisfied = desc->bytes_to_xfer <= pipe->bytes_used;
+		if (satisfied) {
+			_unpend_thread(reader);
+		}
+		irq_unlock(key);
+
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (!satisfied) {
+			return;
+		}
+
+		pipe_thread_ready(reader);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+}
+
+/**
+ * @brief Copy data from the waiting writers to the pipe's circular buffer
+ *
+ * Writers only wait on a full buffer, so that space just released in the
+ * buffer belongs to them first. Must be called with the scheduler locked.
+ *
+ * @return N/A
+ */
+static void pipe_writers_drain(struct k_pipe *pipe)
+{
+	struct k_thread    *writer;
+	struct k_pipe_desc *desc;
+	unsigned int   key = irq_lock();
+	size_t         bytes_copied;
+	bool           satisfied;
+
+	while (pipe->bytes_used != pipe->size &&
+	       (writer = _waitq_head(&pipe->wait_q.writers))) {
+		desc = (struct k_pipe_desc *)writer->base.swap_data;
+		satisfied = desc->bytes_to_xfer <=
+			    pipe->size - pipe->bytes_used;
+		if (satisfied) {
+			_unpend_thread(writer);
+		}
+		irq_unlock(key);
+
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (!satisfied) {
+			return;
+		}
+
+		pipe_thread_ready(writer);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+}
+
+int k_pipe_put_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     s32_t timeout)
+{
+	size_t  run_length;
+	int     rc;
+
+	__ASSERT(data != NULL, "");
+
+	if (pipe->size == 0 || *size == 0) {
+		return -EINVAL;
+	}
+
+	rc = pipe_claim_wait(pipe, &pipe->wait_q.writers, pipe->size,
+			     timeout);
+	if (rc != 0) {
+		*size = 0;
+		return rc;
+	}
+
+	run_length = min(pipe->size - pipe->bytes_used,
+			 pipe->size - pipe->write_index);
+
+	*data = pipe->buffer + pipe->write_index;
+	*size = min(*size, run_length);
+
+	return 0;
+}
+
+int k_pipe_put_commit(struct k_pipe *pipe, size_t size)
+{
+	if (size > min(pipe->size - pipe->bytes_used,
+		       pipe->size - pipe->write_index)) {
+		return -EINVAL;
+	}
+
+	_sched_lock();
+
+	pipe->bytes_used  += size;
+	pipe->write_index += size;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	pipe_readers_fill(pipe);
+
+	k_sched_unlock();
+
+	return 0;
+}
+
+int k_pipe_get_claim(struct k_pipe *pipe, void **data, size_t *size,
+		     s32_t timeout)
+{
+	size_t  run_length;
+	int     rc;
+
+	__ASSERT(data != NULL, "");
+
+	if (pipe->size == 0 || *size == 0) {
+		return -EINVAL;
+	}
+
+	rc = pipe_claim_wait(pipe, &pipe->wait_q.readers, 0, timeout);
+	if (rc != 0) {
+		*size = 0;
+		return rc;
+	}
+
+	run_length = min(pipe->bytes_used, pipe->size - pipe->read_index);
+
+	*data = pipe->buffer + pipe->read_index;
+	*size = min(*size, run_length);
+
+	return 0;
+}
+
+int k_pipe_get_commit(struct k_pipe *pipe, size_t size)
+{
+	if (size > min(pipe->bytes_used, pipe->size - pipe->read_index)) {
+		return -EINVAL;
+	}
+
+	_sched_lock();
+
+	pipe->bytes_used -= size;
+	pipe->read_index += size;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	pipe_writers_drain(pipe);
+
+	k_sched_unlock();
+
+	return 0;
+}
+
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 		      size_t bytes_to_write, struct k_sem *sem)
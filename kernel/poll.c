@@ -73,21 +73,29 @@ static inline int is_condition_met(struct k_poll_event *event, u32_t *state)
 	return 0;
 }
 
+/* poll sets have no thread, they come after the threads polling directly */
+static inline int is_poller_higher(struct _poller *p1, struct _poller *p2)
+{
+	if (!p1->thread || !p2->thread) {
+		return p1->thread != NULL;
+	}
+
+	return _is_t1_higher_prio_than_t2(p1->thread, p2->thread);
+}
+
 static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 			     struct _poller *poller)
 {
 	struct k_poll_event *pending;
 
 	pending = (struct k_poll_event *)sys_dlist_peek_tail(events);
-	if (!pending || _is_t1_higher_prio_than_t2(pending->poller->thread,
-						   poller->thread)) {
+	if (!pending || is_poller_higher(pending->poller, poller)) {
 		sys_dlist_append(events, &event->_node);
 		return;
 	}
 
 	SYS_DLIST_FOR_EACH_CONTAINER(events, pending, _node) {
-		if (_is_t1_higher_prio_than_t2(poller->thread,
-					       pending->poller->thread)) {
+		if (is_poller_higher(poller, pending->poller)) {
 			sys_dlist_insert_before(events, &pending->_node,
 						&event->_node);
 			return;
@@ -314,6 +322,127 @@ oops_free:
 }
 #endif
 
+/* must be called with interrupts locked */
+static void poll_set_event_ready(struct k_poll_set *set,
+				 struct k_poll_event *event, u32_t state)
+{
+	struct k_thread *thread;
+
+	event->state |= state;
+	sys_dlist_append(&set->ready, &event->_node);
+
+	thread = _unpend_first_thread(&set->wait_q);
+	if (thread) {
+		_set_thread_return_value(thread, 0);
+		_ready_thread(thread);
+	}
+}
+
+/* must be called with interrupts locked */
+static void poll_set_arm(struct k_poll_set *set, struct k_poll_event *event)
+{
+	u32_t state;
+
+	event->state = K_POLL_STATE_NOT_READY;
+	event->poller = &set->poller;
+
+	if (is_condition_met(event, &state)) {
+		poll_set_event_ready(set, event, state);
+	} else {
+		register_event(event, &set->poller);
+	}
+}
+
+void k_poll_set_init(struct k_poll_set *set)
+{
+	set->poller.thread = NULL;
+	set->poller.is_polling = 1;
+	sys_dlist_init(&set->ready);
+	sys_dlist_init(&set->returned);
+	_waitq_init(&set->wait_q);
+}
+
+int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event)
+{
+	unsigned int key;
+
+	if (event->type == K_POLL_TYPE_IGNORE) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (event->poller) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	poll_set_arm(set, event);
+
+	_reschedule(key);
+	return 0;
+}
+
+int k_poll_set_remove(struct k_poll_set *set, struct k_poll_event *event)
+{
+	unsigned int key = irq_lock();
+
+	if (event->poller != &set->poller) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	/* the event is either registered, ready or returned */
+	sys_dlist_remove(&event->_node);
+	event->poller = NULL;
+
+	irq_unlock(key);
+	return 0;
+}
+
+int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **events,
+		    int num_events, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(events, "NULL events\n");
+	__ASSERT(num_events > 0, "zero events\n");
+
+	struct k_poll_event *event;
+	unsigned int key = irq_lock();
+	int num = 0, rc;
+
+	/* level-triggered: check again the events returned last time */
+	while ((event = (struct k_poll_event *)
+			sys_dlist_get(&set->returned)) != NULL) {
+		poll_set_arm(set, event);
+		irq_unlock(key);
+		key = irq_lock();
+	}
+
+	if (sys_dlist_is_empty(&set->ready)) {
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -EAGAIN;
+		}
+
+		rc = _pend_current_thread(key, &set->wait_q, timeout);
+		if (rc != 0) {
+			return rc;
+		}
+
+		key = irq_lock();
+	}
+
+	while (num < num_events && (event = (struct k_poll_event *)
+				    sys_dlist_get(&set->ready)) != NULL) {
+		sys_dlist_append(&set->returned, &event->_node);
+		events[num++] = event;
+	}
+
+	irq_unlock(key);
+	return num;
+}
+
 /* must be called with interrupts locked */
 static int signal_poll_event(struct k_poll_event *event, u32_t state)
 {
@@ -321,6 +450,13 @@ static int signal_poll_event(struct k_poll_event *event, u32_t state)
 		goto ready_event;
 	}
 
+	if (!event->poller->thread) {
+		poll_set_event_ready(CONTAINER_OF(event->poller,
+						  struct k_poll_set, poller),
+				     event, state);
+		return 0;
+	}
+
 	struct k_thread *thread = event->poller->thread;
 
 	__ASSERT(event->poller->thread, "poller should have a thread\n");
@@ -39,13 +39,18 @@
 /* the only struct _kernel instance */
 struct _kernel _kernel;
 
-static struct k_spinlock sched_lock;
+static struct k_spinlock sched_lock = K_SPINLOCK_INITIALIZER(sched_lock);
 
 #define LOCKED(lck) for (k_spinlock_key_t __i = {},			\
 					  __key = k_spin_lock(lck);	\
 			!__i.key;					\
 			k_spin_unlock(lck, __key), __i.key = 1)
 
+/* Keeps the caller on its CPU, without taking any lock */
+#define LOCAL_LOCKED for (unsigned int __i = 0, __key = _arch_irq_lock(); \
+			  !__i;						  \
+			  _arch_irq_unlock(__key), __i = 1)
+
 static inline int _is_preempt(struct k_thread *thread)
 {
 #ifdef CONFIG_PREEMPT_ENABLED
@@ -141,6 +146,307 @@ static int should_preempt(struct k_thread *th, int preempt_ok)
 	return 0;
 }
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Preemptible threads are spread over per-CPU run queues, each under
+ * its own lock, a queued thread sitting in the run queue of CPU
+ * base.cpu.  Cooperative threads, meta-IRQ threads included, stay in
+ * the shared _kernel.ready_q under sched_lock: every CPU picks the best
+ * of them before its own threads, so their priority order holds across
+ * all CPUs.
+ *
+ * Locks nest in the order sched_lock, then a single per-CPU lock.  The
+ * load balancer alone takes two per-CPU locks, in CPU index order, and
+ * never sched_lock.
+ */
+static struct k_spinlock cpu_runq_lock[CONFIG_MP_NUM_CPUS] = {
+	[0 ... CONFIG_MP_NUM_CPUS - 1] = K_SPINLOCK_INITIALIZER(cpu_runq_lock)
+};
+
+/* number of threads in the shared run queue, read without locking */
+static atomic_t shared_nr_ready;
+
+#define CPU_MASK_ALL ((u32_t)~0 >> (32 - CONFIG_MP_NUM_CPUS))
+
+static inline int in_shared_runq(struct k_thread *thread)
+{
+	return thread->base.prio < 0;
+}
+
+static inline int cpu_allowed(struct k_thread *thread, int cpu)
+{
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+}
+
+/* best thread of a run queue that is allowed to run on a CPU */
+static struct k_thread *runq_best(_ready_q_t *rq, int cpu)
+{
+	struct k_thread *th = _priq_run_best(&rq->runq);
+
+	if (!th || cpu_allowed(th, cpu)) {
+		return th;
+	}
+
+#if defined(CONFIG_SCHED_DUMB)
+	SYS_DLIST_FOR_EACH_CONTAINER(&rq->runq, th, base.qnode_dlist) {
+		if (cpu_allowed(th, cpu)) {
+			return th;
+		}
+	}
+#elif defined(CONFIG_SCHED_SCALABLE)
+	RB_FOR_EACH_CONTAINER(&rq->runq.tree, th, base.qnode_rb) {
+		if (cpu_allowed(th, cpu)) {
+			return th;
+		}
+	}
+#elif defined(CONFIG_SCHED_MULTIQ)
+	for (u32_t bits = rq->runq.bitmask; bits; bits &= bits - 1) {
+		sys_dlist_t *l = &rq->runq.queues[__builtin_ctz(bits)];
+
+		SYS_DLIST_FOR_EACH_CONTAINER(l, th, base.qnode_dlist) {
+			if (cpu_allowed(th, cpu)) {
+				return th;
+			}
+		}
+	}
+#endif
+
+	return NULL;
+}
+
+static void shared_runq_insert(struct k_thread *thread)
+{
+	_priq_run_add(&_kernel.ready_q.runq, thread);
+	_mark_thread_as_queued(thread);
+	atomic_inc(&shared_nr_ready);
+}
+
+static void shared_runq_extract(struct k_thread *thread)
+{
+	_priq_run_remove(&_kernel.ready_q.runq, thread);
+	_mark_thread_as_not_queued(thread);
+	atomic_dec(&shared_nr_ready);
+}
+
+static void cpu_runq_insert(struct _cpu *cpu, struct k_thread *thread)
+{
+	thread->base.cpu = cpu->id;
+	_priq_run_add(&cpu->ready_q.runq, thread);
+	_mark_thread_as_queued(thread);
+	cpu->nr_ready++;
+}
+
+static void cpu_runq_extract(struct _cpu *cpu, struct k_thread *thread)
+{
+	_priq_run_remove(&cpu->ready_q.runq, thread);
+	_mark_thread_as_not_queued(thread);
+	cpu->nr_ready--;
+}
+
+/* Lock the run queue of the CPU a thread was last queued on, which
+ * other CPUs may change until we hold the lock.
+ */
+static struct _cpu *cpu_runq_lock_thread(struct k_thread *thread,
+					 k_spinlock_key_t *key)
+{
+	while (1) {
+		int id = thread->base.cpu;
+
+		*key = k_spin_lock(&cpu_runq_lock[id]);
+		if (thread->base.cpu == id) {
+			return &_kernel.cpus[id];
+		}
+		k_spin_unlock(&cpu_runq_lock[id], *key);
+	}
+}
+
+/* The running thread stays on its CPU, others go back to the CPU they
+ * last ran on unless an allowed CPU has a clearly shorter run queue.
+ */
+static struct _cpu *runq_pick_cpu(struct k_thread *thread)
+{
+	struct _cpu *best = NULL;
+	int i;
+
+	if (thread == _current && cpu_allowed(thread, _current_cpu->id)) {
+		return _current_cpu;
+	}
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+
+		if (cpu_allowed(thread, i) &&
+		    (!best || cpu->nr_ready < best->nr_ready)) {
+			best = cpu;
+		}
+	}
+
+	if (cpu_allowed(thread, thread->base.cpu) &&
+	    _kernel.cpus[thread->base.cpu].nr_ready <= best->nr_ready + 1) {
+		return &_kernel.cpus[thread->base.cpu];
+	}
+
+	return best;
+}
+
+static void runq_add(struct k_thread *thread)
+{
+	if (in_shared_runq(thread)) {
+		LOCKED(&sched_lock) {
+			shared_runq_insert(thread);
+		}
+	} else {
+		struct _cpu *cpu = runq_pick_cpu(thread);
+
+		LOCKED(&cpu_runq_lock[cpu->id]) {
+			cpu_runq_insert(cpu, thread);
+		}
+	}
+}
+
+static int runq_remove(struct k_thread *thread)
+{
+	int queued = 0;
+
+	if (in_shared_runq(thread)) {
+		LOCKED(&sched_lock) {
+			queued = _is_thread_queued(thread);
+			if (queued) {
+				shared_runq_extract(thread);
+			}
+		}
+	} else {
+		k_spinlock_key_t key;
+		struct _cpu *cpu = cpu_runq_lock_thread(thread, &key);
+
+		queued = _is_thread_queued(thread);
+		if (queued) {
+			cpu_runq_extract(cpu, thread);
+		}
+		k_spin_unlock(&cpu_runq_lock[cpu->id], key);
+	}
+
+	return queued;
+}
+
+#ifdef CONFIG_SCHED_DEADLINE
+/* Change the deadline of a thread under the lock of the run queue it
+ * sits in, putting it back in order if queued: the old key is needed to
+ * find it in the queue, and other CPUs compare keys under that lock.
+ */
+static void runq_requeue(struct k_thread *thread, int deadline)
+{
+	int queued;
+
+	if (in_shared_runq(thread)) {
+		LOCKED(&sched_lock) {
+			queued = _is_thread_queued(thread);
+			if (queued) {
+				shared_runq_extract(thread);
+			}
+			thread->base.prio_deadline = k_cycle_get_32() + deadline;
+			if (queued) {
+				shared_runq_insert(thread);
+			}
+		}
+	} else {
+		k_spinlock_key_t key;
+		struct _cpu *cpu = cpu_runq_lock_thread(thread, &key);
+
+		queued = _is_thread_queued(thread);
+		if (queued) {
+			cpu_runq_extract(cpu, thread);
+		}
+		thread->base.prio_deadline = k_cycle_get_32() + deadline;
+		if (queued) {
+			cpu_runq_insert(cpu, thread);
+		}
+		k_spin_unlock(&cpu_runq_lock[cpu->id], key);
+	}
+}
+#endif
+
+/* take the best thread queued on another CPU that may run on this one */
+static struct k_thread *runq_steal(struct _cpu *cpu)
+{
+	struct k_thread *th = NULL;
+	int i;
+
+	for (i = 1; i < CONFIG_MP_NUM_CPUS && !th; i++) {
+		struct _cpu *victim =
+			&_kernel.cpus[(cpu->id + i) % CONFIG_MP_NUM_CPUS];
+
+		if (!victim->nr_ready) {
+			continue;
+		}
+
+		LOCKED(&cpu_runq_lock[victim->id]) {
+			th = runq_best(&victim->ready_q, cpu->id);
+			if (th) {
+				cpu_runq_extract(victim, th);
+				th->base.cpu = cpu->id;
+			}
+		}
+	}
+
+	return th;
+}
+
+/* Called from the tick of each CPU, with its own period count */
+void _sched_cpu_runq_balance(s32_t ticks)
+{
+	struct _cpu *self = _current_cpu;
+	struct _cpu *busiest = &_kernel.cpus[0];
+	struct _cpu *idlest = &_kernel.cpus[0];
+	struct _cpu *first, *second;
+	k_spinlock_key_t key1, key2;
+	struct k_thread *th;
+	int i;
+
+	self->balance_ticks += ticks;
+	if (CONFIG_SCHED_CPU_RUNQ_BALANCE_PERIOD == 0 ||
+	    self->balance_ticks <
+	    _ms_to_ticks(CONFIG_SCHED_CPU_RUNQ_BALANCE_PERIOD)) {
+		return;
+	}
+	self->balance_ticks = 0;
+
+	/* The counts are read without their locks, so may be stale: they
+	 * only pick the pair of CPUs, whose counts are checked again once
+	 * both their locks are held.
+	 */
+	for (i = 1; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *cpu = &_kernel.cpus[i];
+
+		if (cpu->nr_ready > busiest->nr_ready) {
+			busiest = cpu;
+		}
+		if (cpu->nr_ready < idlest->nr_ready) {
+			idlest = cpu;
+		}
+	}
+
+	if (busiest->nr_ready < idlest->nr_ready + 2) {
+		return;
+	}
+
+	first = busiest->id < idlest->id ? busiest : idlest;
+	second = busiest->id < idlest->id ? idlest : busiest;
+	key1 = k_spin_lock(&cpu_runq_lock[first->id]);
+	key2 = k_spin_lock(&cpu_runq_lock[second->id]);
+
+	if (busiest->nr_ready >= idlest->nr_ready + 2) {
+		th = runq_best(&busiest->ready_q, idlest->id);
+		if (th) {
+			cpu_runq_extract(busiest, th);
+			cpu_runq_insert(idlest, th);
+		}
+	}
+
+	k_spin_unlock(&cpu_runq_lock[second->id], key2);
+	k_spin_unlock(&cpu_runq_lock[first->id], key1);
+}
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
 static struct k_thread *next_up(void)
 {
 #ifndef CONFIG_SMP
@@ -153,6 +459,103 @@ static struct k_thread *next_up(void)
 	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
 
 	return th ? th : _current_cpu->idle_thread;
+#elif defined(CONFIG_SCHED_CPU_RUNQ)
+	/* As below, with _current going back to and the next thread
+	 * coming from either the shared run queue or the one of this
+	 * CPU.  When left with nothing but its idle thread, the CPU
+	 * steals work from the others.
+	 */
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *th, *sh, *migrate = NULL;
+	k_spinlock_key_t skey, key;
+	int queued = _is_thread_queued(_current);
+	int active = !_is_thread_prevented_from_running(_current);
+	int allowed = cpu_allowed(_current, cpu->id);
+	/* The count is read before taking sched_lock.  A stale non-zero
+	 * count only takes the lock for nothing.  A stale zero misses a
+	 * thread another CPU is queueing right now, which this CPU would
+	 * not have seen either had it come a moment earlier: with no IPI,
+	 * it is picked up at the next reschedule, as idle CPUs yield in a
+	 * loop.  Our own _current is counted by this CPU, so never missed.
+	 */
+	int shared = atomic_get(&shared_nr_ready) ||
+		     (active && in_shared_runq(_current));
+
+	if (shared) {
+		skey = k_spin_lock(&sched_lock);
+	}
+	key = k_spin_lock(&cpu_runq_lock[cpu->id]);
+
+	/* A queued _current always sits in this CPU's run queue */
+	if (queued && !allowed) {
+		if (in_shared_runq(_current)) {
+			shared_runq_extract(_current);
+		} else {
+			cpu_runq_extract(cpu, _current);
+		}
+		queued = 0;
+	}
+
+	th = runq_best(&cpu->ready_q, cpu->id);
+	if (shared) {
+		sh = runq_best(&_kernel.ready_q, cpu->id);
+		if (sh && (!th || _is_t1_higher_prio_than_t2(sh, th))) {
+			th = sh;
+		}
+	}
+	if (!th) {
+		th = cpu->idle_thread;
+	}
+
+	if (active && allowed) {
+		if (!queued &&
+		    !_is_t1_higher_prio_than_t2(th, _current)) {
+			th = _current;
+		}
+
+		if (!should_preempt(th, cpu->swap_ok)) {
+			th = _current;
+		}
+	}
+
+	/* Put _current back into a run queue */
+	if (th != _current && active && !_is_idle(_current) && !queued) {
+		if (in_shared_runq(_current)) {
+			shared_runq_insert(_current);
+		} else if (allowed) {
+			cpu_runq_insert(cpu, _current);
+		} else {
+			migrate = _current;
+		}
+	}
+
+	/* Take the new _current out of its queue */
+	if (_is_thread_queued(th)) {
+		if (in_shared_runq(th)) {
+			shared_runq_extract(th);
+		} else {
+			cpu_runq_extract(cpu, th);
+		}
+	}
+	_mark_thread_as_not_queued(th);
+
+	k_spin_unlock(&cpu_runq_lock[cpu->id], key);
+	if (shared) {
+		k_spin_unlock(&sched_lock, skey);
+	}
+
+	if (migrate) {
+		runq_add(migrate);
+	}
+
+	if (th == cpu->idle_thread) {
+		sh = runq_steal(cpu);
+		if (sh) {
+			th = sh;
+		}
+	}
+
+	return th;
 #else
 
 	/* Under SMP, the "cache" mechanism for selecting the next
@@ -224,25 +627,51 @@ static void update_cache(int preempt_ok)
 
 void _add_thread_to_ready_q(struct k_thread *thread)
 {
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	_thread_runtime_stats_ready(thread);
+#endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	LOCAL_LOCKED {
+		runq_add(thread);
+		update_cache(0);
+	}
+#else
 	LOCKED(&sched_lock) {
 		_priq_run_add(&_kernel.ready_q.runq, thread);
 		_mark_thread_as_queued(thread);
 		update_cache(0);
 	}
+#endif
 }
 
 void _move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	LOCAL_LOCKED {
+		runq_remove(thread);
+		runq_add(thread);
+		update_cache(0);
+	}
+#else
 	LOCKED(&sched_lock) {
 		_priq_run_remove(&_kernel.ready_q.runq, thread);
 		_priq_run_add(&_kernel.ready_q.runq, thread);
 		_mark_thread_as_queued(thread);
 		update_cache(0);
 	}
+#endif
 }
 
 void _remove_thread_from_ready_q(struct k_thread *thread)
 {
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	LOCAL_LOCKED {
+		if (runq_remove(thread)) {
+			update_cache(thread == _current);
+		}
+	}
+#else
 	LOCKED(&sched_lock) {
 		if (_is_thread_queued(thread)) {
 			_priq_run_remove(&_kernel.ready_q.runq, thread);
@@ -250,6 +679,7 @@ void _remove_thread_from_ready_q(struct k_thread *thread)
 			update_cache(thread == _current);
 		}
 	}
+#endif
 }
 
 static void pend(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout)
@@ -357,6 +787,23 @@ void _thread_priority_set(struct k_thread *thread, int prio)
 {
 	int need_sched = 0;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	LOCAL_LOCKED {
+		need_sched = _is_thread_ready(thread);
+
+		/* may move between the shared and a per-CPU run queue */
+		if (runq_remove(thread)) {
+			thread->base.prio = prio;
+			runq_add(thread);
+		} else {
+			thread->base.prio = prio;
+		}
+
+		if (need_sched) {
+			update_cache(1);
+		}
+	}
+#else
 	LOCKED(&sched_lock) {
 		need_sched = _is_thread_ready(thread);
 
@@ -369,6 +816,7 @@ void _thread_priority_set(struct k_thread *thread, int prio)
 			thread->base.prio = prio;
 		}
 	}
+#endif
 	sys_trace_thread_priority_set(thread);
 
 	if (need_sched) {
@@ -433,9 +881,16 @@ struct k_thread *_get_next_ready_thread(void)
 {
 	struct k_thread *ret = 0;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* next_up() takes the run queue locks it needs */
+	LOCAL_LOCKED {
+		ret = next_up();
+	}
+#else
 	LOCKED(&sched_lock) {
 		ret = next_up();
 	}
+#endif
 
 	return ret;
 }
@@ -446,7 +901,17 @@ void *_get_next_switch_handle(void *interrupted)
 {
 	_current->switch_handle = interrupted;
 
-#ifdef CONFIG_SMP
+#if defined(CONFIG_SCHED_CPU_RUNQ)
+	LOCAL_LOCKED {
+		struct k_thread *th = next_up();
+
+		if (_current != th) {
+			_current_cpu->swap_ok = 0;
+			_current = th;
+		}
+	}
+
+#elif defined(CONFIG_SMP)
 	LOCKED(&sched_lock) {
 		struct k_thread *th = next_up();
 
@@ -619,8 +1084,17 @@ int _is_thread_time_slicing(struct k_thread *thread)
 	}
 
 
-	LOCKED(&sched_lock) {
-		struct k_thread *next = _priq_run_best(&_kernel.ready_q.runq);
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* time sliced threads are preemptible, in this CPU's run queue */
+	struct k_spinlock *lock = &cpu_runq_lock[_current_cpu->id];
+	_ready_q_t *rq = &_current_cpu->ready_q;
+#else
+	struct k_spinlock *lock = &sched_lock;
+	_ready_q_t *rq = &_kernel.ready_q;
+#endif
+
+	LOCKED(lock) {
+		struct k_thread *next = _priq_run_best(&rq->runq);
 
 		if (next) {
 			ret = thread->base.prio == next->base.prio;
@@ -679,14 +1153,14 @@ int _unpend_all(_wait_q_t *waitq)
 	return need_sched;
 }
 
-void _sched_init(void)
+static void init_ready_q(_ready_q_t *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = _priq_rb_lessthan,
 		}
@@ -694,8 +1168,19 @@ void _sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#endif
+}
+
+void _sched_init(void)
+{
+	init_ready_q(&_kernel.ready_q);
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
 #endif
 
@@ -751,6 +1236,9 @@ void _impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 {
 	struct k_thread *th = tid;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	runq_requeue(th, deadline);
+#else
 	LOCKED(&sched_lock) {
 		th->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (_is_thread_queued(th)) {
@@ -758,6 +1246,7 @@ void _impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 			_priq_run_add(&_kernel.ready_q.runq, th);
 		}
 	}
+#endif
 }
 
 #ifdef CONFIG_USERSPACE
@@ -776,16 +1265,282 @@ Z_SYSCALL_HANDLER(k_thread_deadline_set, thread_p, deadline)
 #endif
 #endif
 
+#ifdef CONFIG_SCHED_EDF
+/* sum of the utilization of EDF threads, in 1/1000 */
+static u32_t edf_utilization;
+
+static void edf_release(struct _timeout *timeout)
+{
+	struct k_thread *th = CONTAINER_OF(timeout, struct k_thread,
+					   base.edf.release);
+	struct _thread_edf *edf = &th->base.edf;
+	unsigned int key = irq_lock();
+
+	_add_timeout(NULL, &edf->release, NULL, edf->period);
+
+	/* deadlines are within the period: the job is late */
+	if (!edf->job_done) {
+		edf->misses++;
+	}
+
+	edf->jobs++;
+	edf->job_done = 0;
+	edf->remaining = edf->budget;
+	_impl_k_thread_deadline_set(th, edf->deadline);
+
+	if (th->base.thread_state & _THREAD_THROTTLED) {
+		th->base.thread_state &= ~_THREAD_THROTTLED;
+		_ready_thread(th);
+	}
+
+	irq_unlock(key);
+}
+
+static void edf_leave(struct k_thread *th)
+{
+	struct _thread_edf *edf = &th->base.edf;
+
+	_abort_timeout(&edf->release);
+	edf_utilization -= edf->utilization;
+	edf->utilization = 0;
+	edf->period = 0;
+
+	if (th->base.thread_state & _THREAD_THROTTLED) {
+		th->base.thread_state &= ~_THREAD_THROTTLED;
+		_ready_thread(th);
+	}
+}
+
+int _impl_k_thread_edf_set(k_tid_t tid, s32_t period, s32_t budget,
+			   s32_t deadline)
+{
+	struct k_thread *th = tid;
+	struct _thread_edf *edf = &th->base.edf;
+	u32_t utilization;
+	unsigned int key;
+
+	if (period == 0) {
+		key = irq_lock();
+		edf_leave(th);
+		_reschedule(key);
+		return 0;
+	}
+
+	if (deadline == 0) {
+		deadline = period;
+	}
+
+	if (period < 0 || budget <= 0 || budget > deadline ||
+	    deadline > period) {
+		return -EINVAL;
+	}
+
+	/* density test, sufficient for deadlines shorter than the period */
+	utilization = ceiling_fraction((u32_t)budget * 1000, (u32_t)deadline);
+
+	key = irq_lock();
+
+	if (edf_utilization - edf->utilization + utilization >
+	    CONFIG_SCHED_EDF_UTILIZATION_MAX * 10) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	edf_leave(th);
+	edf_utilization += utilization;
+	edf->utilization = utilization;
+
+	edf->period = _ms_to_ticks(period);
+	edf->budget = _ms_to_ticks(budget);
+	edf->remaining = edf->budget;
+	edf->deadline = _ms_to_ticks(deadline) * sys_clock_hw_cycles_per_tick;
+	edf->job_done = 0;
+	edf->jobs = 1;
+	edf->misses = 0;
+	edf->overruns = 0;
+
+	_init_timeout(&edf->release, edf_release);
+	_add_timeout(NULL, &edf->release, NULL, edf->period);
+	_impl_k_thread_deadline_set(th, edf->deadline);
+
+	irq_unlock(key);
+
+	_thread_priority_set(th, CONFIG_SCHED_EDF_PRIORITY);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_thread_edf_set, thread_p, period, budget, deadline)
+{
+	struct k_thread *thread = (struct k_thread *)thread_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+	Z_OOPS(Z_SYSCALL_VERIFY_MSG(period == 0 ||
+				    CONFIG_SCHED_EDF_PRIORITY >=
+				    thread->base.prio,
+				    "thread priority may only be downgraded (%d < %d)",
+				    CONFIG_SCHED_EDF_PRIORITY, thread->base.prio));
+
+	return _impl_k_thread_edf_set((k_tid_t)thread, period, budget,
+				      deadline);
+}
+#endif
+
+void _impl_k_thread_edf_wait(void)
+{
+	struct _thread_edf *edf = &_current->base.edf;
+	unsigned int key;
+
+	__ASSERT(!_is_in_isr(), "");
+	__ASSERT(edf->period != 0, "thread not in the EDF class");
+
+	key = irq_lock();
+
+	if ((int)(k_cycle_get_32() - _current->base.prio_deadline) > 0) {
+		edf->misses++;
+	}
+
+	edf->job_done = 1;
+	_current->base.thread_state |= _THREAD_THROTTLED;
+	_remove_thread_from_ready_q(_current);
+
+	_Swap(key);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER0_SIMPLE_VOID(k_thread_edf_wait);
+#endif
+
+void _impl_k_thread_edf_stats_get(k_tid_t tid,
+				  struct k_thread_edf_stats *stats)
+{
+	struct _thread_edf *edf = &tid->base.edf;
+	unsigned int key = irq_lock();
+
+	stats->jobs = edf->jobs;
+	stats->misses = edf->misses;
+	stats->overruns = edf->overruns;
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_thread_edf_stats_get, thread_p, stats)
+{
+	struct k_thread *thread = (struct k_thread *)thread_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(stats,
+				      sizeof(struct k_thread_edf_stats)));
+
+	_impl_k_thread_edf_stats_get((k_tid_t)thread,
+				     (struct k_thread_edf_stats *)stats);
+	return 0;
+}
+#endif
+
+/* charge the running thread for the elapsed ticks, like time slices */
+void _sched_edf_tick(s32_t ticks)
+{
+	struct k_thread *th = _current;
+	struct _thread_edf *edf = &th->base.edf;
+	unsigned int key;
+
+	if (edf->period == 0) {
+		return;
+	}
+
+	key = irq_lock();
+
+	edf->remaining -= ticks;
+	if (edf->remaining <= 0 &&
+	    !(th->base.thread_state & _THREAD_THROTTLED)) {
+		edf->overruns++;
+		th->base.thread_state |= _THREAD_THROTTLED;
+		_remove_thread_from_ready_q(th);
+	}
+
+	irq_unlock(key);
+}
+
+void _sched_edf_thread_abort(struct k_thread *thread)
+{
+	unsigned int key = irq_lock();
+
+	/* the thread is going away, it must not be made ready again */
+	thread->base.thread_state &= ~_THREAD_THROTTLED;
+	if (thread->base.edf.period != 0) {
+		edf_leave(thread);
+	}
+
+	irq_unlock(key);
+}
+#endif /* CONFIG_SCHED_EDF */
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+int _impl_k_thread_cpu_mask_set(k_tid_t tid, u32_t mask)
+{
+	struct k_thread *th = tid;
+	int resched = 0;
+
+	mask &= CPU_MASK_ALL;
+	if (!mask) {
+		return -EINVAL;
+	}
+
+	LOCAL_LOCKED {
+		/* move it to the run queue of an allowed CPU */
+		if (runq_remove(th)) {
+			th->base.cpu_mask = mask;
+			runq_add(th);
+		} else {
+			th->base.cpu_mask = mask;
+		}
+
+		if (th == _current && !cpu_allowed(th, _current_cpu->id)) {
+			update_cache(1);
+			resched = 1;
+		}
+	}
+
+	if (resched) {
+		_reschedule(irq_lock());
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_thread_cpu_mask_set, thread_p, mask)
+{
+	struct k_thread *thread = (struct k_thread *)thread_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+
+	return _impl_k_thread_cpu_mask_set((k_tid_t)thread, mask);
+}
+#endif
+#endif /* CONFIG_SCHED_CPU_RUNQ */
+
 void _impl_k_yield(void)
 {
 	__ASSERT(!_is_in_isr(), "");
 
 	if (!_is_idle(_current)) {
+#ifdef CONFIG_SCHED_CPU_RUNQ
+		LOCAL_LOCKED {
+			runq_remove(_current);
+			runq_add(_current);
+			update_cache(1);
+		}
+#else
 		LOCKED(&sched_lock) {
 			_priq_run_remove(&_kernel.ready_q.runq, _current);
 			_priq_run_add(&_kernel.ready_q.runq, _current);
 			update_cache(1);
 		}
+#endif
 	}
 
 #ifdef CONFIG_SMP
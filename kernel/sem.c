@@ -102,6 +102,9 @@ static void do_sem_give(struct k_sem *sem)
 	struct k_thread *thread = _unpend_first_thread(&sem->wait_q);
 
 	if (thread) {
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+		thread->wake_stamp = k_cycle_get_32();
+#endif
 		_ready_thread(thread);
 		_set_thread_return_value(thread, 0);
 	} else {
@@ -146,7 +149,16 @@ int _impl_k_sem_take(struct k_sem *sem, s32_t timeout)
 
 	sys_trace_end_call(SYS_TRACE_ID_SEMA_TAKE);
 
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+	int ret = _pend_current_thread(key, &sem->wait_q, timeout);
+
+	if (ret == 0) {
+		_latency_hist_record(K_LATENCY_SEM_WAKE, _current->wake_stamp);
+	}
+	return ret;
+#else
 	return _pend_current_thread(key, &sem->wait_q, timeout);
+#endif
 }
 
 #ifdef CONFIG_USERSPACE
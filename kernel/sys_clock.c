@@ -11,6 +11,7 @@
 #include <toolchain.h>
 #include <linker/sections.h>
 #include <wait_q.h>
+#include <ksched.h>
 #include <drivers/system_timer.h>
 #include <syscall_handler.h>
 
@@ -167,6 +168,22 @@ u32_t k_uptime_delta_32(s64_t *reftime)
  * interrupt.
  */
 
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+static inline void handle_timeouts(s32_t ticks)
+{
+	sys_dlist_t expired;
+
+	sys_dlist_init(&expired);
+
+	/*
+	 * The wheel locks interrupts for each slot it expires or cascades,
+	 * and hands back the expired timeouts in the order they were queued.
+	 */
+	_timeout_wheel_advance(ticks, &expired);
+
+	_handle_expired_timeouts(&expired);
+}
+#else
 static inline void handle_timeouts(s32_t ticks)
 {
 	sys_dlist_t expired;
@@ -251,6 +268,7 @@ static inline void handle_timeouts(s32_t ticks)
 
 	_handle_expired_timeouts(&expired);
 }
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
 #else
 	#define handle_timeouts(ticks) do { } while ((0))
 #endif
@@ -317,6 +335,10 @@ void _nano_sys_clock_tick_announce(s32_t ticks)
 	}
 #endif
 
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+	_latency_hist_tick_start();
+#endif
+
 #ifndef CONFIG_TICKLESS_KERNEL
 	unsigned int  key;
 
@@ -332,6 +354,14 @@ void _nano_sys_clock_tick_announce(s32_t ticks)
 	/* time slicing is basically handled like just yet another timeout */
 	handle_time_slicing(ticks);
 
+#ifdef CONFIG_SCHED_EDF
+	_sched_edf_tick(ticks);
+#endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	_sched_cpu_runq_balance(ticks);
+#endif
+
 #ifdef CONFIG_TICKLESS_KERNEL
 	u32_t next_to = _get_next_timeout_expiry();
 
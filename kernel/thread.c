@@ -23,6 +23,7 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <atomic.h>
+#include <string.h>
 #include <syscall_handler.h>
 #include <kernel_internal.h>
 #include <kswap.h>
@@ -317,6 +318,9 @@ void _setup_new_thread(struct k_thread *new_thread,
 #endif
 #endif
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	memset(&new_thread->rt_stats, 0, sizeof(new_thread->rt_stats));
+#endif
 #ifdef CONFIG_THREAD_MONITOR
 	new_thread->entry.pEntry = entry;
 	new_thread->entry.parameter1 = p1;
@@ -546,6 +550,10 @@ void _k_thread_single_abort(struct k_thread *thread)
 		thread->fn_abort();
 	}
 
+#ifdef CONFIG_SCHED_EDF
+	_sched_edf_thread_abort(thread);
+#endif
+
 	if (_is_thread_ready(thread)) {
 		_remove_thread_from_ready_q(thread);
 	} else {
@@ -653,6 +661,17 @@ void _init_thread_base(struct _thread_base *thread_base, int priority,
 	/* swap_data does not need to be initialized */
 
 	_init_thread_timeout(thread_base);
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	thread_base->cpu = 0;
+	thread_base->cpu_mask = (u32_t)~0 >> (32 - CONFIG_MP_NUM_CPUS);
+#endif
+
+#ifdef CONFIG_SCHED_EDF
+	thread_base->edf.period = 0;
+	thread_base->edf.utilization = 0;
+	_init_timeout(&thread_base->edf.release, NULL);
+#endif
 }
 
 void k_thread_access_grant(struct k_thread *thread, ...)
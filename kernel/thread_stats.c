@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Thread runtime statistics
+ *
+ * Time is charged to the running thread at every context switch, from the
+ * tracing hook the architectures call right before switching, while
+ * _current still is the outgoing thread and the ready queue cache holds
+ * the incoming one.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <tracing.h>
+#include <syscall_handler.h>
+
+extern k_tid_t const _idle_thread;
+
+/* accounting over all threads */
+static struct _thread_runtime_stats all_stats;
+
+/* cycle count at the last time charged */
+static u32_t charge_stamp;
+
+/* must be called with interrupts locked */
+static void charge_current(void)
+{
+	u32_t now = k_cycle_get_32();
+	u32_t cycles = now - charge_stamp;
+
+	charge_stamp = now;
+	_current->rt_stats.execution_cycles += cycles;
+	all_stats.execution_cycles += cycles;
+}
+
+static void account_latency(struct _thread_runtime_stats *stats, u32_t latency)
+{
+	stats->latency_total += latency;
+	stats->latency_count++;
+	if (latency > stats->latency_max) {
+		stats->latency_max = latency;
+	}
+}
+
+void _thread_runtime_stats_ready(struct k_thread *thread)
+{
+	thread->rt_stats.ready_stamp = k_cycle_get_32();
+	thread->rt_stats.latency_pending = 1;
+}
+
+/* ARM calls this from PendSV before masking interrupts, lock them here */
+void z_sys_trace_thread_switched_in(void)
+{
+	unsigned int key = irq_lock();
+	struct k_thread *next = _kernel.ready_q.cache;
+
+	charge_current();
+
+	if (next != _current) {
+		next->rt_stats.switches++;
+		all_stats.switches++;
+
+		if (next->rt_stats.latency_pending) {
+			u32_t latency = charge_stamp -
+					next->rt_stats.ready_stamp;
+
+			next->rt_stats.latency_pending = 0;
+			account_latency(&next->rt_stats, latency);
+			account_latency(&all_stats, latency);
+		}
+	}
+
+	irq_unlock(key);
+}
+
+void z_sys_trace_idle(void)
+{
+	/* the idle thread may not be switched out for long, keep the
+	 * elapsed cycles from wrapping around
+	 */
+	unsigned int key = irq_lock();
+
+	charge_current();
+	irq_unlock(key);
+}
+
+void z_sys_trace_isr_enter(void)
+{
+}
+
+void z_sys_trace_isr_exit_to_scheduler(void)
+{
+}
+
+static void stats_copy(struct k_thread_runtime_stats *stats,
+		       struct _thread_runtime_stats *rt_stats)
+{
+	stats->execution_cycles = rt_stats->execution_cycles;
+	stats->switches = rt_stats->switches;
+	stats->latency_max = rt_stats->latency_max;
+	stats->latency_avg = rt_stats->latency_count == 0 ? 0 :
+		(u32_t)(rt_stats->latency_total / rt_stats->latency_count);
+}
+
+void _impl_k_thread_runtime_stats_get(k_tid_t thread,
+				      struct k_thread_runtime_stats *stats)
+{
+	unsigned int key = irq_lock();
+
+	charge_current();
+	stats_copy(stats, &thread->rt_stats);
+	stats->idle_cycles = 0;
+
+	irq_unlock(key);
+}
+
+void _impl_k_thread_runtime_stats_all_get(struct k_thread_runtime_stats *stats)
+{
+	unsigned int key = irq_lock();
+
+	charge_current();
+	stats_copy(stats, &all_stats);
+	stats->idle_cycles = _idle_thread->rt_stats.execution_cycles;
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_thread_runtime_stats_get, thread_p, stats)
+{
+	struct k_thread *thread = (struct k_thread *)thread_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(stats,
+				      sizeof(struct k_thread_runtime_stats)));
+
+	_impl_k_thread_runtime_stats_get((k_tid_t)thread,
+				(struct k_thread_runtime_stats *)stats);
+	return 0;
+}
+
+Z_SYSCALL_HANDLER(k_thread_runtime_stats_all_get, stats)
+{
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(stats,
+				      sizeof(struct k_thread_runtime_stats)));
+
+	_impl_k_thread_runtime_stats_all_get(
+		(struct k_thread_runtime_stats *)stats);
+	return 0;
+}
+#endif
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief hierarchical timing wheel backend of the timeout queue
+ *
+ * Each pending timeout records its absolute expiry in wheel ticks and is
+ * hashed into the level whose granularity matches the most significant bit
+ * in which the expiry differs from the current wheel time:
+ *
+ *   level 0: timeouts expiring within the current 32-tick window, one slot
+ *            per tick
+ *   level n: timeouts expiring within the current 32^(n+1)-tick window, one
+ *            slot per 32^n ticks
+ *
+ * Arming and aborting a timeout are thus constant time. When the wheel time
+ * crosses a level-n slot boundary, that slot is "cascaded": its timeouts are
+ * requeued, which moves them to finer levels, until they end up in a level 0
+ * slot and expire. Timeouts too far in the future for the top level wait on
+ * an overflow list that is requeued every time the whole wheel wraps.
+ *
+ * All functions must be called with interrupts locked, except
+ * _timeout_wheel_advance(), which locks them on its own.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <wait_q.h>
+
+#define WHEEL_BITS _TIMEOUT_WHEEL_BITS
+#define WHEEL_SLOTS _TIMEOUT_WHEEL_SLOTS
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_WHEEL_LEVELS
+
+/* wheel time must be representable in a u32_t with room for the overflow */
+BUILD_ASSERT(WHEEL_BITS * WHEEL_LEVELS < 32);
+
+#define wheel _timeout_wheel
+
+static inline u32_t slot_index(u32_t tick, int level)
+{
+	return (tick >> (level * WHEEL_BITS)) & WHEEL_MASK;
+}
+
+void _timeout_wheel_init(void)
+{
+	int level, idx;
+
+	wheel.now = 0;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		wheel.bitmap[level] = 0;
+		for (idx = 0; idx < WHEEL_SLOTS; idx++) {
+			sys_dlist_init(&wheel.slots[level][idx]);
+		}
+	}
+
+	sys_dlist_init(&wheel.overflow);
+}
+
+static void wheel_queue(struct _timeout *timeout)
+{
+	u32_t diff = timeout->expiry ^ wheel.now;
+	int level = diff ? (find_msb_set(diff) - 1) / WHEEL_BITS : 0;
+	u32_t idx;
+
+	if (level >= WHEEL_LEVELS) {
+		sys_dlist_append(&wheel.overflow, &timeout->node);
+		return;
+	}
+
+	idx = slot_index(timeout->expiry, level);
+	sys_dlist_append(&wheel.slots[level][idx], &timeout->node);
+	wheel.bitmap[level] |= BIT(idx);
+}
+
+void _timeout_wheel_add(struct _timeout *timeout, s32_t ticks)
+{
+	__ASSERT(ticks > 0, "");
+
+	timeout->expiry = wheel.now + ticks;
+	wheel_queue(timeout);
+}
+
+void _timeout_wheel_remove(struct _timeout *timeout)
+{
+	sys_dnode_t *node = &timeout->node;
+
+	/*
+	 * When the timeout is the only entry of its list, both its links
+	 * point to the list head, which tells which slot becomes empty.
+	 */
+	if (node->next == node->prev) {
+		sys_dlist_t *first = &wheel.slots[0][0];
+		sys_dlist_t *list = node->next;
+
+		if (list >= first && list < first + WHEEL_LEVELS * WHEEL_SLOTS) {
+			int n = list - first;
+
+			wheel.bitmap[n / WHEEL_SLOTS] &= ~BIT(n % WHEEL_SLOTS);
+		}
+	}
+
+	sys_dlist_remove(node);
+}
+
+s32_t _timeout_wheel_remaining(struct _timeout *timeout)
+{
+	return (s32_t)(timeout->expiry - wheel.now);
+}
+
+static s32_t list_min_remaining(sys_dlist_t *list)
+{
+	struct _timeout *timeout;
+	u32_t min = ~0;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, timeout, node) {
+		min = min(min, timeout->expiry - wheel.now);
+	}
+
+	return (s32_t)min;
+}
+
+s32_t _timeout_wheel_next_expiry(void)
+{
+	int level;
+
+	/*
+	 * Slots at or behind the current position of a level are always
+	 * empty, since they have been cascaded already, and every timeout
+	 * of a level expires before any timeout of the levels above it: the
+	 * first non-empty slot of the lowest non-empty level holds the next
+	 * expiry. Only level 0 slots are guaranteed to hold a single expiry
+	 * value, higher level ones must be scanned.
+	 */
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		if (wheel.bitmap[level]) {
+			u32_t idx = find_lsb_set(wheel.bitmap[level]) - 1;
+			sys_dlist_t *slot = &wheel.slots[level][idx];
+
+			if (level == 0) {
+				struct _timeout *timeout = (struct _timeout *)
+					sys_dlist_peek_head_not_empty(slot);
+
+				return _timeout_wheel_remaining(timeout);
+			}
+
+			return list_min_remaining(slot);
+		}
+	}
+
+	if (sys_dlist_is_empty(&wheel.overflow)) {
+		return K_FOREVER;
+	}
+
+	return list_min_remaining(&wheel.overflow);
+}
+
+static void requeue(sys_dlist_t *list)
+{
+	sys_dlist_t pending;
+	sys_dnode_t *node;
+
+	/* detach the list first, entries may be queued back on it */
+	sys_dlist_init(&pending);
+	while ((node = sys_dlist_get(list)) != NULL) {
+		sys_dlist_append(&pending, node);
+	}
+
+	while ((node = sys_dlist_get(&pending)) != NULL) {
+		wheel_queue((struct _timeout *)node);
+	}
+}
+
+/* wheel.now has just crossed a level 0 window boundary */
+static void cascade(void)
+{
+	int level;
+
+	for (level = 1; level < WHEEL_LEVELS; level++) {
+		u32_t idx = slot_index(wheel.now, level);
+
+		wheel.bitmap[level] &= ~BIT(idx);
+		requeue(&wheel.slots[level][idx]);
+
+		if (idx != 0) {
+			return;
+		}
+	}
+
+	/* the whole wheel wrapped around */
+	requeue(&wheel.overflow);
+}
+
+/* ticks until the wheel reaches the next slot with some work to do */
+static u32_t next_event(void)
+{
+	u32_t step = ~0U;
+	int level;
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		int shift = level * WHEEL_BITS;
+		u32_t idx = slot_index(wheel.now, level);
+		u32_t later = wheel.bitmap[level] & ((~0U << idx) << 1);
+
+		if (later) {
+			u32_t start = (wheel.now >> (shift + WHEEL_BITS))
+				      << (shift + WHEEL_BITS);
+
+			start += (u32_t)(find_lsb_set(later) - 1) << shift;
+			step = min(step, start - wheel.now);
+		}
+	}
+
+	if (!sys_dlist_is_empty(&wheel.overflow)) {
+		int span = WHEEL_LEVELS * WHEEL_BITS;
+		u32_t wrap = ((wheel.now >> span) + 1) << span;
+
+		step = min(step, wrap - wheel.now);
+	}
+
+	return step;
+}
+
+void _timeout_wheel_advance(s32_t ticks, sys_dlist_t *expired)
+{
+	unsigned int key = irq_lock();
+	u32_t target = wheel.now + ticks;
+
+	while (wheel.now != target) {
+		u32_t step = next_event();
+		sys_dlist_t *slot;
+		sys_dnode_t *node;
+		u32_t idx;
+
+		/*
+		 * Jump straight to the next non-empty level 0 slot, or to the
+		 * start of the next non-empty slot of a higher level, which must
+		 * be cascaded: empty slots are never visited.
+		 */
+		if (step > target - wheel.now) {
+			wheel.now = target;
+			break;
+		}
+
+		wheel.now += step;
+		idx = wheel.now & WHEEL_MASK;
+
+		if (idx == 0) {
+			cascade();
+		}
+
+		slot = &wheel.slots[0][idx];
+		wheel.bitmap[0] &= ~BIT(idx);
+		while ((node = sys_dlist_get(slot)) != NULL) {
+			struct _timeout *timeout = (struct _timeout *)node;
+
+			sys_dlist_append(expired, node);
+			timeout->delta_ticks_from_prev = _EXPIRED;
+		}
+
+		/* relieve irq lock pressure between slots */
+		irq_unlock(key);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_KERNEL_DEBUG
+static void dump_slot(sys_dlist_t *slot, int level, int idx)
+{
+	struct _timeout *timeout;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(slot, timeout, node) {
+		K_DEBUG("level %d, slot %d, %d ticks left:\n", level, idx,
+			(s32_t)(timeout->expiry - wheel.now));
+		_dump_timeout(timeout, 1);
+	}
+}
+
+void _timeout_wheel_dump(void)
+{
+	int level, idx;
+
+	K_DEBUG("timeout wheel: %p, now: %u\n", &wheel, wheel.now);
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		for (idx = 0; idx < WHEEL_SLOTS; idx++) {
+			dump_slot(&wheel.slots[level][idx], level, idx);
+		}
+	}
+
+	dump_slot(&wheel.overflow, WHEEL_LEVELS, 0);
+}
+#endif
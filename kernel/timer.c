@@ -65,6 +65,9 @@ void _timer_expiration_handler(struct _timeout *t)
 
 	/* invoke timer expiry function */
 	if (timer->expiry_fn) {
+#ifdef CONFIG_LATENCY_HISTOGRAMS
+		_latency_hist_timer_expiry();
+#endif
 		timer->expiry_fn(timer);
 	}
 
@@ -236,6 +239,9 @@ s32_t _timeout_remaining_get(struct _timeout *timeout)
 	if (timeout->delta_ticks_from_prev == _INACTIVE) {
 		remaining_ticks = 0;
 	} else {
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+		remaining_ticks = _timeout_wheel_remaining(timeout);
+#else
 		/*
 		 * compute remaining ticks by walking the timeout list
 		 * and summing up the various tick deltas involved
@@ -249,6 +255,7 @@ s32_t _timeout_remaining_get(struct _timeout *timeout)
 								   &t->node);
 			remaining_ticks += t->delta_ticks_from_prev;
 		}
+#endif
 	}
 
 	irq_unlock(key);
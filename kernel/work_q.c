@@ -50,11 +50,145 @@ void k_work_q_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 		    size_t stack_size, int prio)
 {
 	k_queue_init(&work_q->queue);
+#ifdef CONFIG_WORK_Q_POOL
+	work_q->pool = NULL;
+#endif
 	k_thread_create(&work_q->thread, stack, stack_size, work_q_main,
 			work_q, 0, 0, prio, 0, 0);
 	_k_object_init(work_q);
 }
 
+#ifdef CONFIG_WORK_Q_POOL
+void _k_work_q_pool_insert(struct k_work_q *work_q, struct k_work *work)
+{
+	unsigned int key = irq_lock();
+	sys_sfnode_t *prev = sys_sflist_peek_tail(&work_q->queue.data_q);
+	sys_sfnode_t *node;
+
+	/* Queue after the last work item of the same or a higher priority,
+	 * only walking the queue when not simply appending.
+	 */
+	if (prev && ((struct k_work *)prev)->prio > work->prio) {
+		prev = NULL;
+		SYS_SFLIST_FOR_EACH_NODE(&work_q->queue.data_q, node) {
+			if (((struct k_work *)node)->prio > work->prio) {
+				break;
+			}
+			prev = node;
+		}
+	}
+
+	if (++work_q->backlog > work_q->backlog_max) {
+		work_q->backlog_max = work_q->backlog;
+	}
+
+	k_queue_insert(&work_q->queue, prev, work);
+	irq_unlock(key);
+}
+
+static void work_q_pool_process(struct k_work_q *work_q, struct k_work *work)
+{
+	k_work_handler_t handler = work->handler;
+	unsigned int key = irq_lock();
+	u32_t start, cycles;
+
+	work_q->backlog--;
+	irq_unlock(key);
+
+	/* Reset pending state so it can be resubmitted by handler */
+	if (!atomic_test_and_clear_bit(work->flags, K_WORK_STATE_PENDING)) {
+		return;
+	}
+
+	start = k_cycle_get_32();
+	handler(work);
+	cycles = k_cycle_get_32() - start;
+
+	key = irq_lock();
+	work_q->items++;
+	if (cycles > work_q->handler_max) {
+		work_q->handler_max = cycles;
+	}
+	irq_unlock(key);
+}
+
+static void work_q_pool_main(void *work_q_ptr, void *p2, void *p3)
+{
+	struct k_work_q *work_q = work_q_ptr;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		struct k_work *work;
+		int batch = CONFIG_WORK_Q_POOL_BATCH;
+
+		/* Process what is pending in batches, rather than going
+		 * through the scheduler after each work item.
+		 */
+		work = k_queue_get(&work_q->queue, K_FOREVER);
+		while (work) {
+			work_q_pool_process(work_q, work);
+			if (--batch == 0) {
+				break;
+			}
+			work = k_queue_get(&work_q->queue, K_NO_WAIT);
+		}
+
+		k_yield();
+	}
+}
+
+void k_work_q_pool_start(struct k_work_q *work_q, struct k_thread *threads,
+			 k_thread_stack_t *stacks, size_t stack_size,
+			 int num_threads, int prio)
+{
+	int i;
+
+	__ASSERT(num_threads > 0, "");
+
+	k_queue_init(&work_q->queue);
+	work_q->pool = threads;
+	work_q->backlog = 0;
+	work_q->backlog_max = 0;
+	work_q->handler_max = 0;
+	work_q->items = 0;
+	work_q->stamp = k_uptime_get_32();
+
+	for (i = 0; i < num_threads; i++) {
+		k_thread_stack_t *stack = (k_thread_stack_t *)
+			((char *)stacks + i * K_THREAD_STACK_LEN(stack_size));
+
+		k_thread_create(&threads[i], stack, stack_size,
+				work_q_pool_main, work_q, 0, 0, prio, 0, 0);
+	}
+	_k_object_init(work_q);
+}
+
+void k_work_q_stats_get(struct k_work_q *work_q, struct k_work_q_stats *stats)
+{
+	unsigned int key = irq_lock();
+	u32_t now = k_uptime_get_32();
+	u32_t elapsed = now - work_q->stamp;
+
+	stats->backlog = work_q->backlog;
+	stats->backlog_max = work_q->backlog_max;
+	stats->handler_max_us = SYS_CLOCK_HW_CYCLES_TO_NS(work_q->handler_max) /
+				NSEC_PER_USEC;
+	stats->items = work_q->items;
+	stats->items_per_sec = elapsed == 0 ? 0 :
+		(u32_t)((u64_t)work_q->items * MSEC_PER_SEC / elapsed);
+
+	/* start a new period */
+	work_q->backlog_max = work_q->backlog;
+	work_q->handler_max = 0;
+	work_q->items = 0;
+	work_q->stamp = now;
+
+	irq_unlock(key);
+}
+#endif /* CONFIG_WORK_Q_POOL */
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 static void work_timeout(struct _timeout *t)
 {
@@ -130,6 +264,11 @@ int k_delayed_work_cancel(struct k_delayed_work *work)
 			irq_unlock(key);
 			return -EINVAL;
 		}
+#ifdef CONFIG_WORK_Q_POOL
+		if (work->work_q->pool) {
+			work->work_q->backlog--;
+		}
+#endif
 	} else {
 		_abort_timeout(&work->timeout);
 	}
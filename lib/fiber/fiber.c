@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Fibers
+ *
+ * A host thread runs its ready fibers in turn, switching to each one and
+ * back with _arch_fiber_switch(). When none is ready, it waits on the poll
+ * set holding the events its fibers wait for, until the nearest deadline
+ * of a fiber, and makes ready the fibers owning the events returned.
+ */
+
+#include <kernel.h>
+#include <misc/fiber.h>
+#include <misc/__assert.h>
+
+#define STACK_SENTINEL 0xF1BE45AC
+
+/* ready events handled per wait of a host */
+#define READY_BATCH 8
+
+extern void *_arch_fiber_init(char *stack_top, void (*entry)(void));
+extern void _arch_fiber_switch(void **save_sp, void *sp);
+
+/* hosts running fibers, to find the one of the current thread */
+static sys_slist_t hosts;
+
+static struct sys_fiber_host *current_host(void)
+{
+	k_tid_t thread = k_current_get();
+	struct sys_fiber_host *host;
+	unsigned int key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&hosts, host, node) {
+		if (host->thread == thread) {
+			break;
+		}
+	}
+
+	irq_unlock(key);
+	return host;
+}
+
+static void fiber_start(void)
+{
+	struct sys_fiber_host *host = current_host();
+	struct sys_fiber *fiber = host->current;
+
+	fiber->entry(fiber->arg);
+
+	/* never switched back to */
+	host->num_fibers--;
+	_arch_fiber_switch(&fiber->sp, host->sp);
+}
+
+/* switches from the running fiber to its host */
+static int fiber_suspend(struct sys_fiber *fiber)
+{
+	_arch_fiber_switch(&fiber->sp, fiber->host->sp);
+
+	return fiber->result;
+}
+
+/* makes a waiting fiber ready */
+static void fiber_wake(struct sys_fiber *fiber, int result)
+{
+	struct sys_fiber_host *host = fiber->host;
+
+	for (int i = 0; i < fiber->num_events; i++) {
+		k_poll_set_remove(&host->set, &fiber->events[i]);
+	}
+
+	fiber->result = result;
+	sys_dlist_remove(&fiber->node);
+	sys_dlist_append(&host->ready, &fiber->node);
+}
+
+static void fiber_run(struct sys_fiber_host *host, struct sys_fiber *fiber)
+{
+	host->current = fiber;
+	_arch_fiber_switch(&host->sp, fiber->sp);
+	host->current = NULL;
+
+	__ASSERT(*fiber->stack_base == STACK_SENTINEL,
+		 "fiber %p stack overflow\n", fiber);
+}
+
+/* runs the fibers ready now once, not the ones they make ready */
+static void run_ready(struct sys_fiber_host *host)
+{
+	sys_dnode_t *last = sys_dlist_peek_tail(&host->ready);
+	sys_dnode_t *node;
+
+	if (!last) {
+		return;
+	}
+
+	do {
+		node = sys_dlist_get(&host->ready);
+		fiber_run(host, CONTAINER_OF(node, struct sys_fiber, node));
+	} while (node != last);
+}
+
+static s32_t host_timeout(struct sys_fiber_host *host)
+{
+	struct sys_fiber *fiber;
+	s64_t deadline = 0;
+	bool timed = false;
+
+	if (!sys_dlist_is_empty(&host->ready)) {
+		return K_NO_WAIT;
+	}
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&host->waiting, fiber, node) {
+		if (fiber->timed && (!timed || fiber->deadline < deadline)) {
+			deadline = fiber->deadline;
+			timed = true;
+		}
+	}
+
+	if (!timed) {
+		return K_FOREVER;
+	}
+
+	deadline -= k_uptime_get();
+	return deadline > 0 ? (s32_t)deadline : K_NO_WAIT;
+}
+
+static struct sys_fiber *event_owner(struct sys_fiber_host *host,
+				     struct k_poll_event *event)
+{
+	struct sys_fiber *fiber;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&host->waiting, fiber, node) {
+		if (event >= fiber->events &&
+		    event < fiber->events + fiber->num_events) {
+			return fiber;
+		}
+	}
+
+	return NULL;
+}
+
+static void host_expire(struct sys_fiber_host *host)
+{
+	struct sys_fiber *fiber, *next;
+	s64_t now = k_uptime_get();
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&host->waiting, fiber, next, node) {
+		if (fiber->timed && fiber->deadline <= now) {
+			fiber_wake(fiber, -EAGAIN);
+		}
+	}
+}
+
+void sys_fiber_host_init(struct sys_fiber_host *host)
+{
+	host->thread = NULL;
+	host->current = NULL;
+	sys_dlist_init(&host->ready);
+	sys_dlist_init(&host->waiting);
+	k_poll_set_init(&host->set);
+	host->num_fibers = 0;
+}
+
+void sys_fiber_host_run(struct sys_fiber_host *host)
+{
+	struct k_poll_event *ready[READY_BATCH];
+	struct sys_fiber *fiber;
+	unsigned int key;
+	int num, i;
+
+	host->thread = k_current_get();
+	key = irq_lock();
+	sys_slist_append(&hosts, &host->node);
+	irq_unlock(key);
+
+	while (host->num_fibers) {
+		run_ready(host);
+		if (!host->num_fibers) {
+			break;
+		}
+
+		num = k_poll_set_wait(&host->set, ready, READY_BATCH,
+				      host_timeout(host));
+		for (i = 0; i < num; i++) {
+			/* NULL if woken up by an earlier event */
+			fiber = event_owner(host, ready[i]);
+			if (fiber) {
+				fiber_wake(fiber, 0);
+			}
+		}
+
+		host_expire(host);
+	}
+
+	key = irq_lock();
+	sys_slist_find_and_remove(&hosts, &host->node);
+	irq_unlock(key);
+}
+
+void sys_fiber_create(struct sys_fiber_host *host, struct sys_fiber *fiber,
+		      void *stack, size_t stack_size, sys_fiber_entry_t entry,
+		      void *arg)
+{
+	fiber->host = host;
+	fiber->entry = entry;
+	fiber->arg = arg;
+	fiber->num_events = 0;
+	fiber->stack_base = stack;
+	*fiber->stack_base = STACK_SENTINEL;
+	fiber->sp = _arch_fiber_init((char *)stack + stack_size, fiber_start);
+
+	host->num_fibers++;
+	sys_dlist_append(&host->ready, &fiber->node);
+}
+
+struct sys_fiber *sys_fiber_current(void)
+{
+	struct sys_fiber_host *host = current_host();
+
+	return host ? host->current : NULL;
+}
+
+void sys_fiber_yield(void)
+{
+	struct sys_fiber *fiber = sys_fiber_current();
+
+	__ASSERT(fiber, "not called from a fiber\n");
+
+	sys_dlist_append(&fiber->host->ready, &fiber->node);
+	fiber_suspend(fiber);
+}
+
+int sys_fiber_poll(struct k_poll_event *events, int num_events,
+		   s32_t timeout)
+{
+	struct sys_fiber *fiber = sys_fiber_current();
+	int i;
+
+	__ASSERT(fiber, "not called from a fiber\n");
+
+	if (timeout == K_NO_WAIT) {
+		if (num_events == 0) {
+			return -EAGAIN;
+		}
+		return k_poll(events, num_events, K_NO_WAIT);
+	}
+
+	for (i = 0; i < num_events; i++) {
+		k_poll_set_add(&fiber->host->set, &events[i]);
+	}
+
+	fiber->events = events;
+	fiber->num_events = num_events;
+	fiber->timed = timeout != K_FOREVER;
+	if (fiber->timed) {
+		fiber->deadline = k_uptime_get() + timeout;
+	}
+	sys_dlist_append(&fiber->host->waiting, &fiber->node);
+
+	return fiber_suspend(fiber);
+}
+
+void sys_fiber_sleep(s32_t duration)
+{
+	sys_fiber_poll(NULL, 0, duration);
+}
+
+/* remaining waiting period until end, for a timeout not K_FOREVER */
+static s32_t time_left(s64_t end, s32_t timeout)
+{
+	s64_t left;
+
+	if (timeout == K_FOREVER) {
+		return K_FOREVER;
+	}
+
+	left = end - k_uptime_get();
+	return left > 0 ? (s32_t)left : K_NO_WAIT;
+}
+
+int sys_fiber_sem_take(struct k_sem *sem, s32_t timeout)
+{
+	struct k_poll_event event;
+	s64_t end = k_uptime_get() + timeout;
+
+	if (k_sem_take(sem, K_NO_WAIT) == 0) {
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		return -EBUSY;
+	}
+
+	k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, sem);
+
+	/* another thread may take the semaphore first */
+	do {
+		if (sys_fiber_poll(&event, 1, time_left(end, timeout)) != 0) {
+			return -EAGAIN;
+		}
+	} while (k_sem_take(sem, K_NO_WAIT) != 0);
+
+	return 0;
+}
+
+void *sys_fiber_queue_get(struct k_queue *queue, s32_t timeout)
+{
+	struct k_poll_event event;
+	s64_t end = k_uptime_get() + timeout;
+	void *data;
+
+	data = k_queue_get(queue, K_NO_WAIT);
+	if (data || timeout == K_NO_WAIT) {
+		return data;
+	}
+
+	k_poll_event_init(&event, K_POLL_TYPE_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, queue);
+
+	/* another thread may get the data first */
+	do {
+		if (sys_fiber_poll(&event, 1, time_left(end, timeout)) != 0) {
+			return NULL;
+		}
+		data = k_queue_get(queue, K_NO_WAIT);
+	} while (!data);
+
+	return data;
+}
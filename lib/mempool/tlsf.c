@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <misc/__assert.h>
+#include <misc/tlsf.h>
+
+#define SL_INDEX_COUNT_LOG2 _TLSF_SL_INDEX_COUNT_LOG2
+#define SL_INDEX_COUNT _TLSF_SL_INDEX_COUNT
+#define ALIGN_SIZE _TLSF_ALIGN_SIZE
+#define FL_INDEX_SHIFT _TLSF_FL_INDEX_SHIFT
+#define FL_INDEX_COUNT _TLSF_FL_INDEX_COUNT
+#define SMALL_BLOCK_SIZE (1 << FL_INDEX_SHIFT)
+
+BUILD_ASSERT(CONFIG_TLSF_FL_INDEX_MAX < 32);
+
+/*
+ * A block starts with a pointer to the previous physical block, which is
+ * only valid while that block is free and overlaps the last word of its
+ * payload, followed by the size of the payload. The two low bits of the
+ * size, always zero as sizes are multiples of the alignment, tell whether
+ * the block and its previous physical block are free. Free blocks link
+ * into their segregated list through the first words of their payload.
+ *
+ * The last block of the heap is a zero sized, used sentinel: no block ever
+ * has to check whether it has a next physical neighbour.
+ */
+struct _tlsf_block {
+	struct _tlsf_block *prev_phys;
+	size_t size;
+	struct _tlsf_block *next_free;
+	struct _tlsf_block *prev_free;
+};
+
+#define BLOCK_FREE BIT(0)
+#define BLOCK_PREV_FREE BIT(1)
+#define BLOCK_FLAGS (BLOCK_FREE | BLOCK_PREV_FREE)
+
+/* the prev_phys word of the next block is part of the payload */
+#define BLOCK_OVERHEAD sizeof(size_t)
+#define BLOCK_START_OFFSET offsetof(struct _tlsf_block, next_free)
+#define BLOCK_SIZE_MIN (sizeof(struct _tlsf_block) - sizeof(void *))
+#define BLOCK_SIZE_MAX ((size_t)1 << CONFIG_TLSF_FL_INDEX_MAX)
+
+static inline size_t block_size(struct _tlsf_block *b)
+{
+	return b->size & ~BLOCK_FLAGS;
+}
+
+static inline void block_set_size(struct _tlsf_block *b, size_t size)
+{
+	b->size = size | (b->size & BLOCK_FLAGS);
+}
+
+static inline bool block_is_free(struct _tlsf_block *b)
+{
+	return (b->size & BLOCK_FREE) != 0;
+}
+
+static inline bool block_is_prev_free(struct _tlsf_block *b)
+{
+	return (b->size & BLOCK_PREV_FREE) != 0;
+}
+
+static inline void *block_to_ptr(struct _tlsf_block *b)
+{
+	return (char *)b + BLOCK_START_OFFSET;
+}
+
+static inline struct _tlsf_block *block_from_ptr(void *ptr)
+{
+	return (struct _tlsf_block *)((char *)ptr - BLOCK_START_OFFSET);
+}
+
+static inline struct _tlsf_block *block_next(struct _tlsf_block *b)
+{
+	return (struct _tlsf_block *)((char *)block_to_ptr(b) +
+				      block_size(b) - BLOCK_OVERHEAD);
+}
+
+static struct _tlsf_block *block_link_next(struct _tlsf_block *b)
+{
+	struct _tlsf_block *next = block_next(b);
+
+	next->prev_phys = b;
+	return next;
+}
+
+static void block_mark_free(struct _tlsf_block *b)
+{
+	struct _tlsf_block *next = block_link_next(b);
+
+	next->size |= BLOCK_PREV_FREE;
+	b->size |= BLOCK_FREE;
+}
+
+static void block_mark_used(struct _tlsf_block *b)
+{
+	struct _tlsf_block *next = block_next(b);
+
+	next->size &= ~BLOCK_PREV_FREE;
+	b->size &= ~BLOCK_FREE;
+}
+
+/* index of the most significant bit set, size must not be zero */
+static inline int msb(size_t size)
+{
+	return find_msb_set((u32_t)size) - 1;
+}
+
+/* list a free block of this size belongs to */
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+	if (size < SMALL_BLOCK_SIZE) {
+		*fl = 0;
+		*sl = size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+	} else {
+		int bit = msb(size);
+
+		*fl = bit - FL_INDEX_SHIFT + 1;
+		*sl = (size >> (bit - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+	}
+}
+
+/* first list whose blocks are all large enough for this size */
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+	if (size >= SMALL_BLOCK_SIZE) {
+		size += ((size_t)1 << (msb(size) - SL_INDEX_COUNT_LOG2)) - 1;
+	}
+
+	mapping_insert(size, fl, sl);
+}
+
+/* size of the smallest blocks a list can hold */
+static size_t mapping_size(int fl, int sl)
+{
+	if (fl == 0) {
+		return sl * (SMALL_BLOCK_SIZE / SL_INDEX_COUNT);
+	}
+
+	return (size_t)(SL_INDEX_COUNT + sl) <<
+		(fl + FL_INDEX_SHIFT - 1 - SL_INDEX_COUNT_LOG2);
+}
+
+static struct _tlsf_block *search_suitable_block(struct sys_tlsf *heap,
+						 int *fl, int *sl)
+{
+	u32_t sl_map = heap->sl_bitmap[*fl] & (~0U << *sl);
+
+	if (sl_map == 0) {
+		u32_t fl_map = heap->fl_bitmap & (~0U << (*fl + 1));
+
+		if (fl_map == 0) {
+			return NULL;
+		}
+
+		*fl = find_lsb_set(fl_map) - 1;
+		sl_map = heap->sl_bitmap[*fl];
+	}
+
+	*sl = find_lsb_set(sl_map) - 1;
+
+	return heap->blocks[*fl][*sl];
+}
+
+static void remove_free_block(struct sys_tlsf *heap, struct _tlsf_block *b,
+			      int fl, int sl)
+{
+	struct _tlsf_block *prev = b->prev_free;
+	struct _tlsf_block *next = b->next_free;
+
+	if (next != NULL) {
+		next->prev_free = prev;
+	}
+
+	if (prev != NULL) {
+		prev->next_free = next;
+	} else {
+		heap->blocks[fl][sl] = next;
+		if (next == NULL) {
+			heap->sl_bitmap[fl] &= ~BIT(sl);
+			if (heap->sl_bitmap[fl] == 0) {
+				heap->fl_bitmap &= ~BIT(fl);
+			}
+		}
+	}
+
+	heap->free_bytes -= block_size(b);
+}
+
+static void insert_free_block(struct sys_tlsf *heap, struct _tlsf_block *b,
+			      int fl, int sl)
+{
+	struct _tlsf_block *head = heap->blocks[fl][sl];
+
+	b->next_free = head;
+	b->prev_free = NULL;
+	if (head != NULL) {
+		head->prev_free = b;
+	}
+
+	heap->blocks[fl][sl] = b;
+	heap->fl_bitmap |= BIT(fl);
+	heap->sl_bitmap[fl] |= BIT(sl);
+
+	heap->free_bytes += block_size(b);
+}
+
+static void block_remove(struct sys_tlsf *heap, struct _tlsf_block *b)
+{
+	int fl, sl;
+
+	mapping_insert(block_size(b), &fl, &sl);
+	remove_free_block(heap, b, fl, sl);
+}
+
+static void block_insert(struct sys_tlsf *heap, struct _tlsf_block *b)
+{
+	int fl, sl;
+
+	mapping_insert(block_size(b), &fl, &sl);
+	insert_free_block(heap, b, fl, sl);
+}
+
+/* split the tail of a block off into a new free block */
+static struct _tlsf_block *block_split(struct _tlsf_block *b, size_t size)
+{
+	struct _tlsf_block *rest = (struct _tlsf_block *)
+		((char *)block_to_ptr(b) + size - BLOCK_OVERHEAD);
+
+	rest->size = block_size(b) - (size + BLOCK_OVERHEAD);
+	block_set_size(b, size);
+	block_mark_free(rest);
+
+	return rest;
+}
+
+/* merge a block into its previous physical block */
+static struct _tlsf_block *block_absorb(struct _tlsf_block *prev,
+					struct _tlsf_block *b)
+{
+	prev->size += block_size(b) + BLOCK_OVERHEAD;
+	block_link_next(prev);
+
+	return prev;
+}
+
+int sys_tlsf_init(struct sys_tlsf *heap, void *mem, size_t bytes)
+{
+	uintptr_t start = ROUND_UP((uintptr_t)mem, ALIGN_SIZE);
+	uintptr_t end = ROUND_DOWN((uintptr_t)mem + bytes, ALIGN_SIZE);
+	struct _tlsf_block *b, *sentinel;
+	size_t size;
+
+	if (end < start + BLOCK_START_OFFSET + BLOCK_SIZE_MIN + BLOCK_OVERHEAD) {
+		return -EINVAL;
+	}
+
+	/*
+	 * The sentinel header sits in the last two words, its prev_phys
+	 * overlapping the payload of the first block.
+	 */
+	size = end - start - BLOCK_START_OFFSET - BLOCK_OVERHEAD;
+	size = min(size, BLOCK_SIZE_MAX - ALIGN_SIZE);
+
+	memset(heap, 0, sizeof(*heap));
+	heap->buf = (char *)start;
+	heap->size = BLOCK_START_OFFSET + size + BLOCK_OVERHEAD;
+
+	b = (struct _tlsf_block *)start;
+	b->size = size;
+	sentinel = block_next(b);
+	sentinel->size = 0;
+	block_mark_free(b);
+	block_insert(heap, b);
+
+	return 0;
+}
+
+void *sys_tlsf_alloc(struct sys_tlsf *heap, size_t size)
+{
+	struct _tlsf_block *b;
+	int fl, sl;
+
+	if (size == 0 || size > BLOCK_SIZE_MAX) {
+		return NULL;
+	}
+
+	size = max(ROUND_UP(size, ALIGN_SIZE), BLOCK_SIZE_MIN);
+
+	mapping_search(size, &fl, &sl);
+	if (fl >= FL_INDEX_COUNT) {
+		return NULL;
+	}
+
+	b = search_suitable_block(heap, &fl, &sl);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	__ASSERT(block_size(b) >= size, "corrupted TLSF heap");
+	remove_free_block(heap, b, fl, sl);
+
+	if (block_size(b) >= size + sizeof(struct _tlsf_block)) {
+		block_insert(heap, block_split(b, size));
+	}
+
+	block_mark_used(b);
+	heap->used_bytes += block_size(b) + BLOCK_OVERHEAD;
+
+	return block_to_ptr(b);
+}
+
+void sys_tlsf_free(struct sys_tlsf *heap, void *ptr)
+{
+	struct _tlsf_block *b, *next;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	b = block_from_ptr(ptr);
+	__ASSERT(sys_tlsf_contains(heap, ptr), "pointer outside of TLSF heap");
+	__ASSERT(!block_is_free(b), "TLSF block freed twice");
+
+	heap->used_bytes -= block_size(b) + BLOCK_OVERHEAD;
+	block_mark_free(b);
+
+	if (block_is_prev_free(b)) {
+		struct _tlsf_block *prev = b->prev_phys;
+
+		block_remove(heap, prev);
+		b = block_absorb(prev, b);
+	}
+
+	next = block_next(b);
+	if (block_is_free(next)) {
+		block_remove(heap, next);
+		b = block_absorb(b, next);
+	}
+
+	block_insert(heap, b);
+}
+
+void sys_tlsf_stats_get(struct sys_tlsf *heap, struct sys_tlsf_stats *stats)
+{
+	size_t largest = 0, largest_alloc = 0;
+
+	if (heap->fl_bitmap != 0) {
+		int fl = find_msb_set(heap->fl_bitmap) - 1;
+		int sl = find_msb_set(heap->sl_bitmap[fl]) - 1;
+		struct _tlsf_block *b;
+
+		for (b = heap->blocks[fl][sl]; b != NULL; b = b->next_free) {
+			largest = max(largest, block_size(b));
+		}
+
+		/*
+		 * Requests are rounded up to the next list before searching,
+		 * so only those not larger than the smallest size of the top
+		 * list are sure to find its blocks.
+		 */
+		largest_alloc = mapping_size(fl, sl);
+	}
+
+	stats->free_bytes = heap->free_bytes;
+	stats->used_bytes = heap->used_bytes;
+	stats->largest_free = largest_alloc;
+	stats->fragmentation = heap->free_bytes == 0 ? 0 :
+		100 - (u32_t)((u64_t)largest * 100 / heap->free_bytes);
+}
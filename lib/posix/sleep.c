@@ -6,6 +6,7 @@
 
 #include <kernel.h>
 #include <posix/unistd.h>
+#include <posix/time.h>
 
 /**
  * @brief Sleep for a specified number of seconds.
@@ -32,3 +33,58 @@ int usleep(useconds_t useconds)
 
 	return 0;
 }
+
+/**
+ * @brief Suspend execution until a relative or an absolute time elapses.
+ *
+ * Only CLOCK_MONOTONIC is supported. The sleep time is rounded up to the
+ * next millisecond, and a sleep is never interrupted, so that @a rmtp is
+ * always set to zero.
+ *
+ * See IEEE 1003.1
+ */
+int clock_nanosleep(clockid_t clock_id, int flags,
+		    const struct timespec *rqtp, struct timespec *rmtp)
+{
+	s64_t msecs;
+
+	if (clock_id != CLOCK_MONOTONIC || rqtp->tv_sec < 0 ||
+	    rqtp->tv_nsec < 0 || rqtp->tv_nsec >= NSEC_PER_SEC) {
+		return EINVAL;
+	}
+
+	msecs = (s64_t)rqtp->tv_sec * MSEC_PER_SEC +
+		(rqtp->tv_nsec + NSEC_PER_MSEC - 1) / NSEC_PER_MSEC;
+
+	if (flags & TIMER_ABSTIME) {
+		msecs -= k_uptime_get();
+	}
+
+	if (msecs > 0) {
+		k_sleep((s32_t)min(msecs, (s64_t)INT32_MAX));
+	}
+
+	if (rmtp != NULL && !(flags & TIMER_ABSTIME)) {
+		rmtp->tv_sec = 0;
+		rmtp->tv_nsec = 0;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Suspend execution for nanosecond intervals.
+ *
+ * See IEEE 1003.1
+ */
+int nanosleep(const struct timespec *rqtp, struct timespec *rmtp)
+{
+	int ret = clock_nanosleep(CLOCK_MONOTONIC, 0, rqtp, rmtp);
+
+	if (ret != 0) {
+		errno = ret;
+		return -1;
+	}
+
+	return 0;
+}
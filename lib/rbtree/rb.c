@@ -98,13 +98,42 @@ static int find_and_stack(struct rbtree *tree, struct rbnode *node,
 
 struct rbnode *_rb_get_minmax(struct rbtree *tree, int side)
 {
-	struct rbnode *n;
+	return tree->minmax[side];
+}
+
+/* Returns the node next to the lowest (side 0) or highest (side 1)
+ * sorted node, which is at the top of the stack.  Such a node has no
+ * child on that side.
+ */
+static struct rbnode *get_minmax_next(struct rbnode **stack, int stacksz,
+				      int side)
+{
+	struct rbnode *n = get_child(stack[stacksz - 1], !side);
+
+	if (!n) {
+		return stacksz > 1 ? stack[stacksz - 2] : NULL;
+	}
+
+	while (get_child(n, side)) {
+		n = get_child(n, side);
+	}
 
-	for (n = tree->root; n && get_child(n, side); n = get_child(n, side))
-		;
 	return n;
 }
 
+/* Updates the augmented data of the nodes in the stack, from its top
+ * up to the root
+ */
+static void augment_path(struct rbtree *tree, struct rbnode **stack,
+			 int stacksz)
+{
+	if (tree->augment_fn) {
+		while (stacksz > 0) {
+			tree->augment_fn(stack[--stacksz]);
+		}
+	}
+}
+
 static int get_side(struct rbnode *parent, struct rbnode *child)
 {
 	CHECK(get_child(parent, 0) == child || get_child(parent, 1) == child);
@@ -122,7 +151,7 @@ static int get_side(struct rbnode *parent, struct rbnode *child)
  * a b            b c
  *
  */
-static void rotate(struct rbnode **stack, int stacksz)
+static void rotate(struct rbtree *tree, struct rbnode **stack, int stacksz)
 {
 	CHECK(stacksz >= 2);
 
@@ -143,13 +172,20 @@ static void rotate(struct rbnode **stack, int stacksz)
 	set_child(parent, side, b);
 	stack[stacksz - 2] = child;
 	stack[stacksz - 1] = parent;
+
+	/* The subtree keeps the same nodes, only these two changed */
+	if (tree->augment_fn) {
+		tree->augment_fn(parent);
+		tree->augment_fn(child);
+	}
 }
 
 /* The node at the top of the provided stack is red, and its parent is
  * too.  Iteratively fix the tree so it becomes a valid red black tree
  * again
  */
-static void fix_extra_red(struct rbnode **stack, int stacksz)
+static void fix_extra_red(struct rbtree *tree, struct rbnode **stack,
+			  int stacksz)
 {
 	while (stacksz > 1) {
 		struct rbnode *node = stack[stacksz - 1];
@@ -192,12 +228,12 @@ static void fix_extra_red(struct rbnode **stack, int stacksz)
 		int parent_side = get_side(parent, node);
 
 		if (parent_side != side) {
-			rotate(stack, stacksz);
+			rotate(tree, stack, stacksz);
 			node = stack[stacksz - 1];
 		}
 
 		/* Rotate the grandparent with parent, swapping colors */
-		rotate(stack, stacksz - 1);
+		rotate(tree, stack, stacksz - 1);
 		set_color(stack[stacksz - 3], BLACK);
 		set_color(stack[stacksz - 2], RED);
 		return;
@@ -217,7 +253,10 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
 	if (!tree->root) {
 		tree->root = node;
 		tree->max_depth = 1;
+		tree->minmax[0] = node;
+		tree->minmax[1] = node;
 		set_color(node, BLACK);
+		augment_path(tree, &node, 1);
 		return;
 	}
 
@@ -232,8 +271,17 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
 	set_child(parent, side, node);
 	set_color(node, RED);
 
+	/* Nodes sorting equal go after those already in the tree */
+	if (tree->lessthan_fn(node, tree->minmax[0])) {
+		tree->minmax[0] = node;
+	}
+	if (!tree->lessthan_fn(node, tree->minmax[1])) {
+		tree->minmax[1] = node;
+	}
+
 	stack[stacksz++] = node;
-	fix_extra_red(stack, stacksz);
+	augment_path(tree, stack, stacksz);
+	fix_extra_red(tree, stack, stacksz);
 
 	if (stacksz > tree->max_depth) {
 		tree->max_depth = stacksz;
@@ -254,8 +302,8 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
  * then clean it up (replace it with a simple NULL child in the
  * parent) when finished.
  */
-static void fix_missing_black(struct rbnode **stack, int stacksz,
-			      struct rbnode *null_node)
+static void fix_missing_black(struct rbtree *tree, struct rbnode **stack,
+			      int stacksz, struct rbnode *null_node)
 {
 	/* Loop upward until we reach the root */
 	while (stacksz > 1) {
@@ -274,7 +322,7 @@ static void fix_missing_black(struct rbnode **stack, int stacksz,
 		 */
 		if (!is_black(sib)) {
 			stack[stacksz - 1] = sib;
-			rotate(stack, stacksz);
+			rotate(tree, stack, stacksz);
 			set_color(parent, RED);
 			set_color(sib, BLACK);
 			stack[stacksz++] = n;
@@ -293,6 +341,7 @@ static void fix_missing_black(struct rbnode **stack, int stacksz,
 		if ((!c0 || is_black(c0)) && (!c1 || is_black(c1))) {
 			if (n == null_node) {
 				set_child(parent, n_side, NULL);
+				augment_path(tree, stack, stacksz - 1);
 			}
 
 			set_color(sib, RED);
@@ -323,7 +372,7 @@ static void fix_missing_black(struct rbnode **stack, int stacksz,
 
 			stack[stacksz - 1] = sib;
 			stack[stacksz++] = inner;
-			rotate(stack, stacksz);
+			rotate(tree, stack, stacksz);
 			set_color(sib, RED);
 			set_color(inner, BLACK);
 
@@ -345,9 +394,10 @@ static void fix_missing_black(struct rbnode **stack, int stacksz,
 		set_color(parent, BLACK);
 		set_color(outer, BLACK);
 		stack[stacksz - 1] = sib;
-		rotate(stack, stacksz);
+		rotate(tree, stack, stacksz);
 		if (n == null_node) {
 			set_child(parent, n_side, NULL);
+			augment_path(tree, stack, stacksz);
 		}
 		return;
 	}
@@ -363,6 +413,16 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 		return;
 	}
 
+	/* The cached nodes have no child on their side, so there is no
+	 * need to swap them below, and the stack still is their path
+	 */
+	for (int side = 0; side < 2; side++) {
+		if (node == tree->minmax[side]) {
+			tree->minmax[side] = get_minmax_next(stack, stacksz,
+							     side);
+		}
+	}
+
 	/* We can only remove a node with zero or one child, if we
 	 * have two then pick the "biggest" child of side 0 (smallest
 	 * of 1 would work too) and swap our spot in the tree with
@@ -455,13 +515,19 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 	 */
 	if (!child) {
 		if (is_black(node)) {
-			fix_missing_black(stack, stacksz, node);
+			/* node still counts in the subtrees above it,
+			 * until fix_missing_black() unlinks it
+			 */
+			augment_path(tree, stack, stacksz);
+			fix_missing_black(tree, stack, stacksz, node);
 		} else {
 			/* Red childless nodes can just be dropped */
 			set_child(parent, get_side(parent, node), NULL);
+			augment_path(tree, stack, stacksz - 1);
 		}
 	} else {
 		set_child(parent, get_side(parent, node), child);
+		augment_path(tree, stack, stacksz - 1);
 
 		/* Check colors, if one was red (at least one must have been
 		 * black in a valid tree), then we're done.  Otherwise we have
@@ -471,7 +537,7 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 			set_color(child, BLACK);
 		} else {
 			stack[stacksz - 1] = child;
-			fix_missing_black(stack, stacksz, NULL);
+			fix_missing_black(tree, stack, stacksz, NULL);
 		}
 	}
 
@@ -7,6 +7,7 @@
  */
 
 #include <ring_buffer.h>
+#include <string.h>
 
 /**
  * Internal data structure for a buffer header.
@@ -92,3 +93,106 @@ int sys_ring_buf_get(struct ring_buf *buf, u16_t *type, u8_t *value,
 
 	return 0;
 }
+
+/*
+ * Orders the accesses to the bytes stored in a byte ring buffer with the
+ * position updates handing them over between the producer and the
+ * consumer. Each side only writes its own position, so no lock is needed.
+ */
+#ifdef CONFIG_SMP
+#define byte_ring_barrier() __sync_synchronize()
+#else
+#define byte_ring_barrier() compiler_barrier()
+#endif
+
+static inline void byte_ring_advance(u32_t *pos, u32_t size)
+{
+	byte_ring_barrier();
+	*(volatile u32_t *)pos = *pos + size;
+}
+
+u32_t sys_byte_ring_put_claim(struct byte_ring *ring, u8_t **data,
+			      u32_t size)
+{
+	u32_t offset = ring->tail & ring->mask;
+	u32_t avail = sys_byte_ring_space_get(ring);
+
+	size = min(size, avail);
+	size = min(size, ring->mask + 1 - offset);
+
+	byte_ring_barrier();
+	*data = &ring->buf[offset];
+
+	return size;
+}
+
+int sys_byte_ring_put_commit(struct byte_ring *ring, u32_t size)
+{
+	if (size > sys_byte_ring_space_get(ring)) {
+		return -EINVAL;
+	}
+
+	byte_ring_advance(&ring->tail, size);
+
+	return 0;
+}
+
+u32_t sys_byte_ring_get_claim(struct byte_ring *ring, u8_t **data,
+			      u32_t size)
+{
+	u32_t offset = ring->head & ring->mask;
+	u32_t avail = sys_byte_ring_used_get(ring);
+
+	size = min(size, avail);
+	size = min(size, ring->mask + 1 - offset);
+
+	byte_ring_barrier();
+	*data = &ring->buf[offset];
+
+	return size;
+}
+
+int sys_byte_ring_get_commit(struct byte_ring *ring, u32_t size)
+{
+	if (size > sys_byte_ring_used_get(ring)) {
+		return -EINVAL;
+	}
+
+	byte_ring_advance(&ring->head, size);
+
+	return 0;
+}
+
+u32_t sys_byte_ring_put(struct byte_ring *ring, const u8_t *data, u32_t size)
+{
+	u32_t offset = ring->tail & ring->mask;
+	u32_t avail = sys_byte_ring_space_get(ring);
+	u32_t first;
+
+	size = min(size, avail);
+	first = min(size, ring->mask + 1 - offset);
+
+	byte_ring_barrier();
+	memcpy(&ring->buf[offset], data, first);
+	memcpy(ring->buf, data + first, size - first);
+	byte_ring_advance(&ring->tail, size);
+
+	return size;
+}
+
+u32_t sys_byte_ring_get(struct byte_ring *ring, u8_t *data, u32_t size)
+{
+	u32_t offset = ring->head & ring->mask;
+	u32_t avail = sys_byte_ring_used_get(ring);
+	u32_t first;
+
+	size = min(size, avail);
+	first = min(size, ring->mask + 1 - offset);
+
+	byte_ring_barrier();
+	memcpy(data, &ring->buf[offset], first);
+	memcpy(data + first, ring->buf, size - first);
+	byte_ring_advance(&ring->head, size);
+
+	return size;
+}
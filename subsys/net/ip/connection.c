@@ -346,6 +346,219 @@ static inline void cache_remove(struct net_conn *conn)
 #define cache_remove(...)
 #endif /* CONFIG_NET_CONN_CACHE */
 
+#if defined(CONFIG_NET_CONN_HASH)
+
+/* A connection is kept in one of these lists, depending on what it matches:
+ *
+ *   connected  local port, remote port and specific remote address set,
+ *              hashed on the protocol, ports and remote address
+ *   bound      other connections with a local port set, hashed on the
+ *              protocol and local port
+ *   wildcard   connections without a local port
+ *
+ * so a packet can only match the connections of one bucket of each table
+ * and of the wildcard list. The lists are sorted by position in conns, and
+ * are merged when receiving to visit the connections in the same order as
+ * a scan of conns would, as the best match depends on that order.
+ */
+BUILD_ASSERT_MSG(!(CONFIG_NET_CONN_HASH_SIZE &
+		   (CONFIG_NET_CONN_HASH_SIZE - 1)),
+		 "CONFIG_NET_CONN_HASH_SIZE must be a power of two");
+
+static sys_slist_t conn_connected[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_bound[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_wildcard;
+
+/** Connections that may match a packet, merged by position in conns */
+struct conn_iter {
+	sys_snode_t *next[3];
+};
+
+static inline u32_t conn_bucket(u32_t key)
+{
+	/* Fibonacci hashing, the high bits of the product depend on
+	 * all the bits of the key.
+	 */
+	return ((key * 2654435769U) >> 16) & (CONFIG_NET_CONN_HASH_SIZE - 1);
+}
+
+static u32_t addr_hash(const u8_t *addr, size_t len)
+{
+	u32_t hash = 0;
+
+	while (len--) {
+		hash = hash * 31 + *addr++;
+	}
+
+	return hash;
+}
+
+/* Ports are in network byte order */
+static inline sys_slist_t *connected_list(enum net_ip_protocol proto,
+					  u32_t addr,
+					  u16_t remote_port,
+					  u16_t local_port)
+{
+	return &conn_connected[conn_bucket(addr ^ proto ^
+					   (local_port << 16 | remote_port))];
+}
+
+static inline sys_slist_t *bound_list(enum net_ip_protocol proto,
+				      u16_t local_port)
+{
+	return &conn_bound[conn_bucket(proto << 16 | local_port)];
+}
+
+/* Return the list holding the connections registered with these values,
+ * ports being in network byte order.
+ */
+static sys_slist_t *conn_list(enum net_ip_protocol proto,
+			      const struct sockaddr *remote_addr,
+			      u16_t remote_port,
+			      u16_t local_port)
+{
+	if (!local_port) {
+		return &conn_wildcard;
+	}
+
+	if (remote_port && remote_addr) {
+#if defined(CONFIG_NET_IPV6)
+		if (remote_addr->sa_family == AF_INET6 &&
+		    !net_is_ipv6_addr_unspecified(
+			    &net_sin6(remote_addr)->sin6_addr)) {
+			return connected_list(proto,
+				addr_hash(net_sin6(remote_addr)->
+					  sin6_addr.s6_addr,
+					  sizeof(struct in6_addr)),
+				remote_port, local_port);
+		}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+		if (remote_addr->sa_family == AF_INET &&
+		    net_sin(remote_addr)->sin_addr.s_addr) {
+			return connected_list(proto,
+				addr_hash(net_sin(remote_addr)->
+					  sin_addr.s4_addr,
+					  sizeof(struct in_addr)),
+				remote_port, local_port);
+		}
+#endif
+	}
+
+	return bound_list(proto, local_port);
+}
+
+static sys_slist_t *conn_list_of(struct net_conn *conn)
+{
+	return conn_list(conn->proto,
+			 conn->flags & NET_CONN_REMOTE_ADDR_SET ?
+			 &conn->remote_addr : NULL,
+			 net_sin(&conn->remote_addr)->sin_port,
+			 net_sin(&conn->local_addr)->sin_port);
+}
+
+static void conn_hash_add(struct net_conn *conn)
+{
+	sys_slist_t *list = conn_list_of(conn);
+	sys_snode_t *node, *prev = NULL;
+
+	SYS_SLIST_FOR_EACH_NODE(list, node) {
+		if (node > &conn->node) {
+			break;
+		}
+
+		prev = node;
+	}
+
+	sys_slist_insert(list, prev, &conn->node);
+}
+
+static inline void conn_hash_remove(struct net_conn *conn)
+{
+	sys_slist_find_and_remove(conn_list_of(conn), &conn->node);
+}
+
+static inline void conn_iter_init_register(struct conn_iter *iter,
+					   enum net_ip_protocol proto,
+					   const struct sockaddr *remote_addr,
+					   u16_t remote_port,
+					   u16_t local_port)
+{
+	iter->next[0] = sys_slist_peek_head(conn_list(proto, remote_addr,
+						      htons(remote_port),
+						      htons(local_port)));
+	iter->next[1] = NULL;
+	iter->next[2] = NULL;
+}
+
+static void conn_iter_init_pkt(struct conn_iter *iter,
+			       enum net_ip_protocol proto,
+			       struct net_pkt *pkt,
+			       u16_t src_port,
+			       u16_t dst_port)
+{
+	u32_t hash = 0;
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_pkt_family(pkt) == AF_INET6) {
+		hash = addr_hash(NET_IPV6_HDR(pkt)->src.s6_addr,
+				 sizeof(struct in6_addr));
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(pkt) == AF_INET) {
+		hash = addr_hash(NET_IPV4_HDR(pkt)->src.s4_addr,
+				 sizeof(struct in_addr));
+	}
+#endif
+
+	iter->next[0] = sys_slist_peek_head(connected_list(proto, hash,
+							   src_port,
+							   dst_port));
+	iter->next[1] = sys_slist_peek_head(bound_list(proto, dst_port));
+	iter->next[2] = sys_slist_peek_head(&conn_wildcard);
+}
+
+/* Return the position in conns of the next connection, or -1 */
+static int conn_iter_next(struct conn_iter *iter)
+{
+	sys_snode_t **first = NULL;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(iter->next); i++) {
+		if (iter->next[i] && (!first || iter->next[i] < *first)) {
+			first = &iter->next[i];
+		}
+	}
+
+	if (!first) {
+		return -1;
+	}
+
+	i = CONTAINER_OF(*first, struct net_conn, node) - conns;
+	*first = sys_slist_peek_next_no_check(*first);
+
+	return i;
+}
+#else
+/** Connections that may match a packet, that is all of them */
+struct conn_iter {
+	int next;
+};
+
+static inline int conn_iter_next(struct conn_iter *iter)
+{
+	return iter->next < CONFIG_NET_MAX_CONN ? iter->next++ : -1;
+}
+
+#define conn_iter_init_register(iter, ...) ((iter)->next = 0)
+#define conn_iter_init_pkt(iter, ...) ((iter)->next = 0)
+#define conn_hash_add(...)
+#define conn_hash_remove(...)
+#endif /* CONFIG_NET_CONN_HASH */
+
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
@@ -359,6 +572,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	}
 
 	cache_remove(conn);
+	conn_hash_remove(conn);
 
 	NET_DBG("[%zu] connection handler %p removed",
 		(conn - conns) / sizeof(*conn), conn);
@@ -450,9 +664,13 @@ static int find_conn_handler(enum net_ip_protocol proto,
 			     u16_t remote_port,
 			     u16_t local_port)
 {
+	struct conn_iter iter;
 	int i;
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
+	conn_iter_init_register(&iter, proto, remote_addr, remote_port,
+				local_port);
+
+	while ((i = conn_iter_next(&iter)) >= 0) {
 		if (!(conns[i].flags & NET_CONN_IN_USE)) {
 			continue;
 		}
@@ -676,6 +894,8 @@ int net_conn_register(enum net_ip_protocol proto,
 		conns[i].rank = rank;
 		conns[i].proto = proto;
 
+		conn_hash_add(&conns[i]);
+
 		/* Cache needs to be cleared if new entries are added. */
 		cache_clear();
 
@@ -810,6 +1030,7 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 	u16_t src_port, dst_port;
 	u16_t chksum;
 	struct net_if *pkt_iface = net_pkt_iface(pkt);
+	struct conn_iter iter;
 
 #if defined(CONFIG_NET_CONN_CACHE)
 	enum net_verdict verdict;
@@ -881,7 +1102,9 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 			net_pkt_family(pkt), ntohs(chksum), data_len);
 	}
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
+	conn_iter_init_pkt(&iter, proto, pkt, src_port, dst_port);
+
+	while ((i = conn_iter_next(&iter)) >= 0) {
 		if (!(conns[i].flags & NET_CONN_IN_USE)) {
 			continue;
 		}
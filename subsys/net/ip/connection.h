@@ -45,6 +45,11 @@ typedef enum net_verdict (*net_conn_cb_t)(struct net_conn *conn,
  *
  */
 struct net_conn {
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Node in the hash bucket of the connection */
+	sys_snode_t node;
+#endif
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
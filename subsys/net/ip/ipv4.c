@@ -74,7 +74,12 @@ void net_ipv4_finalize(struct net_pkt *pkt, u8_t next_header_proto)
 	/* Set the length of the IPv4 header */
 	size_t total_len;
 
-	net_pkt_compact(pkt);
+	/* A driver sending from the fragments does not need them filled,
+	 * packets with no interface yet are compacted as any other
+	 */
+	if (!net_pkt_iface(pkt) || !net_if_is_tx_sg(net_pkt_iface(pkt))) {
+		net_pkt_compact(pkt);
+	}
 
 	total_len = net_pkt_get_len(pkt);
 
@@ -118,7 +118,12 @@ int net_ipv6_finalize(struct net_pkt *pkt, u8_t next_header_proto)
 		}
 	}
 #endif
-	net_pkt_compact(pkt);
+	/* A driver sending from the fragments does not need them filled,
+	 * packets with no interface yet are compacted as any other
+	 */
+	if (!net_pkt_iface(pkt) || !net_if_is_tx_sg(net_pkt_iface(pkt))) {
+		net_pkt_compact(pkt);
+	}
 
 	total_len = net_pkt_get_len(pkt) - sizeof(struct net_ipv6_hdr);
 
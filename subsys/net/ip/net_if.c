@@ -142,9 +142,24 @@ static inline void net_context_send_cb(struct net_context *context,
 	}
 }
 
-static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
+static int net_if_send(struct net_if *iface, struct net_pkt *pkt)
 {
 	const struct net_if_api *api = net_if_get_device(iface)->driver_api;
+	struct net_iovec iov[NET_IF_MAX_IOV];
+	int iovcnt;
+
+	if (api->send_iov) {
+		iovcnt = net_pkt_get_iovec(pkt, iov, ARRAY_SIZE(iov));
+		if (iovcnt > 0) {
+			return api->send_iov(iface, pkt, iov, iovcnt);
+		}
+	}
+
+	return api->send(iface, pkt);
+}
+
+static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
+{
 	struct net_linkaddr *dst;
 	struct net_context *context;
 	void *context_token;
@@ -166,7 +181,7 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 			net_pkt_set_queued(pkt, false);
 		}
 
-		status = api->send(iface, pkt);
+		status = net_if_send(iface, pkt);
 	} else {
 		/* Drop packet if interface is not up */
 		NET_WARN("iface %p is down", iface);
@@ -236,6 +251,10 @@ static inline void init_iface(struct net_if *iface)
 
 	NET_DBG("On iface %p", iface);
 
+	if (api->send_iov) {
+		atomic_set_bit(iface->if_dev->flags, NET_IF_TX_SG);
+	}
+
 	api->init(iface);
 }
 
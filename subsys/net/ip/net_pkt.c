@@ -1082,6 +1082,33 @@ int net_frag_linearize(u8_t *dst, size_t dst_len, struct net_pkt *src,
 	return net_buf_linearize(dst, dst_len, src->frags, offset, len);
 }
 
+int net_pkt_get_iovec(struct net_pkt *pkt, struct net_iovec *iov, int iovcnt)
+{
+	struct net_buf *frag;
+	int count = 0;
+
+	for (frag = pkt->frags; frag; frag = frag->frags) {
+		if (!frag->len && frag != pkt->frags) {
+			continue;
+		}
+
+		if (count == iovcnt) {
+			return -E2BIG;
+		}
+
+		iov[count].base = frag->data;
+		iov[count].len = frag->len;
+		count++;
+	}
+
+	if (count) {
+		iov[0].base = net_pkt_ll(pkt);
+		iov[0].len += net_pkt_ll_reserve(pkt);
+	}
+
+	return count;
+}
+
 bool net_pkt_compact(struct net_pkt *pkt)
 {
 	struct net_buf *frag, *prev;
@@ -39,7 +39,7 @@
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -254,12 +254,242 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_TRIE)
+
+/* Routes are indexed by a path compressed binary trie of their prefixes.
+ * A node holds the routes of its prefix, and its children the longer
+ * prefixes continuing it with a 0 or a 1 bit. Nodes without routes only
+ * exist to branch, so there are less than two nodes per route.
+ */
+struct route_trie_node {
+	/** Routes of this prefix */
+	sys_slist_t routes;
+
+	struct route_trie_node *child[2];
+
+	/** Prefix, the bits after len being zero */
+	struct in6_addr prefix;
+
+	u8_t len;
+};
+
+K_MEM_SLAB_DEFINE(route_trie_slab, sizeof(struct route_trie_node),
+		  2 * CONFIG_NET_MAX_ROUTES, 4);
+
+static struct route_trie_node *route_trie;
+
+static inline int prefix_bit(const struct in6_addr *addr, u8_t bit)
+{
+	return (addr->s6_addr[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+/* Length of the common prefix of two addresses, up to max bits */
+static u8_t common_prefix_len(const struct in6_addr *addr1,
+			      const struct in6_addr *addr2,
+			      u8_t max)
+{
+	u8_t len = 0;
+	int i;
+
+	for (i = 0; i < sizeof(struct in6_addr) && len < max; i++) {
+		u8_t diff = addr1->s6_addr[i] ^ addr2->s6_addr[i];
+
+		if (diff) {
+			len += __builtin_clz(diff) - 24;
+			break;
+		}
+
+		len += 8;
+	}
+
+	return min(len, max);
+}
+
+static struct route_trie_node *trie_node_alloc(const struct in6_addr *addr,
+					       u8_t len)
+{
+	struct route_trie_node *node;
+	int i;
+
+	/* Cannot fail, the slab holds as many nodes as needed */
+	k_mem_slab_alloc(&route_trie_slab, (void **)&node, K_NO_WAIT);
+
+	sys_slist_init(&node->routes);
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	node->len = len;
+
+	for (i = 0; i < sizeof(struct in6_addr); i++) {
+		if (len >= 8 * (i + 1)) {
+			node->prefix.s6_addr[i] = addr->s6_addr[i];
+		} else if (len > 8 * i) {
+			node->prefix.s6_addr[i] = addr->s6_addr[i] &
+				(0xff << (8 * (i + 1) - len));
+		} else {
+			node->prefix.s6_addr[i] = 0;
+		}
+	}
+
+	return node;
+}
+
+static inline void trie_node_free(struct route_trie_node *node)
+{
+	k_mem_slab_free(&route_trie_slab, (void **)&node);
+}
+
+static void route_trie_add(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie;
+	struct route_trie_node *node, *new, *branch;
+	u8_t len = route->prefix_len;
+	u8_t common = 0;
+
+	while ((node = *link)) {
+		common = common_prefix_len(&node->prefix, &route->addr,
+					   min(node->len, len));
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			sys_slist_append(&node->routes, &route->trie_node);
+			return;
+		}
+
+		link = &node->child[prefix_bit(&route->addr, node->len)];
+	}
+
+	new = trie_node_alloc(&route->addr, len);
+	sys_slist_append(&new->routes, &route->trie_node);
+
+	if (!node) {
+		*link = new;
+	} else if (common == len) {
+		/* The new prefix is the start of the prefix of node */
+		new->child[prefix_bit(&node->prefix, len)] = node;
+		*link = new;
+	} else {
+		branch = trie_node_alloc(&route->addr, common);
+		branch->child[prefix_bit(&route->addr, common)] = new;
+		branch->child[prefix_bit(&node->prefix, common)] = node;
+		*link = branch;
+	}
+}
+
+static void route_trie_del(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &route_trie, **parent_link = NULL;
+	struct route_trie_node *node = route_trie, *child;
+
+	while (node && node->len < route->prefix_len) {
+		parent_link = link;
+		link = &node->child[prefix_bit(&route->addr, node->len)];
+		node = *link;
+	}
+
+	if (!node || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->trie_node)) {
+		return;
+	}
+
+	if (!sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	/* Only keep nodes with routes or branching */
+	child = node->child[0] ? node->child[0] : node->child[1];
+	*link = child;
+	trie_node_free(node);
+
+	if (child || !parent_link) {
+		return;
+	}
+
+	node = *parent_link;
+	if (sys_slist_is_empty(&node->routes)) {
+		*parent_link = node->child[0] ? node->child[0] :
+			node->child[1];
+		trie_node_free(node);
+	}
+}
+
+/* Route of a trie node for the interface, if any. When a prefix has
+ * several routes, the same one as a scan of the routing table is chosen.
+ */
+static struct net_route_entry *trie_node_route(struct route_trie_node *node,
+					       struct net_if *iface)
+{
+	struct net_route_entry *route, *found = NULL;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, trie_node) {
+		if (iface && route->iface != iface) {
+			continue;
+		}
+
+		if (!found || (node->len < 128 ? route > found :
+			       route < found)) {
+			found = route;
+		}
+	}
+
+	return found;
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct route_trie_node *node = route_trie;
+	struct net_route_entry *route, *found = NULL;
+
+	/* The routes matching dst are on the path from the root to it */
+	while (node && net_is_ipv6_prefix((u8_t *)dst,
+					  node->prefix.s6_addr,
+					  node->len)) {
+		route = trie_node_route(node, iface);
+		if (route) {
+			found = route;
+		}
+
+		if (node->len == 128) {
+			break;
+		}
+
+		node = node->child[prefix_bit(dst, node->len)];
+	}
+
+	return found;
+}
+
+/* Route of exactly this prefix for the interface, if any */
+static struct net_route_entry *route_find_prefix(struct net_if *iface,
+						 struct in6_addr *addr,
+						 u8_t len)
+{
+	struct route_trie_node *node = route_trie;
+
+	while (node && node->len < len) {
+		node = node->child[prefix_bit(addr, node->len)];
+	}
+
+	if (!node || node->len != len ||
+	    !net_is_ipv6_prefix((u8_t *)addr, node->prefix.s6_addr, len)) {
+		return NULL;
+	}
+
+	return trie_node_route(node, iface);
+}
+#else
+#define route_trie_add(...)
+#define route_trie_del(...)
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	u8_t longest_match = 0;
@@ -287,6 +517,42 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+
+static struct net_route_entry *route_find_prefix(struct net_if *iface,
+						 struct in6_addr *addr,
+						 u8_t len)
+{
+	struct net_route_entry *route;
+	int i;
+
+	for (i = 0; i < CONFIG_NET_MAX_ROUTES; i++) {
+		struct net_nbr *nbr = get_nbr(i);
+
+		if (!nbr->ref || nbr->iface != iface) {
+			continue;
+		}
+
+		route = net_route_data(nbr);
+
+		if (route->prefix_len == len &&
+		    net_is_ipv6_prefix((u8_t *)addr, (u8_t *)&route->addr,
+				       len)) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_NET_ROUTE_TRIE */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	found = route_find(iface, dst);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -332,8 +598,13 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	NET_DBG("Nexthop %s lladdr is %s", net_sprint_ipv6_addr(nexthop),
 		net_sprint_ll_addr(nexthop_lladdr->addr, nexthop_lladdr->len));
 
-	route = net_route_lookup(iface, addr);
+	/* Routes of longer prefixes nest in the routes covering them,
+	 * only a route of the same prefix gets replaced.
+	 */
+	route = route_find_prefix(iface, addr, prefix_len);
 	if (route) {
+		update_route_access(route);
+
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
 
@@ -352,9 +623,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -388,6 +657,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	tmp = get_nexthop_route();
 	if (!tmp) {
 		NET_ERR("No nexthop route available!");
+		nbr_free(nbr);
 		return NULL;
 	}
 
@@ -396,7 +666,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	route_trie_add(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -449,13 +720,14 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
-
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
 	}
 
+	sys_dlist_remove(&route->node);
+	route_trie_del(route);
+
 	net_route_info("Deleted", route, &route->addr);
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
@@ -40,6 +40,7 @@
 #define ALLOC_TIMEOUT K_MSEC(500)
 
 static int net_tcp_queue_pkt(struct net_context *context, struct net_pkt *pkt);
+static void tcp_send_pending(struct net_tcp *tcp);
 
 /*
  * Each TCP connection needs to be tracked by net_context, so
@@ -156,10 +157,15 @@ static void net_tcp_trace(struct net_pkt *pkt, struct net_tcp *tcp)
 #define net_tcp_trace(...)
 #endif /* CONFIG_NET_DEBUG_TCP */
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+#define tcp_rto(tcp) ((tcp)->rto)
+#else
+#define tcp_rto(tcp) CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT
+#endif
+
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((u32_t)1 << tcp->retry_timeout_shift) *
-				CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	return ((u32_t)1 << tcp->retry_timeout_shift) * tcp_rto(tcp);
 }
 
 #define is_6lo_technology(pkt)						    \
@@ -202,10 +208,378 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+/* Resend the first (only the first!) unack'd packet */
+static void tcp_retransmit(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+
+	if (net_pkt_sent(pkt)) {
+		do_ref_if_needed(tcp, pkt);
+		net_pkt_set_sent(pkt, false);
+	}
+
+	net_pkt_set_queued(pkt, true);
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		NET_DBG("retry %u: [%p] pkt %p send failed",
+			tcp->retry_timeout_shift, tcp, pkt);
+		net_pkt_unref(pkt);
+	} else {
+		NET_DBG("retry %u: [%p] sent pkt %p",
+			tcp->retry_timeout_shift, tcp, pkt);
+		if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+		    !is_6lo_technology(pkt)) {
+			net_stats_update_tcp_seg_rexmit(net_pkt_iface(pkt));
+		}
+	}
+}
+
+static inline bool has_payload(struct net_pkt *pkt,
+			       struct net_tcp_hdr *tcp_hdr)
+{
+	return net_pkt_get_len(pkt) != net_pkt_ip_hdr_len(pkt) +
+		net_pkt_ipv6_ext_len(pkt) + NET_TCP_HDR_LEN(tcp_hdr);
+}
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+/* RFC 6298 2.5 "A maximum value MAY be placed on RTO provided it is at
+ * least 60 seconds."
+ */
+#define MAX_RTO K_SECONDS(60)
+
+#define DUP_ACK_THRESHOLD 3
+
+/* Sequence number of a packet of the sent list and its length in sequence
+ * space, SYN and FIN flags included.
+ */
+static bool sent_pkt_seq(struct net_pkt *pkt, u32_t *seq, u32_t *seq_len)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		return false;
+	}
+
+	*seq = sys_get_be32(tcp_hdr->seq);
+	*seq_len = net_pkt_appdatalen(pkt);
+
+	if (tcp_hdr->flags & NET_TCP_SYN) {
+		*seq_len += 1;
+	}
+	if (tcp_hdr->flags & NET_TCP_FIN) {
+		*seq_len += 1;
+	}
+
+	return true;
+}
+
+/* RFC 5681 3.1 initial window */
+static inline u32_t cc_initial_window(u16_t mss)
+{
+	return min(4 * mss, max(2 * mss, 4380));
+}
+
+/* The peer can never advertise more */
+static inline u32_t cc_max_window(struct net_tcp *tcp)
+{
+	return (u32_t)UINT16_MAX << tcp->send_wscale;
+}
+
+static void cc_init(struct net_tcp *tcp)
+{
+	tcp->rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	tcp->ssthresh = UINT_MAX;
+	tcp->cwnd = cc_initial_window(tcp->send_mss);
+}
+
+/* Called once the MSS and the first window of the peer are known. The
+ * window of a SYN segment is never scaled.
+ */
+static void cc_established(struct net_tcp *tcp, u16_t wnd)
+{
+	tcp->cwnd = cc_initial_window(tcp->send_mss);
+	tcp->send_wnd = wnd;
+	tcp->send_max = tcp->send_seq;
+}
+
+/* Segments with neither data nor SYN or FIN are not held back behind the
+ * queued data, and carry the next sequence number actually sent, or the
+ * peer would find them past its window.
+ */
+static inline u32_t cc_ctl_seq(struct net_tcp *tcp)
+{
+	if (net_tcp_get_state(tcp) < NET_TCP_ESTABLISHED) {
+		return tcp->send_seq;
+	}
+
+	return tcp->send_max;
+}
+
+static u32_t cc_flight_size(struct net_tcp *tcp)
+{
+	struct net_pkt *head;
+	u32_t una, len;
+
+	if (sys_slist_is_empty(&tcp->sent_list)) {
+		return 0;
+	}
+
+	head = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			    struct net_pkt, sent_list);
+	if (!sent_pkt_seq(head, &una, &len)) {
+		return 0;
+	}
+
+	return tcp->send_max - una;
+}
+
+/* Resends the first unacked packet, unless it is still waiting to be
+ * sent out.
+ */
+static void cc_retransmit(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	if (sys_slist_is_empty(&tcp->sent_list)) {
+		return;
+	}
+
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+	if (net_pkt_queued(pkt) && !net_pkt_sent(pkt)) {
+		return;
+	}
+
+	tcp->flags &= ~NET_TCP_RTT_TIMING;
+	tcp_retransmit(tcp);
+}
+
+static void cc_rtt_sample(struct net_tcp *tcp, u32_t rtt)
+{
+	u32_t delta;
+
+	if (!tcp->srtt && !tcp->rttvar) {
+		tcp->srtt = rtt;
+		tcp->rttvar = rtt / 2;
+	} else {
+		delta = tcp->srtt > rtt ? tcp->srtt - rtt : rtt - tcp->srtt;
+
+		/* RFC 6298 2.3 with alpha = 1/8 and beta = 1/4 */
+		tcp->rttvar = (3 * tcp->rttvar + delta) / 4;
+		tcp->srtt = (7 * tcp->srtt + rtt) / 8;
+	}
+
+	tcp->rto = tcp->srtt + max(4 * tcp->rttvar, 1);
+	tcp->rto = max(tcp->rto, CONFIG_NET_TCP_MIN_RETRANSMISSION_TIMEOUT);
+	tcp->rto = min(tcp->rto, MAX_RTO);
+
+	NET_DBG("[%p] rtt %u srtt %u rttvar %u rto %u", tcp, rtt, tcp->srtt,
+		tcp->rttvar, tcp->rto);
+}
+
+/* Tells whether the packet fits in the congestion and peer windows, and
+ * times it if it is new data. The first unacked packet always does.
+ */
+static bool cc_send_allowed(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	struct net_pkt *head;
+	u32_t una, seq, len;
+
+	head = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			    struct net_pkt, sent_list);
+	if (!sent_pkt_seq(head, &una, &len) || !sent_pkt_seq(pkt, &seq, &len)) {
+		return true;
+	}
+
+	if (pkt != head &&
+	    seq + len - una > min(tcp->cwnd, tcp->send_wnd)) {
+		return false;
+	}
+
+	/* Karn's algorithm: retransmitted data is never timed */
+	if (net_tcp_seq_greater(seq + len, tcp->send_max)) {
+		if (!(tcp->flags & NET_TCP_RTT_TIMING)) {
+			tcp->flags |= NET_TCP_RTT_TIMING;
+			tcp->rtt_seq = seq + len;
+			tcp->rtt_start = k_uptime_get_32();
+		}
+
+		tcp->send_max = seq + len;
+	}
+
+	return true;
+}
+
+/* RFC 5681 3.1 slow start and congestion avoidance, RFC 6582 3.2 partial
+ * and full acknowledgments during fast recovery.
+ */
+static void cc_ack_received(struct net_tcp *tcp, u32_t ack, u32_t acked)
+{
+	u16_t mss = tcp->send_mss;
+
+	if ((tcp->flags & NET_TCP_RTT_TIMING) &&
+	    !net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+		tcp->flags &= ~NET_TCP_RTT_TIMING;
+		cc_rtt_sample(tcp, k_uptime_get_32() - tcp->rtt_start);
+	}
+
+	tcp->dup_acks = 0;
+
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		if (!net_tcp_seq_greater(tcp->recover, ack)) {
+			tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+			tcp->cwnd = tcp->ssthresh;
+			return;
+		}
+
+		/* The next hole is known lost as well, resend it at once
+		 * instead of waiting for three more duplicate ACKs.
+		 */
+		tcp->cwnd -= min(acked, tcp->cwnd - mss);
+		if (acked >= mss) {
+			tcp->cwnd += mss;
+		}
+
+		cc_retransmit(tcp);
+		return;
+	}
+
+	if (tcp->cwnd < tcp->ssthresh) {
+		tcp->cwnd += min(acked, mss);
+	} else {
+		tcp->cwnd += max((u32_t)mss * mss / tcp->cwnd, 1);
+	}
+
+	tcp->cwnd = min(tcp->cwnd, cc_max_window(tcp));
+
+	/* The packets sent before the timeout are likely lost as well:
+	 * resend each of them once it is the first unacked one.
+	 */
+	if (tcp->flags & NET_TCP_RTO_RECOVERY) {
+		if (!net_tcp_seq_greater(tcp->recover, ack)) {
+			tcp->flags &= ~NET_TCP_RTO_RECOVERY;
+		} else {
+			cc_retransmit(tcp);
+		}
+	}
+}
+
+/* RFC 5681 3.2 fast retransmit and fast recovery */
+static void cc_dup_ack_received(struct net_tcp *tcp)
+{
+	u16_t mss = tcp->send_mss;
+
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		/* Another segment left the network */
+		tcp->cwnd = min(tcp->cwnd + mss, cc_max_window(tcp));
+		return;
+	}
+
+	/* The packets resent after a timeout cause duplicate ACKs */
+	if (++tcp->dup_acks < DUP_ACK_THRESHOLD ||
+	    (tcp->flags & NET_TCP_RTO_RECOVERY)) {
+		return;
+	}
+
+	NET_DBG("[%p] fast retransmit, cwnd %u", tcp, tcp->cwnd);
+
+	tcp->ssthresh = max(cc_flight_size(tcp) / 2, 2 * mss);
+	tcp->cwnd = tcp->ssthresh + DUP_ACK_THRESHOLD * mss;
+	tcp->recover = tcp->send_max;
+	tcp->flags |= NET_TCP_FAST_RECOVERY;
+
+	cc_retransmit(tcp);
+}
+
+/* A duplicate ACK acknowledges the first unacked packet, after it was
+ * sent, without data nor window update.
+ */
+static bool cc_is_dup_ack(struct net_tcp *tcp, struct net_pkt *pkt,
+			  struct net_tcp_hdr *tcp_hdr)
+{
+	struct net_pkt *head;
+	u32_t una, len;
+
+	if (sys_slist_is_empty(&tcp->sent_list) ||
+	    (tcp_hdr->flags & (NET_TCP_SYN | NET_TCP_FIN)) ||
+	    ((u32_t)sys_get_be16(tcp_hdr->wnd) << tcp->send_wscale) !=
+							tcp->send_wnd) {
+		return false;
+	}
+
+	if (has_payload(pkt, tcp_hdr)) {
+		return false;
+	}
+
+	head = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			    struct net_pkt, sent_list);
+	if (!(net_pkt_queued(head) || net_pkt_sent(head)) ||
+	    !sent_pkt_seq(head, &una, &len)) {
+		return false;
+	}
+
+	return sys_get_be32(tcp_hdr->ack) == una;
+}
+
+/* Called on every acceptable ACK, after the sent list was updated */
+static void cc_ack_processed(struct net_tcp *tcp,
+			     struct net_tcp_hdr *tcp_hdr, bool dup_ack)
+{
+	if (dup_ack) {
+		cc_dup_ack_received(tcp);
+	}
+
+	tcp->send_wnd = (u32_t)sys_get_be16(tcp_hdr->wnd) << tcp->send_wscale;
+
+	tcp_send_pending(tcp);
+}
+
+/* RFC 5681 3.1 on a retransmission timeout */
+static void cc_timeout(struct net_tcp *tcp)
+{
+	if (tcp->retry_timeout_shift == 1) {
+		tcp->ssthresh = max(cc_flight_size(tcp) / 2,
+				    2 * tcp->send_mss);
+	}
+
+	tcp->cwnd = tcp->send_mss;
+	tcp->dup_acks = 0;
+	tcp->recover = tcp->send_max;
+	tcp->flags &= ~(NET_TCP_FAST_RECOVERY | NET_TCP_RTT_TIMING);
+	tcp->flags |= NET_TCP_RTO_RECOVERY;
+}
+
+/* Packets still held back by the windows also hold the reference meant
+ * for the driver, see do_ref_if_needed().
+ */
+static void cc_release_pkt(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	u32_t seq, len;
+
+	if (!is_6lo_technology(pkt) && sent_pkt_seq(pkt, &seq, &len) &&
+	    !net_tcp_seq_greater(tcp->send_max, seq)) {
+		net_pkt_unref(pkt);
+	}
+}
+#else
+#define cc_init(...)
+#define cc_established(...)
+#define cc_ctl_seq(tcp) ((tcp)->send_seq)
+#define cc_send_allowed(...) true
+#define cc_ack_received(...)
+#define cc_is_dup_ack(...) false
+#define cc_ack_processed(tcp, tcp_hdr, dup_ack) ARG_UNUSED(dup_ack)
+#define cc_timeout(...)
+#define cc_release_pkt(...)
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 static void tcp_retry_expired(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, retry_timer);
-	struct net_pkt *pkt;
 
 	/* Double the retry period for exponential backoff and resend
 	 * the first (only the first!) unack'd packet.
@@ -220,29 +594,8 @@ static void tcp_retry_expired(struct k_work *work)
 
 		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
 
-		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_pkt, sent_list);
-
-		if (net_pkt_sent(pkt)) {
-			do_ref_if_needed(tcp, pkt);
-			net_pkt_set_sent(pkt, false);
-		}
-
-		net_pkt_set_queued(pkt, true);
-
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
-			NET_DBG("retry %u: [%p] pkt %p send failed",
-				tcp->retry_timeout_shift, tcp, pkt);
-			net_pkt_unref(pkt);
-		} else {
-			NET_DBG("retry %u: [%p] sent pkt %p",
-				tcp->retry_timeout_shift, tcp, pkt);
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit(
-							net_pkt_iface(pkt));
-			}
-		}
+		cc_timeout(tcp);
+		tcp_retransmit(tcp);
 	} else if (CONFIG_NET_TCP_TIME_WAIT_DELAY != 0) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
 			NET_DBG("[%p] Closing connection (context %p)",
@@ -279,6 +632,8 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 	tcp_context[i].recv_wnd = min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
 	tcp_context[i].send_mss = NET_TCP_DEFAULT_MSS;
 
+	cc_init(&tcp_context[i]);
+
 	tcp_context[i].accept_cb = NULL;
 
 	k_delayed_work_init(&tcp_context[i].retry_timer, tcp_retry_expired);
@@ -320,6 +675,7 @@ int net_tcp_release(struct net_tcp *tcp)
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->sent_list, pkt, tmp,
 					  sent_list) {
 		sys_slist_remove(&tcp->sent_list, NULL, &pkt->sent_list);
+		cc_release_pkt(tcp, pkt);
 		net_pkt_unref(pkt);
 	}
 
@@ -571,7 +927,11 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 
 	segment.src_addr = (struct sockaddr_ptr *)local;
 	segment.dst_addr = remote;
-	segment.seq = tcp->send_seq;
+	if (!*send_pkt && !(flags & (NET_TCP_SYN | NET_TCP_FIN))) {
+		segment.seq = cc_ctl_seq(tcp);
+	} else {
+		segment.seq = tcp->send_seq;
+	}
 	segment.ack = tcp->send_ack;
 	segment.flags = flags;
 	segment.wnd = wnd;
@@ -679,6 +1039,18 @@ static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 		      (u32_t *)(options + *optionlen));
 
 	*optionlen += NET_TCP_MSS_SIZE;
+
+	/* Window scaling is only offered on active opens, as the option
+	 * may only be sent in a SYN-ACK if the SYN had it. Our receive
+	 * window fits in 16 bits, so our own shift is zero: the option
+	 * only lets the peer scale its windows.
+	 */
+	if (net_tcp_get_state(tcp) == NET_TCP_SYN_SENT) {
+		options[(*optionlen)++] = NET_TCP_NOP_OPT;
+		options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_OPT;
+		options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_SIZE;
+		options[(*optionlen)++] = 0;
+	}
 }
 
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
@@ -750,7 +1122,7 @@ int net_tcp_prepare_reset(struct net_tcp *tcp,
 		/* Send the reset segment always with acknowledgment. */
 		segment.ack = tcp->send_ack;
 		segment.flags = NET_TCP_RST | NET_TCP_ACK;
-		segment.seq = tcp->send_seq;
+		segment.seq = cc_ctl_seq(tcp);
 
 		if (!local) {
 			segment.src_addr = &tcp->context->local;
@@ -973,38 +1345,49 @@ static void restart_timer(struct net_tcp *tcp)
 	}
 }
 
-int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
-		      void *token, void *user_data)
+/* Sends the queued packets not sent yet, as far as the congestion and
+ * peer windows allow. The rest is sent as ACKs open the windows.
+ */
+static void tcp_send_pending(struct net_tcp *tcp)
 {
 	struct net_pkt *pkt;
 
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
-	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
 		/* Do not resend packets that were sent by expire timer */
 		if (net_pkt_queued(pkt)) {
 			NET_DBG("[%p] Skipping pkt %p because it was already "
-				"sent.", context->tcp, pkt);
+				"sent.", tcp, pkt);
 			continue;
 		}
 
 		if (!net_pkt_sent(pkt)) {
 			int ret;
 
-			NET_DBG("[%p] Sending pkt %p (%zd bytes)", context->tcp,
+			if (!cc_send_allowed(tcp, pkt)) {
+				NET_DBG("[%p] pkt %p waits for the window",
+					tcp, pkt);
+				break;
+			}
+
+			NET_DBG("[%p] Sending pkt %p (%zd bytes)", tcp,
 				pkt, net_pkt_get_len(pkt));
 
 			ret = net_tcp_send_pkt(pkt);
 			if (ret < 0 && !is_6lo_technology(pkt)) {
 				NET_DBG("[%p] pkt %p not sent (%d)",
-					context->tcp, pkt, ret);
+					tcp, pkt, ret);
 				net_pkt_unref(pkt);
 			}
 
 			net_pkt_set_queued(pkt, true);
 		}
 	}
+}
+
+int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
+		      void *token, void *user_data)
+{
+	tcp_send_pending(context->tcp);
 
 	/* Just make the callback synchronously even if it didn't
 	 * go over the wire.  In theory it would be nice to track
@@ -1026,6 +1409,7 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	sys_snode_t *head;
 	struct net_pkt *pkt;
 	bool valid_ack = false;
+	u32_t acked = 0;
 
 	if (net_tcp_seq_greater(ack, ctx->tcp->send_seq)) {
 		NET_ERR("ctx %p: ACK for unsent data", ctx);
@@ -1092,6 +1476,7 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 		sys_slist_remove(list, NULL, head);
 		net_pkt_unref(pkt);
 		valid_ack = true;
+		acked += seq_len;
 	}
 
 	/* Restart the timer (if needed) on a valid inbound ACK.  This isn't
@@ -1101,6 +1486,7 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	 * sent times.
 	 */
 	if (valid_ack) {
+		cc_ack_received(tcp, ack, acked);
 		restart_timer(ctx->tcp);
 	}
 
@@ -1434,6 +1820,19 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 			}
 			frag = net_frag_read_be16(frag, pos, &pos,
 						  &opts->mss);
+			if (opts->mss < NET_TCP_MIN_MSS) {
+				opts->mss = NET_TCP_DEFAULT_MSS;
+			}
+			break;
+		case NET_TCP_WINDOW_SCALE_OPT:
+			if (optlen != 1) {
+				goto error;
+			}
+			frag = net_frag_read_u8(frag, pos, &pos,
+						&opts->wscale);
+			opts->wscale = min(opts->wscale,
+					   NET_TCP_MAX_WINDOW_SCALE);
+			opts->wscale_set = true;
 			break;
 		default:
 			frag = net_frag_skip(frag, pos, &pos, optlen);
@@ -1492,10 +1891,8 @@ static void queue_fin(struct net_context *ctx)
 
 	net_tcp_queue_pkt(ctx, pkt);
 
-	ret = net_tcp_send_pkt(pkt);
-	if (ret < 0) {
-		net_pkt_unref(pkt);
-	}
+	/* The FIN goes after the data still waiting for the window */
+	tcp_send_pending(ctx->tcp);
 }
 
 int net_tcp_put(struct net_context *context)
@@ -1695,6 +2092,8 @@ static int tcp_backlog_ack(struct net_pkt *pkt, struct net_context *context)
 	context->tcp->send_ack = tcp_backlog[r].send_ack;
 	context->tcp->send_mss = tcp_backlog[r].send_mss;
 
+	cc_established(context->tcp, sys_get_be16(tcp_hdr->wnd));
+
 	k_delayed_work_cancel(&tcp_backlog[r].ack_timer);
 	memset(&tcp_backlog[r], 0, sizeof(struct tcp_backlog_entry));
 
@@ -2013,8 +2412,32 @@ resend_ack:
 			    context->tcp->send_ack) > 0) {
 		/* Don't try to reorder packets.  If it doesn't
 		 * match the next segment exactly, drop and wait for
-		 * retransmit
+		 * retransmit. Its acknowledgment is still processed, and
+		 * if it carries data, the duplicate ACK sent at once tells
+		 * the peer about the hole (RFC 5681 4.2). Pure ACKs are not
+		 * answered, or both peers could keep acking each other.
 		 */
+		if (tcp_flags & NET_TCP_RST) {
+			return NET_DROP;
+		}
+
+		if ((tcp_flags & NET_TCP_ACK) &&
+		    net_tcp_get_state(context->tcp) == NET_TCP_ESTABLISHED &&
+		    net_tcp_validate_seq(context->tcp, pkt)) {
+			bool dup_ack = cc_is_dup_ack(context->tcp, pkt,
+						     tcp_hdr);
+
+			if (net_tcp_ack_received(context,
+						 sys_get_be32(tcp_hdr->ack))) {
+				cc_ack_processed(context->tcp, tcp_hdr,
+						 dup_ack);
+			}
+		}
+
+		if (has_payload(pkt, tcp_hdr) || (tcp_flags & NET_TCP_FIN)) {
+			goto resend_ack;
+		}
+
 		return NET_DROP;
 	}
 
@@ -2045,11 +2468,15 @@ resend_ack:
 
 	/* Handle TCP state transition */
 	if (tcp_flags & NET_TCP_ACK) {
+		bool dup_ack = cc_is_dup_ack(context->tcp, pkt, tcp_hdr);
+
 		if (!net_tcp_ack_received(context,
 				     sys_get_be32(tcp_hdr->ack))) {
 			return NET_DROP;
 		}
 
+		cc_ack_processed(context->tcp, tcp_hdr, dup_ack);
+
 		/* TCP state might be changed after maintaining the sent pkt
 		 * list, e.g., an ack of FIN is received.
 		 */
@@ -2213,6 +2640,15 @@ NET_CONN_CB(tcp_synack_received)
 		 */
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
+		struct net_tcp_options tcp_opts = {
+			.mss = NET_TCP_DEFAULT_MSS,
+		};
+
+		if (net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				       sizeof(struct net_tcp_hdr),
+				       &tcp_opts) < 0) {
+			return NET_DROP;
+		}
 
 		if (net_pkt_get_src_addr(
 			pkt, &remote_addr, sizeof(remote_addr)) < 0) {
@@ -2242,6 +2678,16 @@ NET_CONN_CB(tcp_synack_received)
 			return NET_DROP;
 		}
 
+		/* Our SYN offered window scaling, it is in use if the
+		 * peer offers it too.
+		 */
+		context->tcp->send_mss = tcp_opts.mss;
+		if (tcp_opts.wscale_set) {
+			context->tcp->send_wscale = tcp_opts.wscale;
+		}
+
+		cc_established(context->tcp, sys_get_be16(tcp_hdr->wnd));
+
 		net_tcp_change_state(context->tcp, NET_TCP_ESTABLISHED);
 		net_context_set_state(context, NET_CONTEXT_CONNECTED);
 
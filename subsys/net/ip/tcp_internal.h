@@ -29,7 +29,11 @@ extern "C" {
 /** Is this TCP context/socket used or not */
 #define NET_TCP_IN_USE BIT(0)
 
-/* BIT(1), BIT(2) are unused and available */
+/** Fast recovery after three duplicate ACKs is in progress */
+#define NET_TCP_FAST_RECOVERY BIT(1)
+
+/** A sent segment is being timed for a round-trip time sample */
+#define NET_TCP_RTT_TIMING BIT(2)
 
 /** Is the socket shutdown for read/write */
 #define NET_TCP_IS_SHUTDOWN BIT(3)
@@ -40,6 +44,9 @@ extern "C" {
 /** MSS option has been set already */
 #define NET_TCP_RECV_MSS_SET BIT(5)
 
+/** Packets sent before a retransmission timeout are not all ack'd yet */
+#define NET_TCP_RTO_RECOVERY BIT(6)
+
 /*
  * TCP connection states
  */
@@ -77,6 +84,9 @@ enum net_tcp_state {
  */
 #define NET_TCP_DEFAULT_MSS   536
 
+/* Smaller MSS options are ignored: congestion control divides by the MSS */
+#define NET_TCP_MIN_MSS   88
+
 /* TCP max window size */
 #define NET_TCP_MAX_WIN   (4 * 1024)
 
@@ -97,9 +107,15 @@ enum net_tcp_state {
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
 
+/* RFC 7323 2.3 "the shift.cnt value ... MUST be limited to 14" */
+#define NET_TCP_MAX_WINDOW_SCALE 14
+
 /** Parsed TCP option values for net_tcp_parse_opts()  */
 struct net_tcp_options {
 	u16_t mss;
+	/** Window scale shift, valid if wscale_set */
+	u8_t wscale;
+	bool wscale_set;
 };
 
 /* Max received bytes to buffer internally */
@@ -161,6 +177,41 @@ struct net_tcp {
 	 */
 	u16_t send_mss;
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/** Congestion window, in bytes */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	u32_t ssthresh;
+
+	/** Send window advertised by the peer, scaled, in bytes */
+	u32_t send_wnd;
+
+	/** End of the highest sequence number sent so far */
+	u32_t send_max;
+
+	/** Sequence number to be acknowledged to leave fast recovery */
+	u32_t recover;
+
+	/** Sequence number whose ACK completes the round-trip time sample */
+	u32_t rtt_seq;
+
+	/** Uptime when the timed segment was sent, in milliseconds */
+	u32_t rtt_start;
+
+	/** Smoothed round-trip time, in milliseconds */
+	u32_t srtt;
+
+	/** Round-trip time variation, in milliseconds */
+	u32_t rttvar;
+
+	/** Retransmission timeout, in milliseconds */
+	u32_t rto;
+
+	/** Duplicate ACKs received in a row */
+	u8_t dup_acks;
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 	/** Current retransmit period */
 	u32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
@@ -171,8 +222,10 @@ struct net_tcp {
 	u32_t fin_sent : 1;
 	/* An inbound FIN packet has been received */
 	u32_t fin_rcvd : 1;
+	/** Window scale shift of the windows advertised by the peer */
+	u32_t send_wscale : 4;
 	/** Remaining bits in this u32_t */
-	u32_t _padding : 13;
+	u32_t _padding : 9;
 };
 
 typedef void (*net_tcp_cb_t)(struct net_tcp *tcp, void *user_data);
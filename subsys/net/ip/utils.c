@@ -445,7 +445,14 @@ static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
 
 	while (frag) {
 		sum = calc_chksum(sum, ptr, len);
-		frag = frag->frags;
+
+		/* Skip empty fragments, which are not compacted away in
+		 * packets sent by scatter-gather drivers
+		 */
+		do {
+			frag = frag->frags;
+		} while (frag && !frag->len);
+
 		if (!frag) {
 			break;
 		}
@@ -11,6 +11,7 @@
 #include <misc/reboot.h>
 #include <misc/stack.h>
 #include <string.h>
+#include <stdlib.h>
 
 #define SHELL_KERNEL "kernel"
 
@@ -86,6 +87,101 @@ static int shell_cmd_stack(int argc, char *argv[])
 }
 #endif
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+static u32_t cycles_to_us(u64_t cycles)
+{
+	return (u32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC);
+}
+
+/* scaled down to milliseconds first, not to overflow the u64_t */
+static u32_t cycles_to_ms(u64_t cycles)
+{
+	return (u32_t)(cycles * MSEC_PER_SEC / sys_clock_hw_cycles_per_sec);
+}
+
+/* CPU usage in tenths of percent */
+static u32_t usage(u64_t cycles, u64_t total)
+{
+	return total == 0 ? 0 : (u32_t)(cycles * 1000 / total);
+}
+
+static void shell_top_dump(const struct k_thread *thread, void *user_data)
+{
+	struct k_thread_runtime_stats *all = user_data;
+	struct k_thread_runtime_stats stats;
+	u32_t cpu;
+
+	k_thread_runtime_stats_get((k_tid_t)thread, &stats);
+	cpu = usage(stats.execution_cycles, all->execution_cycles);
+
+	printk("%s%p %4d %3u.%u %10u %10u %10u\n",
+	       (thread == k_current_get()) ? "*" : " ",
+	       thread, thread->base.prio, cpu / 10, cpu % 10, stats.switches,
+	       cycles_to_us(stats.latency_avg),
+	       cycles_to_us(stats.latency_max));
+}
+
+static int shell_cmd_top(int argc, char *argv[])
+{
+	struct k_thread_runtime_stats all;
+	u32_t idle;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	k_thread_runtime_stats_all_get(&all);
+	idle = usage(all.idle_cycles, all.execution_cycles);
+
+	printk("uptime: %u ms, idle: %u.%u%%, switches: %u, "
+	       "latency avg/max: %u/%u us\n",
+	       cycles_to_ms(all.execution_cycles), idle / 10, idle % 10,
+	       all.switches, cycles_to_us(all.latency_avg),
+	       cycles_to_us(all.latency_max));
+	printk(" thread     prio  cpu%%   switches lat avg us lat max us\n");
+	k_thread_foreach(shell_top_dump, &all);
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_LOCK_STATS)
+#define LOCK_STATS_DEFAULT_NUM 10
+
+static int shell_cmd_locks(int argc, char *argv[])
+{
+	int num = LOCK_STATS_DEFAULT_NUM;
+
+	if (argc > 1) {
+		num = strtol(argv[1], NULL, 10);
+		if (num <= 0) {
+			return -EINVAL;
+		}
+	}
+
+	k_lock_stats_dump(num);
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_LATENCY_HISTOGRAMS)
+static int shell_cmd_latency(int argc, char *argv[])
+{
+	if (argc > 1) {
+		if (strcmp(argv[1], "reset")) {
+			return -EINVAL;
+		}
+
+		k_latency_hist_reset();
+		return 0;
+	}
+
+	k_latency_hist_dump();
+
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int shell_cmd_reboot(int argc, char *argv[])
 {
@@ -119,6 +215,16 @@ struct shell_cmd kernel_commands[] = {
 				&& defined(CONFIG_THREAD_STACK_INFO)
 	{ "stacks", shell_cmd_stack, "show system stacks" },
 #endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	{ "top", shell_cmd_top, "show CPU usage and latency of threads" },
+#endif
+#if defined(CONFIG_LOCK_STATS)
+	{ "locks", shell_cmd_locks, "[num] show the most waited for locks" },
+#endif
+#if defined(CONFIG_LATENCY_HISTOGRAMS)
+	{ "latency", shell_cmd_latency,
+	  "[reset] show or clear the latency histograms" },
+#endif
 #if defined(CONFIG_REBOOT)
 	{ "reboot", shell_cmd_reboot, "<warm cold>" },
 #endif
@@ -20,6 +20,12 @@
 
 #include <tc_util.h>
 
+/* slab initialized at boot, unless CONFIG_MEM_SLAB_LAZY_INIT is enabled */
+#define BOOT_SLAB_BLOCK_SIZE 32
+#define BOOT_SLAB_NUM_BLOCKS 256
+
+K_MEM_SLAB_DEFINE(boot_slab, BOOT_SLAB_BLOCK_SIZE, BOOT_SLAB_NUM_BLOCKS, 4);
+
 /* externs */
 extern u64_t __start_time_stamp;    /* timestamp when kernel begins executing */
 extern u64_t __main_time_stamp;     /* timestamp when main() begins executing */
@@ -72,6 +78,10 @@ void main(void)
 		 (u32_t)(s_idle_time_stamp & 0xFFFFFFFFULL),
 		 (u32_t)  (idle_us  & 0xFFFFFFFFULL));
 
+	TC_PRINT("boot_slab: %u blocks, lazy initialization %s\n",
+		 BOOT_SLAB_NUM_BLOCKS,
+		 IS_ENABLED(CONFIG_MEM_SLAB_LAZY_INIT) ? "on" : "off");
+
 	TC_PRINT("Boot Time Measurement finished\n");
 
 	/* for sanity regression test utility. */
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the event throughput of the QF port: pairs of active objects
+ * bounce an event back and forth, so that every event is posted to an empty
+ * queue and wakes up the thread of the receiving active object. The run is
+ * repeated with more and more pairs exchanging events concurrently.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#include "qpc.h"
+
+#define MAX_PAIRS 4
+#define NUM_ROUND_TRIPS 5000
+#define QUEUE_LEN 4
+#define STACK_SIZE 1024
+
+enum {
+	KICKOFF_SIG = Q_USER_SIG,
+	START_SIG,
+	PING_SIG,
+	PONG_SIG,
+};
+
+typedef struct {
+	QActive super;
+	QActive *peer;
+	u32_t count;
+} Ping;
+
+typedef struct {
+	QActive super;
+	QActive *peer;
+} Pong;
+
+static Ping l_ping[MAX_PAIRS];
+static Pong l_pong[MAX_PAIRS];
+
+/* immutable events, never recycled by QF_gc() */
+static QEvt const kickoff_evt = { KICKOFF_SIG, 0U, 0U };
+static QEvt const start_evt = { START_SIG, 0U, 0U };
+static QEvt const ping_evt = { PING_SIG, 0U, 0U };
+static QEvt const pong_evt = { PONG_SIG, 0U, 0U };
+
+static QEvt const *ping_queue[MAX_PAIRS][QUEUE_LEN];
+static QEvt const *pong_queue[MAX_PAIRS][QUEUE_LEN];
+
+#ifdef CONFIG_QPC_PORT_K_THREAD
+static K_THREAD_STACK_ARRAY_DEFINE(ping_stack, MAX_PAIRS, STACK_SIZE);
+static K_THREAD_STACK_ARRAY_DEFINE(pong_stack, MAX_PAIRS, STACK_SIZE);
+#define STACK(name) name
+#define STACK_SIZEOF(name) K_THREAD_STACK_SIZEOF(name)
+#else
+/* the POSIX port allocates the thread stacks itself */
+#define STACK(name) ((void *)0)
+#define STACK_SIZEOF(name) 0U
+#endif
+
+/* number of pairs exchanging events in each phase */
+static const int phase_pairs[] = { 1, 2, 4 };
+
+static int phase;
+static atomic_t running;
+static u32_t start;
+
+static void phase_start(void)
+{
+	int i;
+
+	atomic_set(&running, phase_pairs[phase]);
+	start = k_cycle_get_32();
+
+	for (i = 0; i < phase_pairs[phase]; i++) {
+		QACTIVE_POST(&l_ping[i].super, &start_evt, NULL);
+	}
+}
+
+static void phase_done(void)
+{
+	u32_t cycles = k_cycle_get_32() - start;
+	u32_t events = 2 * NUM_ROUND_TRIPS * phase_pairs[phase];
+
+	TC_PRINT("%5d %9u %12u %12u\n", phase_pairs[phase], events,
+		 (u32_t)(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC),
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(cycles, events));
+
+	if (++phase < ARRAY_SIZE(phase_pairs)) {
+		phase_start();
+	} else {
+		QF_stop();
+	}
+}
+
+static QState Ping_active(Ping * const me, QEvt const * const e);
+static QState Pong_active(Pong * const me, QEvt const * const e);
+
+static QState Ping_initial(Ping * const me, QEvt const * const e)
+{
+	ARG_UNUSED(e);
+
+	/* start measuring once QF_run() has started the threads */
+	if (me == &l_ping[0]) {
+		QACTIVE_POST(&me->super, &kickoff_evt, me);
+	}
+
+	return Q_TRAN(&Ping_active);
+}
+
+static QState Ping_active(Ping * const me, QEvt const * const e)
+{
+	switch (e->sig) {
+	case KICKOFF_SIG:
+		phase_start();
+		return Q_HANDLED();
+	case START_SIG:
+		me->count = 0;
+		QACTIVE_POST(me->peer, &ping_evt, me);
+		return Q_HANDLED();
+	case PONG_SIG:
+		if (++me->count < NUM_ROUND_TRIPS) {
+			QACTIVE_POST(me->peer, &ping_evt, me);
+		} else if (atomic_dec(&running) == 1) {
+			phase_done();
+		}
+		return Q_HANDLED();
+	}
+
+	return Q_SUPER(&QHsm_top);
+}
+
+static QState Pong_initial(Pong * const me, QEvt const * const e)
+{
+	ARG_UNUSED(e);
+
+	return Q_TRAN(&Pong_active);
+}
+
+static QState Pong_active(Pong * const me, QEvt const * const e)
+{
+	switch (e->sig) {
+	case PING_SIG:
+		QACTIVE_POST(me->peer, &pong_evt, me);
+		return Q_HANDLED();
+	}
+
+	return Q_SUPER(&QHsm_top);
+}
+
+void QF_onStartup(void)
+{
+}
+
+void QF_onCleanup(void)
+{
+}
+
+void QF_onClockTick(void)
+{
+}
+
+void Q_onAssert(char const *module, int loc)
+{
+	TC_ERROR("assertion failed in %s:%d\n", module, loc);
+	TC_END_REPORT(TC_FAIL);
+	k_panic();
+}
+
+void main(void)
+{
+	int i;
+
+	TC_START("QF event throughput");
+
+	QF_init();
+
+	for (i = 0; i < MAX_PAIRS; i++) {
+		QActive_ctor(&l_ping[i].super, Q_STATE_CAST(&Ping_initial));
+		QActive_ctor(&l_pong[i].super, Q_STATE_CAST(&Pong_initial));
+		l_ping[i].peer = &l_pong[i].super;
+		l_pong[i].peer = &l_ping[i].super;
+
+		QACTIVE_START(&l_pong[i].super, 2U * i + 1U, pong_queue[i],
+			      QUEUE_LEN, STACK(pong_stack[i]),
+			      STACK_SIZEOF(pong_stack[i]), (QEvt *)0);
+		QACTIVE_START(&l_ping[i].super, 2U * i + 2U, ping_queue[i],
+			      QUEUE_LEN, STACK(ping_stack[i]),
+			      STACK_SIZEOF(ping_stack[i]), (QEvt *)0);
+	}
+
+	TC_PRINT("pairs    events   total (us) event (ns)\n");
+
+	QF_run();
+
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure scheduler throughput with all CPUs rescheduling at once, which
+ * is where CPUs contend on the run queue locks.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#define THREADS_PER_CPU 2
+#define NUM_THREADS (THREADS_PER_CPU * CONFIG_MP_NUM_CPUS)
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define WORKER_PRIO K_PRIO_PREEMPT(5)
+
+/* length of each measurement, in ms */
+#define RUN_TIME 1000
+
+static struct k_thread threads[NUM_THREADS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_THREADS, STACK_SIZE);
+
+/* one cache line per counter, not to measure false sharing instead */
+static struct {
+	volatile u32_t count;
+} __aligned(64) counters[NUM_THREADS];
+
+static struct k_sem sems[NUM_THREADS];
+
+static void yielder(void *p1, void *p2, void *p3)
+{
+	int i = (int)p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		counters[i].count++;
+		k_yield();
+	}
+}
+
+/* threads 2n and 2n + 1 wake each other up in turn */
+static void pinger(void *p1, void *p2, void *p3)
+{
+	int i = (int)p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sem_take(&sems[i], K_FOREVER);
+		counters[i].count++;
+		k_sem_give(&sems[i ^ 1]);
+	}
+}
+
+static void measure(const char *name, k_thread_entry_t entry)
+{
+	u32_t total = 0;
+	int i;
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		counters[i].count = 0;
+		k_sem_init(&sems[i], i & 1, 1);
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, entry,
+				(void *)i, NULL, NULL, WORKER_PRIO, 0, 0);
+	}
+
+	k_sleep(RUN_TIME);
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		k_thread_abort(&threads[i]);
+		total += counters[i].count;
+	}
+
+	/* CPU time spent per operation, lower is better */
+	TC_PRINT("%-10s %10u %12u\n", name, total,
+		 total ? (u32_t)((u64_t)RUN_TIME * 1000000 *
+				 CONFIG_MP_NUM_CPUS / total) : 0);
+}
+
+void main(void)
+{
+	TC_START("SMP scheduler throughput");
+
+	TC_PRINT("%d CPUs, %d threads, %d ms runs, %s run queues\n",
+		 CONFIG_MP_NUM_CPUS, NUM_THREADS, RUN_TIME,
+		 IS_ENABLED(CONFIG_SCHED_CPU_RUNQ) ? "per-CPU" : "shared");
+	TC_PRINT("workload        ops  CPU ns / op\n");
+
+	measure("k_yield", yielder);
+	measure("k_sem", pinger);
+
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the cost of arming and aborting a timeout depending on the number
+ * of timeouts already pending in the kernel timeout queue.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+
+#define MAX_PENDING 1000
+#define NUM_PROBES 100
+
+/* durations are spread over minutes, nothing expires during the run */
+#define MIN_DURATION_MS K_SECONDS(60)
+#define DURATION_SPAN_MS K_SECONDS(600)
+
+static struct k_timer pending[MAX_PENDING];
+static struct k_timer probes[NUM_PROBES];
+
+static const int pending_counts[] = { 10, 100, 1000 };
+
+static u32_t rand_state = 0x2545f491;
+
+static s32_t random_duration(void)
+{
+	/* deterministic LCG: runs are comparable between configurations */
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return MIN_DURATION_MS + (rand_state >> 8) % DURATION_SPAN_MS;
+}
+
+static void measure(int num_pending)
+{
+	u32_t start, arm_cycles, abort_cycles;
+	s32_t durations[NUM_PROBES];
+	int i;
+
+	for (i = 0; i < num_pending; i++) {
+		k_timer_start(&pending[i], random_duration(), 0);
+	}
+
+	for (i = 0; i < NUM_PROBES; i++) {
+		durations[i] = random_duration();
+	}
+
+	start = k_cycle_get_32();
+	for (i = 0; i < NUM_PROBES; i++) {
+		k_timer_start(&probes[i], durations[i], 0);
+	}
+	arm_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < NUM_PROBES; i++) {
+		k_timer_stop(&probes[i]);
+	}
+	abort_cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%7d %12u %12u\n", num_pending,
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(arm_cycles, NUM_PROBES),
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(abort_cycles, NUM_PROBES));
+
+	for (i = 0; i < num_pending; i++) {
+		k_timer_stop(&pending[i]);
+	}
+}
+
+void main(void)
+{
+	int i;
+
+	TC_START("timeout queue");
+
+	for (i = 0; i < MAX_PENDING; i++) {
+		k_timer_init(&pending[i], NULL, NULL);
+	}
+
+	for (i = 0; i < NUM_PROBES; i++) {
+		k_timer_init(&probes[i], NULL, NULL);
+	}
+
+	TC_PRINT("pending     arm (ns)   abort (ns)\n");
+
+	for (i = 0; i < ARRAY_SIZE(pending_counts); i++) {
+		measure(pending_counts[i]);
+	}
+
+	TC_END_REPORT(TC_PASS);
+}
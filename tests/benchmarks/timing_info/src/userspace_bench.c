@@ -47,6 +47,7 @@ void drop_to_user_mode(void);
 void user_thread_creation(void);
 void syscall_overhead(void);
 void validation_overhead(void);
+void umutex_overhead(void);
 
 void userspace_bench(void)
 {
@@ -58,6 +59,7 @@ void userspace_bench(void)
 
 	validation_overhead();
 
+	umutex_overhead();
 }
 /******************************************************************************/
 
@@ -273,3 +275,126 @@ void validation_overhead(void)
 
 
 }
+
+/******************************************************************************/
+#define UMUTEX_LOOPS 1000
+
+K_MUTEX_DEFINE(umutex_kmutex);
+K_MUTEX_DEFINE(umutex_bench_kmutex);
+struct k_umutex umutex_bench = K_UMUTEX_INITIALIZER(&umutex_kmutex);
+
+__kernel struct k_thread my_thread_user_0;
+
+u32_t umutex_uncontended_start_time, umutex_uncontended_end_time;
+u32_t kmutex_uncontended_start_time, kmutex_uncontended_end_time;
+u32_t umutex_lock_start_time, umutex_lock_end_time;
+u32_t umutex_unlock_start_time, umutex_unlock_end_time;
+volatile u32_t umutex_waiting;
+
+void umutex_uncontended_user_thread(void *p1, void *p2, void *p3)
+{
+	k_tid_t self = k_current_get();
+	int i;
+
+	umutex_uncontended_start_time = userspace_read_timer_value();
+	for (i = 0; i < UMUTEX_LOOPS; i++) {
+		k_umutex_lock(&umutex_bench, self, K_FOREVER);
+		k_umutex_unlock(&umutex_bench, self);
+	}
+	umutex_uncontended_end_time = userspace_read_timer_value();
+
+	kmutex_uncontended_start_time = userspace_read_timer_value();
+	for (i = 0; i < UMUTEX_LOOPS; i++) {
+		k_mutex_lock(&umutex_bench_kmutex, K_FOREVER);
+		k_mutex_unlock(&umutex_bench_kmutex);
+	}
+	kmutex_uncontended_end_time = userspace_read_timer_value();
+}
+
+/* owns the user mutex until the other thread waits for it */
+void umutex_owner_user_thread(void *p1, void *p2, void *p3)
+{
+	k_tid_t self = k_current_get();
+
+	k_umutex_lock(&umutex_bench, self, K_FOREVER);
+
+	while (!umutex_waiting) {
+	}
+	umutex_lock_end_time = userspace_read_timer_value();
+
+	umutex_unlock_start_time = userspace_read_timer_value();
+	k_umutex_unlock(&umutex_bench, self);
+}
+
+void umutex_waiter_user_thread(void *p1, void *p2, void *p3)
+{
+	k_tid_t self = k_current_get();
+
+	umutex_waiting = 1;
+	umutex_lock_start_time = userspace_read_timer_value();
+	k_umutex_lock(&umutex_bench, self, K_FOREVER);
+	umutex_unlock_end_time = userspace_read_timer_value();
+	k_umutex_unlock(&umutex_bench, self);
+}
+
+static u32_t umutex_cycles(u32_t start_time, u32_t end_time)
+{
+	return (u32_t)((SUBTRACT_CLOCK_CYCLES(end_time) -
+			SUBTRACT_CLOCK_CYCLES(start_time)) & 0xFFFFFFFFULL);
+}
+
+void umutex_overhead(void)
+{
+	u32_t umutex_cycles_pair, kmutex_cycles_pair;
+	u32_t lock_cycles, unlock_cycles;
+
+	k_thread_access_grant(k_current_get(), &umutex_kmutex,
+			      &umutex_bench_kmutex, NULL);
+
+	/* uncontended lock and unlock, compared with a kernel mutex */
+	k_thread_create(&my_thread_user, my_stack_area, STACK_SIZE,
+			umutex_uncontended_user_thread,
+			NULL, NULL, NULL,
+			-1 /*priority*/, K_INHERIT_PERMS | K_USER, 0);
+
+	umutex_cycles_pair = umutex_cycles(umutex_uncontended_start_time,
+					   umutex_uncontended_end_time) /
+			     UMUTEX_LOOPS;
+	kmutex_cycles_pair = umutex_cycles(kmutex_uncontended_start_time,
+					   kmutex_uncontended_end_time) /
+			     UMUTEX_LOOPS;
+
+	/* the owner locks in user mode, the waiter then blocks on it */
+	umutex_waiting = 0;
+	k_thread_create(&my_thread_user, my_stack_area, STACK_SIZE,
+			umutex_owner_user_thread,
+			NULL, NULL, NULL,
+			2 /*priority*/, K_INHERIT_PERMS | K_USER, 0);
+	k_sleep(10);
+	k_thread_create(&my_thread_user_0, my_stack_area_0, STACK_SIZE,
+			umutex_waiter_user_thread,
+			NULL, NULL, NULL,
+			1 /*priority*/, K_INHERIT_PERMS | K_USER, 0);
+	k_sleep(10);
+
+	lock_cycles = umutex_cycles(umutex_lock_start_time,
+				    umutex_lock_end_time);
+	unlock_cycles = umutex_cycles(umutex_unlock_start_time,
+				      umutex_unlock_end_time);
+
+	PRINT_STATS("User mutex lock+unlock, uncontended",
+		    umutex_cycles_pair,
+		    (u32_t) (CYCLES_TO_NS(umutex_cycles_pair) & 0xFFFFFFFFULL));
+
+	PRINT_STATS("Kernel mutex lock+unlock from user mode",
+		    kmutex_cycles_pair,
+		    (u32_t) (CYCLES_TO_NS(kmutex_cycles_pair) & 0xFFFFFFFFULL));
+
+	PRINT_STATS("User mutex lock, contended",
+		    lock_cycles,
+		    (u32_t) (CYCLES_TO_NS(lock_cycles) & 0xFFFFFFFFULL));
+
+	PRINT_STATS("User mutex unlock to waiter",
+		    unlock_cycles,
+		    (u32_t) (CYCLES_TO_NS(unlock_cycles) & 0xFFFFFFFFULL));
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <irq_offload.h>
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include <board_soc.h>
+#endif
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_WAKES 10
+#define NUM_EXPIRIES 5
+#define PERIOD 10
+
+static struct k_thread tdata;
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static K_SEM_DEFINE(wake_sem, 0, 1);
+static struct k_timer test_timer;
+static int expiries;
+static volatile int wakes;
+
+static u32_t hist_total(struct k_latency_hist *hist)
+{
+	u32_t total = 0;
+
+	for (int i = 0; i < CONFIG_LATENCY_HIST_BUCKETS; i++) {
+		total += hist->count[i];
+	}
+
+	return total;
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < NUM_WAKES; i++) {
+		k_sem_take(&wake_sem, K_FOREVER);
+		wakes++;
+	}
+}
+
+static void expiry(struct k_timer *timer)
+{
+	expiries++;
+}
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+static void offload(void *param)
+{
+	ARG_UNUSED(param);
+}
+#endif
+
+/**
+ * @brief Verify the threads woken up by a semaphore are recorded
+ *
+ */
+void test_latency_hist_sem(void)
+{
+	struct k_latency_hist hist;
+
+	k_latency_hist_reset();
+	k_thread_create(&tdata, tstack, STACK_SIZE, waiter, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+
+	for (int i = 0; i < NUM_WAKES; i++) {
+		/* let the waiter pend on the semaphore */
+		k_sleep(1);
+		k_sem_give(&wake_sem);
+
+		/* not pending on a semaphore, which would be recorded too */
+		while (wakes == i) {
+			k_sleep(1);
+		}
+	}
+
+	zassert_equal(k_latency_hist_get(K_LATENCY_SEM_WAKE, &hist), 0, NULL);
+	zassert_equal(hist_total(&hist), NUM_WAKES, NULL);
+
+	zassert_equal(k_latency_hist_get(K_LATENCY_SRC_NUM, &hist), -EINVAL,
+		      NULL);
+}
+
+/**
+ * @brief Verify timer expiry function calls are recorded
+ *
+ */
+void test_latency_hist_timer(void)
+{
+	struct k_latency_hist hist;
+
+	k_latency_hist_reset();
+	k_timer_init(&test_timer, expiry, NULL);
+	k_timer_start(&test_timer, PERIOD, PERIOD);
+	while (expiries < NUM_EXPIRIES) {
+		k_timer_status_sync(&test_timer);
+	}
+	k_timer_stop(&test_timer);
+
+	zassert_equal(k_latency_hist_get(K_LATENCY_TIMER_EXPIRY, &hist), 0,
+		      NULL);
+	zassert_equal(hist_total(&hist), expiries, NULL);
+}
+
+/**
+ * @brief Verify interrupt dispatches are recorded per IRQ line
+ *
+ */
+void test_latency_hist_irq(void)
+{
+	struct k_latency_hist hist;
+
+	zassert_equal(k_latency_hist_irq_get(CONFIG_LATENCY_HIST_NUM_IRQS,
+					     &hist), -EINVAL, NULL);
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+	k_latency_hist_reset();
+	irq_offload(offload, NULL);
+
+	zassert_equal(k_latency_hist_irq_get(OFFLOAD_SW_IRQ, &hist), 0, NULL);
+	zassert_equal(hist_total(&hist), 1, NULL);
+#endif
+}
+
+/**
+ * @brief Verify the histograms can be printed and cleared
+ *
+ */
+void test_latency_hist_dump(void)
+{
+	struct k_latency_hist hist;
+
+	k_latency_hist_dump();
+	k_latency_hist_reset();
+
+	zassert_equal(k_latency_hist_get(K_LATENCY_SEM_WAKE, &hist), 0, NULL);
+	zassert_equal(hist_total(&hist), 0, NULL);
+	zassert_equal(hist.max, 0, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_latency_hist,
+			 ztest_unit_test(test_latency_hist_sem),
+			 ztest_unit_test(test_latency_hist_timer),
+			 ztest_unit_test(test_latency_hist_irq),
+			 ztest_unit_test(test_latency_hist_dump));
+	ztest_run_test_suite(test_latency_hist);
+}
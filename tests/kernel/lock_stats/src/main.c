@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+#include <spinlock.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_LOCKS 8
+
+/* time the locks are held, in us */
+#define HOLD_TIME 1000
+
+#define US_TO_CYCLES(us) ((u64_t)(us) * sys_clock_hw_cycles_per_sec / 1000000)
+
+static struct k_spinlock test_lock = K_SPINLOCK_INITIALIZER(test_lock);
+K_MUTEX_DEFINE(test_mutex);
+static struct k_mutex dyn_mutex;
+
+static struct k_thread tdata;
+static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static K_SEM_DEFINE(locked_sem, 0, 1);
+
+static void holder(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_mutex_lock(&test_mutex, K_FOREVER);
+	k_sem_give(&locked_sem);
+	k_busy_wait(HOLD_TIME);
+	k_mutex_unlock(&test_mutex);
+}
+
+/**
+ * @brief Verify spinlock acquisitions and hold times are recorded
+ *
+ * @see k_spin_lock(), k_spin_unlock()
+ */
+void test_lock_stats_spinlock(void)
+{
+	k_spinlock_key_t key;
+	int i;
+
+	for (i = 0; i < NUM_LOCKS; i++) {
+		key = k_spin_lock(&test_lock);
+		if (i == 0) {
+			k_busy_wait(HOLD_TIME);
+		}
+		k_spin_unlock(&test_lock, key);
+	}
+
+	/**TESTPOINT: the lock is named after its variable */
+	zassert_equal(strcmp(test_lock.stats.name, "test_lock"), 0, NULL);
+	zassert_equal(test_lock.stats.acquisitions, NUM_LOCKS, NULL);
+	zassert_true(test_lock.stats.hold_max >= US_TO_CYCLES(HOLD_TIME),
+		     NULL);
+#ifndef CONFIG_SMP
+	zassert_equal(test_lock.stats.contended, 0, NULL);
+#endif
+}
+
+/**
+ * @brief Verify waiting for a mutex is recorded as contention
+ *
+ * @see k_mutex_lock(), k_mutex_unlock()
+ */
+void test_lock_stats_mutex(void)
+{
+	k_tid_t tid;
+
+	zassert_equal(strcmp(test_mutex.stats.name, "test_mutex"), 0, NULL);
+
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, holder, NULL, NULL,
+			      NULL, K_PRIO_PREEMPT(1), 0, 0);
+	k_sem_take(&locked_sem, K_FOREVER);
+
+	/**TESTPOINT: the holder makes this thread wait */
+	zassert_equal(k_mutex_lock(&test_mutex, K_FOREVER), 0, NULL);
+	zassert_equal(k_mutex_lock(&test_mutex, K_FOREVER), 0, NULL);
+	k_mutex_unlock(&test_mutex);
+	k_mutex_unlock(&test_mutex);
+	k_thread_abort(tid);
+
+	/* recursive locking is a single acquisition */
+	zassert_equal(test_mutex.stats.acquisitions, 2, NULL);
+	zassert_equal(test_mutex.stats.contended, 1, NULL);
+	zassert_true(test_mutex.stats.wait_max >= US_TO_CYCLES(HOLD_TIME),
+		     NULL);
+	zassert_true(test_mutex.stats.wait_cycles >=
+		     test_mutex.stats.wait_max, NULL);
+	zassert_true(test_mutex.stats.hold_max >= US_TO_CYCLES(HOLD_TIME),
+		     NULL);
+}
+
+/**
+ * @brief Verify the lock statistics dump
+ *
+ * @see k_lock_stats_dump(), k_lock_stats_name_set()
+ */
+void test_lock_stats_dump(void)
+{
+	k_mutex_init(&dyn_mutex);
+	k_lock_stats_name_set(&dyn_mutex, "dyn_mutex");
+	k_mutex_lock(&dyn_mutex, K_NO_WAIT);
+	k_mutex_unlock(&dyn_mutex);
+
+	zassert_equal(dyn_mutex.stats.acquisitions, 1, NULL);
+	k_lock_stats_dump(NUM_LOCKS);
+
+	/**TESTPOINT: initializing a mutex again clears its statistics */
+	k_mutex_init(&dyn_mutex);
+	zassert_equal(dyn_mutex.stats.acquisitions, 0, NULL);
+	zassert_false(dyn_mutex.stats.registered, NULL);
+}
+
+/**
+ * @brief Verify locks can be removed from the statistics
+ *
+ * @see k_lock_stats_remove()
+ */
+void test_lock_stats_remove(void)
+{
+	struct k_spinlock stack_lock;
+	k_spinlock_key_t key;
+
+	memset(&stack_lock, 0, sizeof(stack_lock));
+	key = k_spin_lock(&stack_lock);
+	k_spin_unlock(&stack_lock, key);
+	zassert_true(stack_lock.stats.registered, NULL);
+
+	/**TESTPOINT: a lock going out of scope is not printed anymore */
+	k_lock_stats_remove(&stack_lock);
+	zassert_false(stack_lock.stats.registered, NULL);
+	k_lock_stats_dump(NUM_LOCKS);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_lock_stats,
+			 ztest_unit_test(test_lock_stats_spinlock),
+			 ztest_unit_test(test_lock_stats_mutex),
+			 ztest_unit_test(test_lock_stats_dump),
+			 ztest_unit_test(test_lock_stats_remove));
+	ztest_run_test_suite(test_lock_stats);
+}
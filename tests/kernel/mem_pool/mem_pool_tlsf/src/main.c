@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <misc/tlsf.h>
+
+#define HEAP_SIZE 4096
+#define BLK_NUM_MAX 64
+
+/* odd sized requests, rounded up to 256 bytes by the memory pool */
+#define BLK_SIZE_ODD 100
+
+static char __aligned(sizeof(void *)) heap_buf[HEAP_SIZE];
+static struct sys_tlsf heap;
+
+/* memory pool of the same size, for comparison */
+K_MEM_POOL_DEFINE(bpool, 64, HEAP_SIZE, 1, 4);
+
+static void *block[BLK_NUM_MAX];
+
+/* the largest allocation reported is the largest one that succeeds */
+static void check_largest_free(struct sys_tlsf *h)
+{
+	struct sys_tlsf_stats stats;
+	void *ptr;
+
+	sys_tlsf_stats_get(h, &stats);
+	zassert_true(stats.largest_free > 0, NULL);
+	zassert_true(stats.largest_free <= stats.free_bytes, NULL);
+
+	zassert_is_null(sys_tlsf_alloc(h, stats.largest_free + 1), NULL);
+	ptr = sys_tlsf_alloc(h, stats.largest_free);
+	zassert_not_null(ptr, NULL);
+	sys_tlsf_free(h, ptr);
+}
+
+static void check_empty(struct sys_tlsf *h, size_t initial_free)
+{
+	struct sys_tlsf_stats stats;
+
+	sys_tlsf_stats_get(h, &stats);
+	zassert_equal(stats.free_bytes, initial_free, NULL);
+	zassert_equal(stats.used_bytes, 0, NULL);
+	zassert_equal(stats.fragmentation, 0, NULL);
+	check_largest_free(h);
+}
+
+/**
+ * @brief Verify TLSF allocation and free
+ *
+ * @see sys_tlsf_alloc(), sys_tlsf_free()
+ */
+void test_tlsf_alloc_free(void)
+{
+	struct sys_tlsf_stats stats;
+	size_t initial_free;
+	int i, n;
+
+	zassert_equal(sys_tlsf_init(&heap, heap_buf, sizeof(heap_buf)), 0,
+		      NULL);
+	sys_tlsf_stats_get(&heap, &stats);
+	initial_free = stats.free_bytes;
+	zassert_true(initial_free > HEAP_SIZE - 32, NULL);
+
+	zassert_is_null(sys_tlsf_alloc(&heap, 0), NULL);
+	zassert_is_null(sys_tlsf_alloc(&heap, HEAP_SIZE), NULL);
+
+	for (n = 0; n < BLK_NUM_MAX; n++) {
+		block[n] = sys_tlsf_alloc(&heap, n + 1);
+		if (block[n] == NULL) {
+			break;
+		}
+		zassert_false((uintptr_t)block[n] % sizeof(void *), NULL);
+		memset(block[n], n, n + 1);
+	}
+	zassert_equal(n, BLK_NUM_MAX, NULL);
+
+	/* blocks do not overlap */
+	for (i = 0; i < n; i++) {
+		zassert_equal(((u8_t *)block[i])[i], i, NULL);
+	}
+
+	/* free in an order that exercises merging on both sides */
+	for (i = 0; i < n; i += 2) {
+		sys_tlsf_free(&heap, block[i]);
+	}
+	for (i = 1; i < n; i += 2) {
+		sys_tlsf_free(&heap, block[i]);
+	}
+	sys_tlsf_free(&heap, NULL);
+
+	check_empty(&heap, initial_free);
+}
+
+/**
+ * @brief Verify free blocks get merged and fragmentation is reported
+ *
+ * @see sys_tlsf_stats_get()
+ */
+void test_tlsf_coalesce(void)
+{
+	struct sys_tlsf_stats stats;
+	size_t initial_free;
+	void *a, *b, *c, *big;
+
+	sys_tlsf_init(&heap, heap_buf, sizeof(heap_buf));
+	sys_tlsf_stats_get(&heap, &stats);
+	initial_free = stats.free_bytes;
+
+	a = sys_tlsf_alloc(&heap, HEAP_SIZE / 4);
+	b = sys_tlsf_alloc(&heap, HEAP_SIZE / 4);
+	c = sys_tlsf_alloc(&heap, HEAP_SIZE / 4);
+	zassert_true(a && b && c, NULL);
+
+	sys_tlsf_free(&heap, a);
+	sys_tlsf_free(&heap, c);
+	sys_tlsf_stats_get(&heap, &stats);
+	zassert_true(stats.fragmentation > 0, NULL);
+	zassert_is_null(sys_tlsf_alloc(&heap, HEAP_SIZE / 2), NULL);
+	check_largest_free(&heap);
+
+	/* freeing the middle block merges all three with the tail */
+	sys_tlsf_free(&heap, b);
+	check_empty(&heap, initial_free);
+
+	big = sys_tlsf_alloc(&heap, HEAP_SIZE - 512);
+	zassert_not_null(big, NULL);
+	sys_tlsf_free(&heap, big);
+}
+
+/**
+ * @brief Compare TLSF and memory pool on odd sized requests
+ *
+ * The memory pool rounds each request up to a power of four of its
+ * minimum block size, the TLSF heap only to the pointer size.
+ */
+void test_tlsf_vs_mem_pool(void)
+{
+	u32_t start, pool_cycles, tlsf_cycles;
+	int i, pool_n, tlsf_n;
+
+	sys_tlsf_init(&heap, heap_buf, sizeof(heap_buf));
+
+	start = k_cycle_get_32();
+	for (pool_n = 0; pool_n < BLK_NUM_MAX; pool_n++) {
+		block[pool_n] = k_mem_pool_malloc(&bpool, BLK_SIZE_ODD);
+		if (block[pool_n] == NULL) {
+			break;
+		}
+	}
+	for (i = 0; i < pool_n; i++) {
+		k_free(block[i]);
+	}
+	pool_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (tlsf_n = 0; tlsf_n < BLK_NUM_MAX; tlsf_n++) {
+		block[tlsf_n] = sys_tlsf_alloc(&heap, BLK_SIZE_ODD);
+		if (block[tlsf_n] == NULL) {
+			break;
+		}
+	}
+	for (i = 0; i < tlsf_n; i++) {
+		sys_tlsf_free(&heap, block[i]);
+	}
+	tlsf_cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%d byte blocks in %d bytes:\n", BLK_SIZE_ODD, HEAP_SIZE);
+	TC_PRINT("pool %d (%u ns), tlsf %d (%u ns)\n",
+		 pool_n, SYS_CLOCK_HW_CYCLES_TO_NS_AVG(pool_cycles, pool_n),
+		 tlsf_n, SYS_CLOCK_HW_CYCLES_TO_NS_AVG(tlsf_cycles, tlsf_n));
+
+	zassert_equal(pool_n, HEAP_SIZE / 256, NULL);
+	zassert_true(tlsf_n > 2 * pool_n, NULL);
+}
+
+/**
+ * @brief Verify k_malloc() and k_free() on the TLSF backed heap
+ *
+ * @see k_malloc(), k_calloc(), k_free(), k_malloc_stats_get()
+ */
+void test_k_malloc_tlsf(void)
+{
+	struct sys_tlsf_stats before, stats;
+	u8_t *mem;
+	int i;
+
+	k_malloc_stats_get(&before);
+
+	mem = k_calloc(BLK_SIZE_ODD, 3);
+	zassert_not_null(mem, NULL);
+	for (i = 0; i < BLK_SIZE_ODD * 3; i++) {
+		zassert_equal(mem[i], 0, NULL);
+	}
+
+	k_malloc_stats_get(&stats);
+	zassert_true(stats.used_bytes >= BLK_SIZE_ODD * 3, NULL);
+	zassert_true(stats.free_bytes < before.free_bytes, NULL);
+
+	k_free(mem);
+	k_malloc_stats_get(&stats);
+	zassert_equal(stats.free_bytes, before.free_bytes, NULL);
+	zassert_equal(stats.used_bytes, before.used_bytes, NULL);
+
+	zassert_is_null(k_malloc(CONFIG_HEAP_MEM_POOL_SIZE), NULL);
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_mem_pool_tlsf,
+			 ztest_unit_test(test_tlsf_alloc_free),
+			 ztest_unit_test(test_tlsf_coalesce),
+			 ztest_unit_test(test_tlsf_vs_mem_pool),
+			 ztest_unit_test(test_k_malloc_tlsf));
+	ztest_run_test_suite(test_mem_pool_tlsf);
+}
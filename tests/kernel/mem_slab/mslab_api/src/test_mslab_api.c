@@ -11,6 +11,8 @@
 K_MEM_SLAB_DEFINE(kmslab, BLK_SIZE, BLK_NUM, BLK_ALIGN);
 static char __aligned(BLK_ALIGN) tslab[BLK_SIZE * BLK_NUM];
 static struct k_mem_slab mslab;
+static char __aligned(BLK_ALIGN) islab_buf[BLK_SIZE * BLK_NUM];
+static struct k_mem_slab islab;
 
 void tmslab_alloc_free(void *data)
 {
@@ -222,3 +224,68 @@ void test_mslab_used_get(void)
 	tmslab_used_get(&mslab);
 	tmslab_used_get(&kmslab);
 }
+
+static void check_blocks_distinct(void **block, int num)
+{
+	for (int i = 0; i < num; i++) {
+		zassert_true((char *)block[i] >= islab_buf &&
+			     (char *)block[i] < islab_buf + sizeof(islab_buf),
+			     NULL);
+		zassert_true((u32_t)block[i] % BLK_ALIGN == 0, NULL);
+		for (int j = 0; j < i; j++) {
+			zassert_not_equal(block[i], block[j], NULL);
+		}
+	}
+}
+
+/**
+ * @brief Verify blocks freed while the slab is first used are handed out
+ * again along with the blocks never used
+ *
+ * @details Free blocks in between allocations on a new slab, until all
+ * its blocks are allocated, then check no block is handed out twice and
+ * the slab runs empty. Allocate all blocks again once they are freed.
+ *
+ * @ingroup kernel_memory_slab_tests
+ */
+void test_mslab_alloc_free_interleaved(void)
+{
+	void *block[BLK_NUM], *block_fail;
+	int i;
+
+	k_mem_slab_init(&islab, islab_buf, BLK_SIZE, BLK_NUM);
+
+	for (i = 0; i < BLK_NUM; i++) {
+		zassert_true(k_mem_slab_alloc(&islab, &block[i], K_NO_WAIT) == 0,
+			     NULL);
+		/* give back the first block, then take it again */
+		k_mem_slab_free(&islab, &block[0]);
+		zassert_true(k_mem_slab_alloc(&islab, &block[0], K_NO_WAIT) == 0,
+			     NULL);
+		zassert_equal(k_mem_slab_num_used_get(&islab), i + 1, NULL);
+		zassert_equal(k_mem_slab_num_free_get(&islab), BLK_NUM - 1 - i,
+			      NULL);
+	}
+
+	check_blocks_distinct(block, BLK_NUM);
+	zassert_equal(k_mem_slab_alloc(&islab, &block_fail, K_NO_WAIT), -ENOMEM,
+		      NULL);
+
+	for (i = 0; i < BLK_NUM; i++) {
+		k_mem_slab_free(&islab, &block[i]);
+	}
+	zassert_equal(k_mem_slab_num_free_get(&islab), BLK_NUM, NULL);
+
+	for (i = 0; i < BLK_NUM; i++) {
+		zassert_true(k_mem_slab_alloc(&islab, &block[i], K_NO_WAIT) == 0,
+			     NULL);
+	}
+	check_blocks_distinct(block, BLK_NUM);
+	zassert_equal(k_mem_slab_alloc(&islab, &block_fail, K_NO_WAIT), -ENOMEM,
+		      NULL);
+
+	for (i = 0; i < BLK_NUM; i++) {
+		k_mem_slab_free(&islab, &block[i]);
+	}
+	zassert_equal(k_mem_slab_num_used_get(&islab), 0, NULL);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file
+ * Measure the cost of an allocate/free pair on a memory slab shared by
+ * several threads, each holding a few blocks at a time.
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE 512
+#define THREAD_NUM 4
+#define ROUNDS 1000
+#define BLK_BATCH 4
+#define BLK_SIZE 16
+#define BLK_ALIGN 4
+#define SLAB_BLOCKS (THREAD_NUM * BLK_BATCH)
+
+K_MEM_SLAB_DEFINE(mslab, BLK_SIZE, SLAB_BLOCKS, BLK_ALIGN);
+static K_THREAD_STACK_ARRAY_DEFINE(tstack, THREAD_NUM, STACK_SIZE);
+static struct k_thread tdata[THREAD_NUM];
+static u32_t cycles[THREAD_NUM];
+static struct k_sem sync_sema;
+
+static void tmslab_churn(void *p1, void *p2, void *p3)
+{
+	int id = POINTER_TO_INT(p1);
+	void *block[BLK_BATCH];
+	u32_t start;
+	int i, j;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < ROUNDS; i++) {
+		for (j = 0; j < BLK_BATCH; j++) {
+			zassert_true(k_mem_slab_alloc(&mslab, &block[j],
+						      K_NO_WAIT) == 0, NULL);
+		}
+		for (j = 0; j < BLK_BATCH; j++) {
+			k_mem_slab_free(&mslab, &block[j]);
+		}
+	}
+	cycles[id] = k_cycle_get_32() - start;
+	k_sem_give(&sync_sema);
+}
+
+void test_mslab_perf(void)
+{
+	u32_t total = 0;
+	int i;
+
+	k_sem_init(&sync_sema, 0, THREAD_NUM);
+
+	for (i = 0; i < THREAD_NUM; i++) {
+		k_thread_create(&tdata[i], tstack[i], STACK_SIZE,
+				tmslab_churn, INT_TO_POINTER(i), NULL, NULL,
+				K_PRIO_PREEMPT(1), 0, 0);
+	}
+
+	for (i = 0; i < THREAD_NUM; i++) {
+		k_sem_take(&sync_sema, K_FOREVER);
+	}
+
+	for (i = 0; i < THREAD_NUM; i++) {
+		total += cycles[i];
+	}
+
+	TC_PRINT("%d threads, alloc+free: %u ns\n", THREAD_NUM,
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(total,
+					       THREAD_NUM * ROUNDS * BLK_BATCH));
+
+	zassert_equal(k_mem_slab_num_used_get(&mslab), 0, NULL);
+	zassert_equal(k_mem_slab_num_free_get(&mslab), SLAB_BLOCKS, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mslab_perf,
+			 ztest_unit_test(test_mslab_perf));
+	ztest_run_test_suite(mslab_perf);
+}
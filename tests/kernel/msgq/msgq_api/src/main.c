@@ -21,6 +21,10 @@ extern void test_msgq_purge_when_put(void);
 extern void test_msgq_attrs_get(void);
 extern void test_msgq_alloc(void);
 extern void test_msgq_pend_thread(void);
+extern void test_msgq_put_get_n(void);
+extern void test_msgq_peek_n(void);
+extern void test_msgq_n_pend_thread(void);
+extern void test_msgq_batch_throughput(void);
 #ifdef CONFIG_USERSPACE
 extern void test_msgq_user_thread(void);
 extern void test_msgq_user_thread_overflow(void);
@@ -28,6 +32,7 @@ extern void test_msgq_user_put_fail(void);
 extern void test_msgq_user_get_fail(void);
 extern void test_msgq_user_attrs_get(void);
 extern void test_msgq_user_purge_when_put(void);
+extern void test_msgq_user_put_get_n(void);
 #else
 #define dummy_test(_name) \
 	static void _name(void) \
@@ -41,12 +46,14 @@ dummy_test(test_msgq_user_put_fail);
 dummy_test(test_msgq_user_get_fail);
 dummy_test(test_msgq_user_attrs_get);
 dummy_test(test_msgq_user_purge_when_put);
+dummy_test(test_msgq_user_put_get_n);
 #endif /* CONFIG_USERSPACE */
 
 K_MEM_POOL_DEFINE(test_pool, 128, 128, 2, 4);
 
 extern struct k_msgq kmsgq;
 extern struct k_msgq msgq;
+extern struct k_msgq bmsgq;
 extern struct k_sem end_sema;
 extern struct k_thread tdata;
 K_THREAD_STACK_EXTERN(tstack);
@@ -54,8 +61,8 @@ K_THREAD_STACK_EXTERN(tstack);
 /*test case main entry*/
 void test_main(void)
 {
-	k_thread_access_grant(k_current_get(), &kmsgq, &msgq, &end_sema,
-			      &tdata, &tstack, NULL);
+	k_thread_access_grant(k_current_get(), &kmsgq, &msgq, &bmsgq,
+			      &end_sema, &tdata, &tstack, NULL);
 
 	k_thread_resource_pool_assign(k_current_get(), &test_pool);
 
@@ -74,6 +81,11 @@ void test_main(void)
 			 ztest_unit_test(test_msgq_purge_when_put),
 			 ztest_user_unit_test(test_msgq_user_purge_when_put),
 			 ztest_unit_test(test_msgq_pend_thread),
+			 ztest_unit_test(test_msgq_put_get_n),
+			 ztest_user_unit_test(test_msgq_user_put_get_n),
+			 ztest_unit_test(test_msgq_peek_n),
+			 ztest_unit_test(test_msgq_n_pend_thread),
+			 ztest_unit_test(test_msgq_batch_throughput),
 			 ztest_unit_test(test_msgq_alloc));
 	ztest_run_test_suite(msgq_api);
 }
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+#define BATCH_MSGQ_LEN 8
+#define BATCH_LEN 16
+#define NUM_SAMPLES 1024
+
+struct sample {
+	u32_t seq;
+	u32_t value[3];
+};
+
+K_MSGQ_DEFINE(bmsgq, sizeof(struct sample), BATCH_MSGQ_LEN, 4);
+K_MSGQ_DEFINE(tput_msgq, sizeof(struct sample), BATCH_LEN, 4);
+__kernel struct k_msgq pmsgq;
+static char __aligned(4) pbuffer[sizeof(struct sample) * BATCH_MSGQ_LEN];
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+
+static struct sample tx[BATCH_LEN];
+static struct sample rx[BATCH_LEN];
+
+static void fill(struct sample *s, u32_t first, u32_t num)
+{
+	for (u32_t i = 0; i < num; i++) {
+		s[i].seq = first + i;
+		s[i].value[0] = ~(first + i);
+	}
+}
+
+static void check(struct sample *s, u32_t first, u32_t num)
+{
+	for (u32_t i = 0; i < num; i++) {
+		zassert_equal(s[i].seq, first + i, NULL);
+		zassert_equal(s[i].value[0], ~(first + i), NULL);
+	}
+}
+
+static void put_get_n(struct k_msgq *q)
+{
+	k_msgq_purge(q);
+	fill(tx, 0, BATCH_LEN);
+
+	/**TESTPOINT: put_n sends as many messages as fit */
+	zassert_equal(k_msgq_put_n(q, tx, 5, K_NO_WAIT), 5, NULL);
+	zassert_equal(k_msgq_get_n(q, rx, 3, K_NO_WAIT), 3, NULL);
+	check(rx, 0, 3);
+
+	/* wraps around the end of the ring buffer */
+	zassert_equal(k_msgq_put_n(q, &tx[5], BATCH_LEN - 5, K_NO_WAIT),
+		      BATCH_MSGQ_LEN - 2, NULL);
+	zassert_equal(k_msgq_num_used_get(q), BATCH_MSGQ_LEN, NULL);
+	zassert_equal(k_msgq_put_n(q, tx, 1, K_NO_WAIT), -ENOMSG, NULL);
+
+	/**TESTPOINT: get_n receives across the wrap */
+	zassert_equal(k_msgq_get_n(q, rx, BATCH_LEN, K_NO_WAIT),
+		      BATCH_MSGQ_LEN, NULL);
+	check(rx, 3, BATCH_MSGQ_LEN);
+	zassert_equal(k_msgq_get_n(q, rx, 1, K_NO_WAIT), -ENOMSG, NULL);
+	zassert_equal(k_msgq_get_n(q, rx, 1, TIMEOUT), -EAGAIN, NULL);
+}
+
+static void peek_n(struct k_msgq *q)
+{
+	struct sample *s;
+	u32_t num;
+
+	fill(tx, 0, BATCH_LEN);
+
+	zassert_equal(k_msgq_peek_n(q, (void **)&s, BATCH_LEN), 0, NULL);
+
+	/* leave the read position two messages before the buffer end */
+	zassert_equal(k_msgq_put_n(q, tx, BATCH_MSGQ_LEN - 2, K_NO_WAIT),
+		      BATCH_MSGQ_LEN - 2, NULL);
+	zassert_equal(k_msgq_get_n(q, NULL, BATCH_MSGQ_LEN - 2, K_NO_WAIT),
+		      BATCH_MSGQ_LEN - 2, NULL);
+	zassert_equal(k_msgq_put_n(q, tx, 5, K_NO_WAIT), 5, NULL);
+
+	/**TESTPOINT: peek_n returns the contiguous run, in place */
+	num = k_msgq_peek_n(q, (void **)&s, BATCH_LEN);
+	zassert_equal(num, 2, NULL);
+	check(s, 0, num);
+	zassert_equal(k_msgq_num_used_get(q), 5, NULL);
+
+	/**TESTPOINT: get_n with a NULL buffer releases peeked messages */
+	zassert_equal(k_msgq_get_n(q, NULL, num, K_NO_WAIT), num, NULL);
+
+	num = k_msgq_peek_n(q, (void **)&s, BATCH_LEN);
+	zassert_equal(num, 3, NULL);
+	check(s, 2, num);
+	zassert_equal(k_msgq_get_n(q, NULL, num, K_NO_WAIT), num, NULL);
+	zassert_equal(k_msgq_num_used_get(q), 0, NULL);
+}
+
+static void receiver_entry(void *p1, void *p2, void *p3)
+{
+	struct sample s;
+
+	zassert_equal(k_msgq_get_n((struct k_msgq *)p1, &s, BATCH_LEN,
+				   K_FOREVER), 1, NULL);
+	check(&s, 0, 1);
+}
+
+static void sender_entry(void *p1, void *p2, void *p3)
+{
+	struct sample *s = &tx[BATCH_MSGQ_LEN + 1];
+
+	zassert_equal(k_msgq_put_n((struct k_msgq *)p1, s, 2, K_FOREVER), 1,
+		      NULL);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test sending and receiving several messages at once
+ * @see k_msgq_put_n(), k_msgq_get_n()
+ */
+void test_msgq_put_get_n(void)
+{
+	put_get_n(&bmsgq);
+}
+
+/**
+ * @brief Test sending and receiving several messages at once from a
+ * user thread
+ * @see k_msgq_put_n(), k_msgq_get_n()
+ */
+void test_msgq_user_put_get_n(void)
+{
+	put_get_n(&bmsgq);
+}
+
+/**
+ * @brief Test inspecting messages in place
+ * @see k_msgq_peek_n(), k_msgq_get_n()
+ */
+void test_msgq_peek_n(void)
+{
+	k_msgq_init(&pmsgq, pbuffer, sizeof(struct sample), BATCH_MSGQ_LEN);
+
+	peek_n(&pmsgq);
+}
+
+/**
+ * @brief Test batched calls serve waiting threads
+ * @see k_msgq_put_n(), k_msgq_get_n()
+ */
+void test_msgq_n_pend_thread(void)
+{
+	k_tid_t tid;
+
+	k_msgq_purge(&bmsgq);
+	fill(tx, 0, BATCH_LEN);
+
+	/**TESTPOINT: put_n hands the first message to a waiting receiver */
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, receiver_entry,
+			      &bmsgq, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_put_n(&bmsgq, tx, 3, K_NO_WAIT), 3, NULL);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_num_used_get(&bmsgq), 2, NULL);
+	k_thread_abort(tid);
+
+	/**TESTPOINT: get_n refills the ring from a waiting sender */
+	zassert_equal(k_msgq_put_n(&bmsgq, &tx[3], BATCH_MSGQ_LEN - 2,
+				   K_NO_WAIT), BATCH_MSGQ_LEN - 2, NULL);
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, sender_entry,
+			      &bmsgq, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_get_n(&bmsgq, rx, BATCH_LEN, K_NO_WAIT),
+		      BATCH_MSGQ_LEN, NULL);
+	check(rx, 1, BATCH_MSGQ_LEN);
+	zassert_equal(k_msgq_get_n(&bmsgq, rx, BATCH_LEN, K_NO_WAIT), 1,
+		      NULL);
+	check(rx, BATCH_MSGQ_LEN + 1, 1);
+	k_thread_abort(tid);
+}
+
+/**
+ * @brief Compare the throughput of batched and single message calls
+ * @see k_msgq_put_n(), k_msgq_get_n(), k_msgq_put(), k_msgq_get()
+ */
+void test_msgq_batch_throughput(void)
+{
+	u32_t start, single_cycles, batch_cycles;
+	u32_t i, j;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < NUM_SAMPLES; i += BATCH_LEN) {
+		fill(tx, i, BATCH_LEN);
+		for (j = 0; j < BATCH_LEN; j++) {
+			zassert_equal(k_msgq_put(&tput_msgq, &tx[j],
+						 K_NO_WAIT), 0, NULL);
+		}
+		for (j = 0; j < BATCH_LEN; j++) {
+			zassert_equal(k_msgq_get(&tput_msgq, &rx[j],
+						 K_NO_WAIT), 0, NULL);
+		}
+		check(rx, i, BATCH_LEN);
+	}
+	single_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < NUM_SAMPLES; i += BATCH_LEN) {
+		fill(tx, i, BATCH_LEN);
+		zassert_equal(k_msgq_put_n(&tput_msgq, tx, BATCH_LEN,
+					   K_NO_WAIT), BATCH_LEN, NULL);
+		zassert_equal(k_msgq_get_n(&tput_msgq, rx, BATCH_LEN,
+					   K_NO_WAIT), BATCH_LEN, NULL);
+		check(rx, i, BATCH_LEN);
+	}
+	batch_cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%d byte messages, put+get: single %u ns, by %d %u ns\n",
+		 (int)sizeof(struct sample),
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(single_cycles, NUM_SAMPLES),
+		 BATCH_LEN,
+		 SYS_CLOCK_HW_CYCLES_TO_NS_AVG(batch_cycles, NUM_SAMPLES));
+}
+
+/**
+ * @}
+ */
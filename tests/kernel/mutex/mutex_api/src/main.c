@@ -10,6 +10,10 @@ extern void test_mutex_reent_lock_forever(void);
 extern void test_mutex_reent_lock_no_wait(void);
 extern void test_mutex_reent_lock_timeout_fail(void);
 extern void test_mutex_reent_lock_timeout_pass(void);
+extern void test_umutex_lock_unlock(void);
+extern void test_umutex_lock_no_wait(void);
+extern void test_umutex_contended(void);
+extern void test_umutex_race(void);
 
 /*test case main entry*/
 void test_main(void)
@@ -19,7 +23,11 @@ void test_main(void)
 			 ztest_unit_test(test_mutex_reent_lock_forever),
 			 ztest_unit_test(test_mutex_reent_lock_no_wait),
 			 ztest_unit_test(test_mutex_reent_lock_timeout_fail),
-			 ztest_unit_test(test_mutex_reent_lock_timeout_pass)
+			 ztest_unit_test(test_mutex_reent_lock_timeout_pass),
+			 ztest_unit_test(test_umutex_lock_unlock),
+			 ztest_unit_test(test_umutex_lock_no_wait),
+			 ztest_unit_test(test_umutex_contended),
+			 ztest_unit_test(test_umutex_race)
 			 );
 	ztest_run_test_suite(mutex_api);
 }
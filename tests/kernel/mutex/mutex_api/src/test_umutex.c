@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE 512
+#define OWNER_PRIO K_PRIO_PREEMPT(10)
+#define WAITER_PRIO K_PRIO_PREEMPT(2)
+#define RACE_THREADS 3
+#define RACE_PRIO K_PRIO_PREEMPT(5)
+#define RACE_LOOPS 1000
+
+K_MUTEX_DEFINE(umutex_kmutex);
+static struct k_umutex umutex = K_UMUTEX_INITIALIZER(&umutex_kmutex);
+
+static K_THREAD_STACK_DEFINE(owner_stack, STACK_SIZE);
+static struct k_thread owner_data;
+static K_THREAD_STACK_DEFINE(waiter_stack, STACK_SIZE);
+static struct k_thread waiter_data;
+
+static K_SEM_DEFINE(locked_sema, 0, 1);
+static K_SEM_DEFINE(release_sema, 0, 1);
+static K_SEM_DEFINE(done_sema, 0, 1);
+
+static K_THREAD_STACK_ARRAY_DEFINE(race_stacks, RACE_THREADS, STACK_SIZE);
+static struct k_thread race_threads[RACE_THREADS];
+static K_SEM_DEFINE(race_sema, 0, RACE_THREADS);
+
+static int waiter_ret;
+static k_tid_t volatile race_holder;
+static atomic_t race_errors;
+
+static void owner_entry(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_umutex_lock(&umutex, k_current_get(), K_FOREVER), 0,
+		      NULL);
+	k_sem_give(&locked_sema);
+	k_sem_take(&release_sema, K_FOREVER);
+	zassert_equal(k_umutex_unlock(&umutex, k_current_get()), 0, NULL);
+}
+
+static void waiter_entry(void *p1, void *p2, void *p3)
+{
+	waiter_ret = k_umutex_lock(&umutex, k_current_get(), K_FOREVER);
+	if (waiter_ret == 0) {
+		k_umutex_unlock(&umutex, k_current_get());
+	}
+	k_sem_give(&done_sema);
+}
+
+static k_tid_t start_owner(void)
+{
+	k_tid_t tid = k_thread_create(&owner_data, owner_stack, STACK_SIZE,
+				      owner_entry, NULL, NULL, NULL,
+				      OWNER_PRIO, 0, 0);
+
+	zassert_equal(k_sem_take(&locked_sema, TIMEOUT), 0, NULL);
+	return tid;
+}
+
+/**
+ * @brief Test locking and unlocking an uncontended user mutex
+ * @see k_umutex_lock(), k_umutex_unlock()
+ */
+void test_umutex_lock_unlock(void)
+{
+	k_tid_t self = k_current_get();
+
+	/**TESTPOINT: the lock word holds the owner */
+	zassert_equal(k_umutex_lock(&umutex, self, K_NO_WAIT), 0, NULL);
+	zassert_equal(atomic_get(&umutex.val), (atomic_val_t)self, NULL);
+
+	/**TESTPOINT: user mutexes are not recursive */
+	zassert_equal(k_umutex_lock(&umutex, self, K_FOREVER), -EDEADLK, NULL);
+
+	zassert_equal(k_umutex_unlock(&umutex, self), 0, NULL);
+	zassert_equal(atomic_get(&umutex.val), 0, NULL);
+	zassert_equal(k_umutex_unlock(&umutex, self), -EPERM, NULL);
+}
+
+/**
+ * @brief Test a user mutex locked by another thread is not waited for
+ * with K_NO_WAIT
+ * @see k_umutex_lock()
+ */
+void test_umutex_lock_no_wait(void)
+{
+	k_tid_t owner = start_owner();
+
+	zassert_equal(k_umutex_lock(&umutex, k_current_get(), K_NO_WAIT),
+		      -EBUSY, NULL);
+	zassert_equal(atomic_get(&umutex.val), (atomic_val_t)owner, NULL);
+
+	/**TESTPOINT: only the owner unlocks the mutex */
+	zassert_equal(k_umutex_unlock(&umutex, k_current_get()), -EPERM, NULL);
+	zassert_equal(atomic_get(&umutex.val), (atomic_val_t)owner, NULL);
+
+	k_sem_give(&release_sema);
+	k_sleep(TIMEOUT);
+	zassert_equal(atomic_get(&umutex.val), 0, NULL);
+}
+
+/**
+ * @brief Test contention on a user mutex
+ *
+ * The owner locked the mutex without entering the kernel, and the waiter
+ * must still raise its priority.
+ *
+ * @see k_umutex_lock(), k_umutex_unlock()
+ */
+void test_umutex_contended(void)
+{
+	k_tid_t owner = start_owner();
+	k_tid_t waiter;
+
+	waiter = k_thread_create(&waiter_data, waiter_stack, STACK_SIZE,
+				 waiter_entry, NULL, NULL, NULL,
+				 WAITER_PRIO, 0, 0);
+	k_sleep(TIMEOUT);
+
+	/**TESTPOINT: the waiter blocks and raises the owner's priority */
+	zassert_equal(atomic_get(&umutex.val),
+		      (atomic_val_t)owner | _K_UMUTEX_CONTENDED, NULL);
+	zassert_equal(k_thread_priority_get(owner), WAITER_PRIO, NULL);
+	zassert_equal(k_sem_take(&done_sema, K_NO_WAIT), -EBUSY, NULL);
+
+	/**TESTPOINT: unlocking hands the mutex over to the waiter */
+	k_sem_give(&release_sema);
+	zassert_equal(k_sem_take(&done_sema, TIMEOUT), 0, NULL);
+	zassert_equal(waiter_ret, 0, NULL);
+	zassert_equal(atomic_get(&umutex.val), 0, NULL);
+
+	k_sleep(TIMEOUT);
+	k_thread_abort(waiter);
+}
+
+static void race_entry(void *p1, void *p2, void *p3)
+{
+	k_tid_t self = k_current_get();
+	int i;
+
+	for (i = 0; i < RACE_LOOPS; i++) {
+		if (k_umutex_lock(&umutex, self, K_FOREVER)) {
+			atomic_inc(&race_errors);
+			continue;
+		}
+
+		if (race_holder) {
+			atomic_inc(&race_errors);
+		}
+		race_holder = self;
+		k_busy_wait(i % 7);
+		if (race_holder != self) {
+			atomic_inc(&race_errors);
+		}
+		race_holder = NULL;
+
+		if (k_umutex_unlock(&umutex, self)) {
+			atomic_inc(&race_errors);
+		}
+		k_busy_wait(i % 5);
+	}
+
+	k_sem_give(&race_sema);
+}
+
+/**
+ * @brief Test threads racing for a user mutex
+ *
+ * Time slicing preempts the threads anywhere, so that some lock the mutex
+ * in user mode while others go through the kernel, and the mutex must
+ * never have two owners.
+ *
+ * @see k_umutex_lock(), k_umutex_unlock()
+ */
+void test_umutex_race(void)
+{
+	int i;
+
+	k_sched_time_slice_set(1, RACE_PRIO);
+
+	for (i = 0; i < RACE_THREADS; i++) {
+		k_thread_create(&race_threads[i], race_stacks[i], STACK_SIZE,
+				race_entry, NULL, NULL, NULL,
+				RACE_PRIO, 0, 0);
+	}
+
+	for (i = 0; i < RACE_THREADS; i++) {
+		zassert_equal(k_sem_take(&race_sema, K_FOREVER), 0, NULL);
+	}
+
+	k_sched_time_slice_set(0, 0);
+
+	/**TESTPOINT: the mutex always had a single owner */
+	zassert_equal(atomic_get(&race_errors), 0, NULL);
+	zassert_equal(atomic_get(&umutex.val), 0, NULL);
+}
@@ -21,6 +21,9 @@ extern void test_pipe_block_put_sema(void);
 extern void test_pipe_get_put(void);
 extern void test_half_pipe_get_put(void);
 extern void test_half_pipe_block_put_sema(void);
+extern void test_pipe_claim_commit(void);
+extern void test_pipe_claim_wait(void);
+extern void test_pipe_claim_throughput(void);
 #ifdef CONFIG_USERSPACE
 extern void test_pipe_user_thread2thread(void);
 extern void test_pipe_user_put_fail(void);
@@ -69,6 +72,9 @@ void test_main(void)
 			 ztest_unit_test(test_pipe_block_put_sema),
 			 ztest_unit_test(test_pipe_get_put),
 			 ztest_unit_test(test_half_pipe_block_put_sema),
-			 ztest_unit_test(test_half_pipe_get_put));
+			 ztest_unit_test(test_half_pipe_get_put),
+			 ztest_unit_test(test_pipe_claim_commit),
+			 ztest_unit_test(test_pipe_claim_wait),
+			 ztest_unit_test(test_pipe_claim_throughput));
 	ztest_run_test_suite(pipe_api);
 }
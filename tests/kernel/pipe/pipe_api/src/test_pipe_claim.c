@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define CLAIM_PIPE_LEN 16
+#define TIMEOUT 100
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* bytes moved by each throughput measurement, and per call */
+#define TPUT_BYTES 65536
+#define TPUT_CHUNK 32
+#define TPUT_PIPE_LEN 1024
+
+K_PIPE_DEFINE(claim_pipe, CLAIM_PIPE_LEN, 4);
+K_PIPE_DEFINE(tput_pipe, TPUT_PIPE_LEN, 4);
+
+static struct k_thread claim_tdata;
+static K_THREAD_STACK_DEFINE(claim_tstack, STACK_SIZE);
+static struct k_thread other_tdata;
+static K_THREAD_STACK_DEFINE(other_tstack, STACK_SIZE);
+static K_SEM_DEFINE(claim_sema, 0, 1);
+
+static unsigned char tx[CLAIM_PIPE_LEN];
+static unsigned char rx[CLAIM_PIPE_LEN];
+static unsigned char chunk[TPUT_CHUNK];
+
+static void fill(unsigned char *data, int first, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = first + i;
+	}
+}
+
+static void check(unsigned char *data, int first, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		zassert_equal(data[i], (unsigned char)(first + i), NULL);
+	}
+}
+
+static void claim_put(int first, size_t count, s32_t timeout)
+{
+	void *data;
+	size_t size;
+
+	while (count) {
+		size = count;
+		zassert_equal(k_pipe_put_claim(&claim_pipe, &data, &size,
+					       timeout), 0, NULL);
+		fill(data, first, size);
+		zassert_equal(k_pipe_put_commit(&claim_pipe, size), 0, NULL);
+		first += size;
+		count -= size;
+	}
+}
+
+static void claim_get(int first, size_t count, s32_t timeout)
+{
+	void *data;
+	size_t size;
+
+	while (count) {
+		size = count;
+		zassert_equal(k_pipe_get_claim(&claim_pipe, &data, &size,
+					       timeout), 0, NULL);
+		check(data, first, size);
+		zassert_equal(k_pipe_get_commit(&claim_pipe, size), 0, NULL);
+		first += size;
+		count -= size;
+	}
+}
+
+static void tclaim_get(void *p1, void *p2, void *p3)
+{
+	claim_get(0, CLAIM_PIPE_LEN, K_FOREVER);
+	k_sem_give(&claim_sema);
+}
+
+static void tclaim_put(void *p1, void *p2, void *p3)
+{
+	claim_put(0, CLAIM_PIPE_LEN, K_FOREVER);
+	k_sem_give(&claim_sema);
+}
+
+static void tpipe_get(void *p1, void *p2, void *p3)
+{
+	size_t bytes;
+
+	zassert_equal(k_pipe_get(&claim_pipe, rx, 8, &bytes, 8, K_FOREVER),
+		      0, NULL);
+	check(rx, 0, 8);
+	k_sem_give(&claim_sema);
+}
+
+static void tpipe_put(void *p1, void *p2, void *p3)
+{
+	size_t bytes;
+
+	fill(tx, 0, CLAIM_PIPE_LEN);
+	zassert_equal(k_pipe_put(&claim_pipe, tx, CLAIM_PIPE_LEN, &bytes,
+				 CLAIM_PIPE_LEN, K_FOREVER), 0, NULL);
+	k_sem_give(&claim_sema);
+}
+
+static void start_thread(k_thread_entry_t entry)
+{
+	k_thread_create(&claim_tdata, claim_tstack, STACK_SIZE, entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT / 2);
+}
+
+static void stop_thread(void)
+{
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	k_thread_abort(&claim_tdata);
+}
+
+static u32_t bytes_per_sec(u32_t cycles)
+{
+	if (cycles == 0) {
+		return 0;
+	}
+
+	return (u64_t)TPUT_BYTES * sys_clock_hw_cycles_per_sec / cycles;
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Test writing and reading a pipe in place
+ * @see k_pipe_put_claim(), k_pipe_put_commit(), k_pipe_get_claim(),
+ * k_pipe_get_commit()
+ */
+void test_pipe_claim_commit(void)
+{
+	void *data;
+	size_t size, bytes;
+
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &data, &size, K_NO_WAIT),
+		      -EAGAIN, NULL);
+	zassert_equal(size, 0, NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, &size, K_NO_WAIT),
+		      -EINVAL, NULL);
+
+	/* leave the indexes 4 bytes before the end of the buffer */
+	zassert_equal(k_pipe_put(&claim_pipe, tx, CLAIM_PIPE_LEN - 4, &bytes,
+				 CLAIM_PIPE_LEN - 4, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_pipe_get(&claim_pipe, rx, CLAIM_PIPE_LEN - 4, &bytes,
+				 CLAIM_PIPE_LEN - 4, K_NO_WAIT), 0, NULL);
+
+	/**TESTPOINT: claims stop at the end of the buffer */
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, &size, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(size, 4, NULL);
+	fill(data, 0, size);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, size + 1), -EINVAL, NULL);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, size), 0, NULL);
+
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, &size, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(size, CLAIM_PIPE_LEN - 4, NULL);
+	fill(data, 4, size);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, size), 0, NULL);
+
+	/**TESTPOINT: a full pipe has nothing to claim */
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &data, &size, TIMEOUT),
+		      -EAGAIN, NULL);
+
+	/**TESTPOINT: the reader gets the data in place */
+	size = CLAIM_PIPE_LEN;
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &data, &size, K_NO_WAIT),
+		      0, NULL);
+	zassert_equal(size, 4, NULL);
+	check(data, 0, size);
+	zassert_equal(k_pipe_get_commit(&claim_pipe, size), 0, NULL);
+
+	/**TESTPOINT: data in the buffer is readable with k_pipe_get() */
+	zassert_equal(k_pipe_get(&claim_pipe, rx, CLAIM_PIPE_LEN - 4, &bytes,
+				 CLAIM_PIPE_LEN - 4, K_NO_WAIT), 0, NULL);
+	check(rx, 4, CLAIM_PIPE_LEN - 4);
+	zassert_equal(k_pipe_get_commit(&claim_pipe, 1), -EINVAL, NULL);
+}
+
+/**
+ * @brief Test claims waiting on a pipe are woken up
+ * @see k_pipe_put_claim(), k_pipe_put_commit(), k_pipe_get_claim(),
+ * k_pipe_get_commit()
+ */
+void test_pipe_claim_wait(void)
+{
+	size_t bytes;
+
+	/**TESTPOINT: a waiting reader claim is woken up by k_pipe_put() */
+	start_thread(tclaim_get);
+	fill(tx, 0, CLAIM_PIPE_LEN);
+	zassert_equal(k_pipe_put(&claim_pipe, tx, CLAIM_PIPE_LEN, &bytes,
+				 CLAIM_PIPE_LEN, K_NO_WAIT), 0, NULL);
+	stop_thread();
+
+	/**TESTPOINT: a waiting k_pipe_get() gets the data committed */
+	start_thread(tpipe_get);
+	claim_put(0, 8, K_NO_WAIT);
+	stop_thread();
+
+	/**TESTPOINT: a waiting k_pipe_put() fills the space released */
+	claim_put(0, CLAIM_PIPE_LEN, K_NO_WAIT);
+	start_thread(tpipe_put);
+	claim_get(0, CLAIM_PIPE_LEN, K_NO_WAIT);
+	stop_thread();
+
+	/**TESTPOINT: a waiting writer claim is woken up by k_pipe_get() */
+	start_thread(tclaim_put);
+	zassert_equal(k_pipe_get(&claim_pipe, rx, CLAIM_PIPE_LEN, &bytes,
+				 CLAIM_PIPE_LEN, K_NO_WAIT), 0, NULL);
+	check(rx, 0, CLAIM_PIPE_LEN);
+	stop_thread();
+	claim_get(0, CLAIM_PIPE_LEN, K_NO_WAIT);
+
+	/**TESTPOINT: a reader claim whose data went to the k_pipe_get()
+	 * queued behind it waits for more
+	 */
+	start_thread(tclaim_get);
+	k_thread_create(&other_tdata, other_tstack, STACK_SIZE, tpipe_get,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT / 2);
+	claim_put(0, 8, K_NO_WAIT);
+	zassert_equal(k_sem_take(&claim_sema, TIMEOUT), 0, NULL);
+	k_thread_abort(&other_tdata);
+	claim_put(0, CLAIM_PIPE_LEN, K_NO_WAIT);
+	stop_thread();
+}
+
+/**
+ * @brief Compare the throughput of copying and in place transfers
+ * @see k_pipe_put(), k_pipe_get(), k_pipe_put_claim(), k_pipe_get_claim()
+ */
+void test_pipe_claim_throughput(void)
+{
+	u32_t start, copy_cycles, claim_cycles;
+	size_t i, size, bytes;
+	void *data;
+
+	fill(chunk, 0, sizeof(chunk));
+
+	start = k_cycle_get_32();
+	for (i = 0; i < TPUT_BYTES; i += TPUT_CHUNK) {
+		k_pipe_put(&tput_pipe, chunk, TPUT_CHUNK, &bytes, TPUT_CHUNK,
+			   K_NO_WAIT);
+		k_pipe_get(&tput_pipe, chunk, TPUT_CHUNK, &bytes, TPUT_CHUNK,
+			   K_NO_WAIT);
+	}
+	copy_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < TPUT_BYTES; i += size) {
+		size = TPUT_CHUNK;
+		k_pipe_put_claim(&tput_pipe, &data, &size, K_NO_WAIT);
+		k_pipe_put_commit(&tput_pipe, size);
+		k_pipe_get_claim(&tput_pipe, &data, &size, K_NO_WAIT);
+		k_pipe_get_commit(&tput_pipe, size);
+	}
+	claim_cycles = k_cycle_get_32() - start;
+
+	check(chunk, 0, sizeof(chunk));
+
+	TC_PRINT("%d byte chunks, bytes/s: put/get %u, claim/commit %u\n",
+		 TPUT_CHUNK, bytes_per_sec(copy_cycles),
+		 bytes_per_sec(claim_cycles));
+}
+
+/**
+ * @}
+ */
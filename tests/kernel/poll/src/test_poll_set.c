@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define NUM_SEMS 32
+#define TIMEOUT 100
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+struct fifo_msg {
+	void *private;
+	u32_t msg;
+};
+
+static struct k_poll_set set;
+static struct k_sem sems[NUM_SEMS];
+static struct k_poll_event sem_events[NUM_SEMS];
+
+static struct k_fifo set_fifo;
+static struct k_poll_signal set_signal;
+static struct k_poll_event fifo_event, signal_event;
+
+static struct k_thread signaler_thread;
+static K_THREAD_STACK_DEFINE(signaler_stack, STACK_SIZE);
+
+static void signaler_entry(void *p1, void *p2, void *p3)
+{
+	static struct fifo_msg msg;
+
+	k_sleep(TIMEOUT / 2);
+	k_fifo_put(&set_fifo, &msg);
+	k_poll_signal(&set_signal, 0);
+}
+
+/**
+ * @brief Test only the ready events of a poll set are returned
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_init(), k_poll_set_add(), k_poll_set_wait()
+ */
+void test_poll_set_ready(void)
+{
+	struct k_poll_event *ready[NUM_SEMS];
+	int i;
+
+	k_poll_set_init(&set);
+	for (i = 0; i < NUM_SEMS; i++) {
+		k_sem_init(&sems[i], 0, 1);
+		k_poll_event_init(&sem_events[i], K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &sems[i]);
+		zassert_equal(k_poll_set_add(&set, &sem_events[i]), 0, NULL);
+	}
+	zassert_equal(k_poll_set_add(&set, &sem_events[0]), -EBUSY, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, NUM_SEMS, K_NO_WAIT),
+		      -EAGAIN, NULL);
+
+	/**TESTPOINT: the events signaled are returned in order */
+	k_sem_give(&sems[20]);
+	k_sem_give(&sems[5]);
+	zassert_equal(k_poll_set_wait(&set, ready, NUM_SEMS, K_NO_WAIT), 2,
+		      NULL);
+	zassert_equal(ready[0], &sem_events[20], NULL);
+	zassert_equal(ready[1], &sem_events[5], NULL);
+	zassert_equal(ready[0]->state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+
+	/**TESTPOINT: an event still ready is returned again */
+	zassert_equal(k_sem_take(&sems[20], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, NUM_SEMS, K_NO_WAIT), 1,
+		      NULL);
+	zassert_equal(ready[0], &sem_events[5], NULL);
+	zassert_equal(k_sem_take(&sems[5], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, NUM_SEMS, K_NO_WAIT),
+		      -EAGAIN, NULL);
+
+	/**TESTPOINT: at most the requested number of events are returned */
+	for (i = 0; i < 3; i++) {
+		k_sem_give(&sems[i]);
+	}
+	zassert_equal(k_poll_set_wait(&set, ready, 2, K_NO_WAIT), 2, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, NUM_SEMS, K_NO_WAIT), 3,
+		      NULL);
+	zassert_equal(ready[0], &sem_events[2], NULL);
+
+	/**TESTPOINT: a removed event is not returned anymore */
+	for (i = 0; i < NUM_SEMS; i++) {
+		zassert_equal(k_poll_set_remove(&set, &sem_events[i]), 0,
+			      NULL);
+	}
+	zassert_equal(k_poll_set_remove(&set, &sem_events[0]), -EINVAL, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, NUM_SEMS, K_NO_WAIT),
+		      -EAGAIN, NULL);
+}
+
+/**
+ * @brief Test waiting on a poll set for objects signaled by another thread
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_wait(), k_poll_set_remove()
+ */
+void test_poll_set_wait(void)
+{
+	struct k_poll_event *ready[2];
+	bool fifo_ready = false, signal_ready = false;
+	int i, rc;
+
+	k_poll_set_init(&set);
+	k_fifo_init(&set_fifo);
+	k_poll_signal_init(&set_signal);
+	k_poll_event_init(&fifo_event, K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_fifo);
+	k_poll_event_init(&signal_event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_signal);
+	zassert_equal(k_poll_set_add(&set, &fifo_event), 0, NULL);
+	zassert_equal(k_poll_set_add(&set, &signal_event), 0, NULL);
+
+	zassert_equal(k_poll_set_wait(&set, ready, 2, TIMEOUT / 4), -EAGAIN,
+		      NULL);
+
+	k_thread_create(&signaler_thread, signaler_stack, STACK_SIZE,
+			signaler_entry, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+
+	/**TESTPOINT: the waiter wakes up for the events signaled, together
+	 * or not depending on when it runs: each one is consumed once
+	 * returned, or it would be returned again
+	 */
+	while (!fifo_ready || !signal_ready) {
+		rc = k_poll_set_wait(&set, ready, 2, TIMEOUT);
+		zassert_true(rc > 0, NULL);
+
+		for (i = 0; i < rc; i++) {
+			if (ready[i] == &fifo_event && !fifo_ready) {
+				zassert_equal(ready[i]->state,
+					      K_POLL_STATE_FIFO_DATA_AVAILABLE,
+					      NULL);
+				zassert_not_null(k_fifo_get(&set_fifo,
+							    K_NO_WAIT), NULL);
+				fifo_ready = true;
+			} else if (ready[i] == &signal_event && !signal_ready) {
+				zassert_equal(ready[i]->state,
+					      K_POLL_STATE_SIGNALED, NULL);
+				k_poll_signal_reset(&set_signal);
+				signal_ready = true;
+			} else {
+				zassert_unreachable("Unexpected event");
+			}
+		}
+	}
+
+	zassert_equal(k_poll_set_wait(&set, ready, 2, K_NO_WAIT), -EAGAIN,
+		      NULL);
+
+	zassert_equal(k_poll_set_remove(&set, &fifo_event), 0, NULL);
+	zassert_equal(k_poll_set_remove(&set, &signal_event), 0, NULL);
+}
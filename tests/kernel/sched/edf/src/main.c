@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+
+#define NUM_THREADS 3
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* length of a test run, in ms */
+#define RUN_TIME 400
+
+struct k_thread edf_threads[NUM_THREADS];
+K_THREAD_STACK_ARRAY_DEFINE(edf_stacks, NUM_THREADS, STACK_SIZE);
+
+struct k_thread bg_thread;
+K_THREAD_STACK_DEFINE(bg_stack, STACK_SIZE);
+
+static volatile u32_t bg_count;
+
+/* runs for p1 us per job, and signals completion */
+static void periodic(void *p1, void *p2, void *p3)
+{
+	int work = (int)p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_busy_wait(work);
+		k_thread_edf_wait();
+	}
+}
+
+/* never completes its first job */
+static void hog(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_busy_wait(1000);
+	}
+}
+
+static void background(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		bg_count++;
+		k_busy_wait(100);
+	}
+}
+
+static k_tid_t create(int i, k_thread_entry_t entry, int work, s32_t delay)
+{
+	return k_thread_create(&edf_threads[i], edf_stacks[i], STACK_SIZE,
+			       entry, (void *)work, NULL, NULL,
+			       K_LOWEST_APPLICATION_THREAD_PRIO, 0, delay);
+}
+
+/**
+ * @brief Verify the parameter checks and the utilization bound
+ *
+ * @see k_thread_edf_set()
+ */
+void test_edf_admission(void)
+{
+	k_tid_t a = create(0, periodic, 0, K_FOREVER);
+	k_tid_t b = create(1, periodic, 0, K_FOREVER);
+
+	/**TESTPOINT: invalid parameters are rejected */
+	zassert_equal(k_thread_edf_set(a, -10, 5, 0), -EINVAL, NULL);
+	zassert_equal(k_thread_edf_set(a, 100, 0, 0), -EINVAL, NULL);
+	zassert_equal(k_thread_edf_set(a, 100, 50, 40), -EINVAL, NULL);
+	zassert_equal(k_thread_edf_set(a, 100, 50, 200), -EINVAL, NULL);
+
+	/**TESTPOINT: threads are admitted up to the utilization bound */
+	zassert_equal(k_thread_edf_set(a, 100, 50, 0), 0, NULL);
+	zassert_equal(k_thread_edf_set(b, 100, 50, 0), -EBUSY, NULL);
+	zassert_equal(k_thread_edf_set(b, 200, 25, 50), -EBUSY, NULL);
+	zassert_equal(k_thread_edf_set(b, 100,
+				       CONFIG_SCHED_EDF_UTILIZATION_MAX - 50,
+				       0), 0, NULL);
+
+	/**TESTPOINT: a thread's own share is replaced, not added */
+	zassert_equal(k_thread_edf_set(a, 200, 100, 0), 0, NULL);
+	zassert_equal(k_thread_edf_set(a, 100, 51, 0), -EBUSY, NULL);
+
+	/**TESTPOINT: leaving the class or aborting releases the share */
+	zassert_equal(k_thread_edf_set(b, 0, 0, 0), 0, NULL);
+	zassert_equal(k_thread_edf_set(a, 100, 90, 0), 0, NULL);
+	k_thread_abort(a);
+	zassert_equal(k_thread_edf_set(b, 100, 90, 0), 0, NULL);
+	k_thread_abort(b);
+}
+
+/**
+ * @brief Verify periodic threads within their budget meet all deadlines
+ *
+ * @see k_thread_edf_set(), k_thread_edf_wait(), k_thread_edf_stats_get()
+ */
+void test_edf_periodic(void)
+{
+	static const s32_t period[NUM_THREADS] = { 10, 20, 50 };
+	static const s32_t budget[NUM_THREADS] = { 3, 4, 10 };
+	struct k_thread_edf_stats stats;
+	k_tid_t tid[NUM_THREADS];
+	int i;
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		/* use half of the budget */
+		tid[i] = create(i, periodic, budget[i] * 500, K_FOREVER);
+		zassert_equal(k_thread_edf_set(tid[i], period[i], budget[i],
+					       0), 0, NULL);
+		k_thread_start(tid[i]);
+	}
+
+	k_sleep(RUN_TIME);
+
+	for (i = 0; i < NUM_THREADS; i++) {
+		k_thread_edf_stats_get(tid[i], &stats);
+		k_thread_abort(tid[i]);
+
+		TC_PRINT("period %d ms: %u jobs, %u misses, %u overruns\n",
+			 period[i], stats.jobs, stats.misses, stats.overruns);
+		zassert_true(stats.jobs >= RUN_TIME / period[i] - 1, NULL);
+		zassert_equal(stats.misses, 0, NULL);
+		zassert_equal(stats.overruns, 0, NULL);
+	}
+}
+
+/**
+ * @brief Verify a thread overrunning its budget gets throttled
+ *
+ * The overrunning thread must neither make the other EDF thread miss its
+ * deadlines nor starve lower priority threads.
+ *
+ * @see k_thread_edf_set(), k_thread_edf_stats_get()
+ */
+void test_edf_overrun(void)
+{
+	struct k_thread_edf_stats stats;
+	k_tid_t good, bad, bg;
+
+	bg_count = 0;
+	bg = k_thread_create(&bg_thread, bg_stack, STACK_SIZE, background,
+			     NULL, NULL, NULL,
+			     K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
+
+	good = create(0, periodic, 2000, K_FOREVER);
+	zassert_equal(k_thread_edf_set(good, 20, 5, 0), 0, NULL);
+	bad = create(1, hog, 0, K_FOREVER);
+	zassert_equal(k_thread_edf_set(bad, 50, 20, 0), 0, NULL);
+	k_thread_start(good);
+	k_thread_start(bad);
+
+	k_sleep(RUN_TIME);
+
+	k_thread_edf_stats_get(bad, &stats);
+	k_thread_abort(bad);
+	zassert_true(stats.overruns >= RUN_TIME / 50 - 1, NULL);
+	zassert_true(stats.misses >= RUN_TIME / 50 - 1, NULL);
+
+	k_thread_edf_stats_get(good, &stats);
+	k_thread_abort(good);
+	zassert_equal(stats.misses, 0, NULL);
+	zassert_equal(stats.overruns, 0, NULL);
+
+	k_thread_abort(bg);
+	zassert_true(bg_count > 0, "background thread starved");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_edf,
+			 ztest_unit_test(test_edf_admission),
+			 ztest_unit_test(test_edf_periodic),
+			 ztest_unit_test(test_edf_overrun));
+	ztest_run_test_suite(test_edf);
+}
@@ -434,6 +434,152 @@ void test_wakeup_pending_threads(void)
 	test_wakeup_threads();
 }
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+static void affinity_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	int thread_num = (int)p1;
+
+	while (1) {
+		tinfo[thread_num].cpu_id = _arch_curr_cpu()->id;
+		tinfo[thread_num].executed++;
+		k_yield();
+	}
+}
+
+/**
+ * @brief Test CPU affinity masks
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Pin preemptible threads to a single CPU each, while
+ * they yield to each other, and check they only ever run there
+ * even after moving them to another CPU.
+ */
+void test_cpu_mask_threads(void)
+{
+	int i, j;
+
+	zassert_equal(k_thread_cpu_mask_set(k_current_get(), 0), -EINVAL,
+		      NULL);
+
+	for (i = 0; i < THREADS_NUM; i++) {
+		tinfo[i].cpu_id = -1;
+		tinfo[i].tid = k_thread_create(&tthread[i], tstack[i],
+					       STACK_SIZE, affinity_entry,
+					       (void *)i, NULL, NULL,
+					       K_PRIO_PREEMPT(10), 0,
+					       K_FOREVER);
+		zassert_equal(k_thread_cpu_mask_set(tinfo[i].tid, BIT(i)), 0,
+			      NULL);
+		k_thread_start(tinfo[i].tid);
+	}
+
+	for (j = 0; j < 2; j++) {
+		for (i = 0; i < 10; i++) {
+			k_busy_wait(DELAY_US / 10);
+			for (int t = 0; t < THREADS_NUM; t++) {
+				zassert_true(tinfo[t].cpu_id == -1 ||
+					     tinfo[t].cpu_id ==
+					     (t + j) % THREADS_NUM,
+					     "thread %d ran on CPU %d", t,
+					     tinfo[t].cpu_id);
+			}
+		}
+
+		/* rotate the threads to the next CPU */
+		for (i = 0; i < THREADS_NUM; i++) {
+			tinfo[i].cpu_id = -1;
+			k_thread_cpu_mask_set(tinfo[i].tid,
+					      BIT((i + j + 1) % THREADS_NUM));
+		}
+		k_sleep(10);
+	}
+
+	for (i = 0; i < THREADS_NUM; i++) {
+		zassert_true(tinfo[i].executed > 0,
+			     "thread %d did not execute", i);
+	}
+
+	abort_threads(THREADS_NUM);
+	cleanup_resources();
+}
+#else
+void test_cpu_mask_threads(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+#if defined(CONFIG_SCHED_CPU_RUNQ) && defined(CONFIG_SCHED_DEADLINE)
+static void deadline_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+	int thread_num = (int)p1;
+	int next = (thread_num + 1) % THREADS_NUM;
+
+	while (1) {
+		k_thread_deadline_set(tinfo[next].tid,
+				      1000 + tinfo[thread_num].executed % 1000);
+		tinfo[thread_num].executed++;
+		k_yield();
+	}
+}
+
+/**
+ * @brief Test deadline changes of queued threads
+ *
+ * @ingroup kernel_smp_tests
+ *
+ * @details Have preemptible threads change the deadline of each
+ * other, and the main thread change all of them, while they sit in
+ * the run queues of other CPUs, and check they all keep running.
+ */
+void test_deadline_requeue_threads(void)
+{
+	int i, j;
+
+	for (i = 0; i < THREADS_NUM; i++) {
+		tinfo[i].tid = k_thread_create(&tthread[i], tstack[i],
+					       STACK_SIZE, deadline_entry,
+					       (void *)i, NULL, NULL,
+					       K_PRIO_PREEMPT(10), 0,
+					       K_FOREVER);
+	}
+
+	for (i = 0; i < THREADS_NUM; i++) {
+		k_thread_start(tinfo[i].tid);
+	}
+
+	for (j = 0; j < 1000; j++) {
+		for (i = 0; i < THREADS_NUM; i++) {
+			k_thread_deadline_set(tinfo[i].tid, 1000 + j);
+		}
+		k_busy_wait(DELAY_US / 100);
+	}
+
+	for (i = 0; i < THREADS_NUM; i++) {
+		tinfo[i].executed = 0;
+	}
+	k_sleep(10);
+
+	for (i = 0; i < THREADS_NUM; i++) {
+		zassert_true(tinfo[i].executed > 0,
+			     "thread %d stopped running", i);
+	}
+
+	abort_threads(THREADS_NUM);
+	cleanup_resources();
+}
+#else
+void test_deadline_requeue_threads(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	/* Sleep a bit to guarantee that both CPUs enter an idle
@@ -450,7 +596,9 @@ void test_main(void)
 			 ztest_unit_test(test_yield_threads),
 			 ztest_unit_test(test_sleep_threads),
 			 ztest_unit_test(test_wakeup_threads),
-			 ztest_unit_test(test_wakeup_pending_threads)
+			 ztest_unit_test(test_wakeup_pending_threads),
+			 ztest_unit_test(test_cpu_mask_threads),
+			 ztest_unit_test(test_deadline_requeue_threads)
 			 );
 	ztest_run_test_suite(smp);
 }
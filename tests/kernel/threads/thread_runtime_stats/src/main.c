@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr.h>
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* time the worker threads keep the CPU busy, in us */
+#define BUSY_TIME 10000
+
+#define US_TO_CYCLES(us) ((u64_t)(us) * sys_clock_hw_cycles_per_sec / 1000000)
+
+struct k_thread tdata;
+K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+
+static struct k_sem sync_sem;
+static struct k_sem done_sem;
+
+static void busy(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_busy_wait(BUSY_TIME);
+	k_sem_give(&done_sem);
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sem_take(&sync_sem, K_FOREVER);
+	k_sem_give(&done_sem);
+}
+
+/**
+ * @brief Verify the CPU time of a thread is charged to it
+ *
+ * @see k_thread_runtime_stats_get()
+ */
+void test_runtime_stats_execution(void)
+{
+	struct k_thread_runtime_stats stats;
+	k_tid_t tid;
+
+	k_sem_init(&done_sem, 0, 1);
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, busy, NULL, NULL,
+			      NULL, K_PRIO_PREEMPT(1), 0, 0);
+	k_sem_take(&done_sem, K_FOREVER);
+
+	k_thread_runtime_stats_get(tid, &stats);
+	k_thread_abort(tid);
+
+	/**TESTPOINT: the busy time and the switch in are accounted */
+	zassert_true(stats.execution_cycles >= US_TO_CYCLES(BUSY_TIME), NULL);
+	zassert_true(stats.switches > 0, NULL);
+	zassert_equal(stats.idle_cycles, 0, NULL);
+}
+
+/**
+ * @brief Verify the time from ready to running is accounted as latency
+ *
+ * @see k_thread_runtime_stats_get()
+ */
+void test_runtime_stats_latency(void)
+{
+	struct k_thread_runtime_stats stats;
+	k_tid_t tid;
+
+	k_sem_init(&sync_sem, 0, 1);
+	k_sem_init(&done_sem, 0, 1);
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, waiter, NULL, NULL,
+			      NULL, K_PRIO_PREEMPT(1), 0, 0);
+	k_sleep(1);
+
+	/* keep the ready waiter from running for BUSY_TIME */
+	k_sched_lock();
+	k_sem_give(&sync_sem);
+	k_busy_wait(BUSY_TIME);
+	k_sched_unlock();
+
+	k_sem_take(&done_sem, K_FOREVER);
+	k_thread_runtime_stats_get(tid, &stats);
+	k_thread_abort(tid);
+
+	/**TESTPOINT: the delayed wake up is the worst latency seen */
+	zassert_true(stats.latency_max >= US_TO_CYCLES(BUSY_TIME), NULL);
+	zassert_true(stats.latency_avg > 0, NULL);
+	zassert_true(stats.latency_avg <= stats.latency_max, NULL);
+}
+
+/**
+ * @brief Verify the system wide accounting includes the idle time
+ *
+ * @see k_thread_runtime_stats_all_get()
+ */
+void test_runtime_stats_all(void)
+{
+	struct k_thread_runtime_stats before, after, self;
+
+	k_thread_runtime_stats_all_get(&before);
+	k_sleep(BUSY_TIME / 1000);
+	k_thread_runtime_stats_all_get(&after);
+	k_thread_runtime_stats_get(k_current_get(), &self);
+
+	/**TESTPOINT: sleeping leaves the CPU to the idle thread */
+	zassert_true(after.idle_cycles > before.idle_cycles, NULL);
+	zassert_true(after.execution_cycles - before.execution_cycles >=
+		     after.idle_cycles - before.idle_cycles, NULL);
+	zassert_true(after.switches > before.switches, NULL);
+	zassert_true(after.execution_cycles >= self.execution_cycles, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_thread_runtime_stats,
+			 ztest_unit_test(test_runtime_stats_execution),
+			 ztest_unit_test(test_runtime_stats_latency),
+			 ztest_unit_test(test_runtime_stats_all));
+	ztest_run_test_suite(test_thread_runtime_stats);
+}
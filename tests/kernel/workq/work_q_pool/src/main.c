@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_THREADS 3
+#define NUM_OF_WORK 6
+#define POOL_PRIO K_PRIO_PREEMPT(1)
+
+/* time spent by the busy work handlers, in us */
+#define BUSY_TIME 1000
+
+static struct k_work_q prio_q;
+static struct k_thread prio_threads[1];
+static K_THREAD_STACK_ARRAY_DEFINE(prio_stacks, 1, STACK_SIZE);
+
+static struct k_work_q pool_q;
+static struct k_thread pool_threads[NUM_THREADS];
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, NUM_THREADS, STACK_SIZE);
+
+static struct k_work work[NUM_OF_WORK];
+static struct k_work blocker, slow[NUM_THREADS - 1];
+static struct k_delayed_work delayed_work;
+static struct k_sem sync_sema;
+static struct k_sem block_sema;
+
+static int order[NUM_OF_WORK];
+static int done;
+
+static void order_handler(struct k_work *w)
+{
+	order[done++] = w - work;
+}
+
+static void busy_handler(struct k_work *w)
+{
+	k_busy_wait(BUSY_TIME);
+	k_sem_give(&sync_sema);
+}
+
+static void block_handler(struct k_work *w)
+{
+	k_sem_take(&block_sema, K_FOREVER);
+}
+
+static void work_handler(struct k_work *w)
+{
+	k_sem_give(&sync_sema);
+}
+
+/* keeps the only thread of prio_q busy until block_sema is given */
+static void block_prio_q(void)
+{
+	k_work_init(&blocker, block_handler);
+	k_work_submit_to_queue(&prio_q, &blocker);
+	k_sleep(1);
+}
+
+/**
+ * @addtogroup kernel_workqueue_tests
+ * @{
+ */
+
+/**
+ * @brief Test pending work items are processed in priority order
+ * @see k_work_q_pool_start(), k_work_prio_set(), k_work_q_stats_get()
+ */
+void test_work_q_pool_priority(void)
+{
+	static const int prio[NUM_OF_WORK] = { 3, 1, 2, 1, 0, 3 };
+	static const int expected[NUM_OF_WORK] = { 4, 1, 3, 2, 0, 5 };
+	struct k_work_q_stats stats;
+	int i;
+
+	k_sem_init(&block_sema, 0, 1);
+	block_prio_q();
+
+	for (i = 0; i < NUM_OF_WORK; i++) {
+		k_work_init(&work[i], order_handler);
+		k_work_prio_set(&work[i], prio[i]);
+		k_work_submit_to_queue(&prio_q, &work[i]);
+	}
+
+	k_work_q_stats_get(&prio_q, &stats);
+	zassert_equal(stats.backlog, NUM_OF_WORK, NULL);
+	zassert_equal(stats.backlog_max, NUM_OF_WORK, NULL);
+
+	k_sem_give(&block_sema);
+	k_sleep(TIMEOUT);
+
+	/**TESTPOINT: higher priority first, submission order on ties */
+	zassert_equal(done, NUM_OF_WORK, NULL);
+	for (i = 0; i < NUM_OF_WORK; i++) {
+		zassert_equal(order[i], expected[i], NULL);
+	}
+
+	k_work_q_stats_get(&prio_q, &stats);
+	zassert_equal(stats.backlog, 0, NULL);
+	zassert_equal(stats.items, NUM_OF_WORK + 1, NULL);
+}
+
+/**
+ * @brief Test a blocked work handler does not hold back other work items
+ * @see k_work_q_pool_start()
+ */
+void test_work_q_pool_parallel(void)
+{
+	int i;
+
+	k_sem_init(&sync_sema, 0, NUM_OF_WORK);
+	k_sem_init(&block_sema, 0, NUM_THREADS);
+
+	for (i = 0; i < NUM_THREADS - 1; i++) {
+		k_work_init(&slow[i], block_handler);
+		k_work_submit_to_queue(&pool_q, &slow[i]);
+	}
+	k_work_init(&work[0], work_handler);
+	k_work_submit_to_queue(&pool_q, &work[0]);
+
+	/**TESTPOINT: the last free thread processes the work item */
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+
+	for (i = 0; i < NUM_THREADS - 1; i++) {
+		k_sem_give(&block_sema);
+	}
+	k_sleep(TIMEOUT);
+	for (i = 0; i < NUM_THREADS - 1; i++) {
+		zassert_false(k_work_pending(&slow[i]), NULL);
+	}
+}
+
+/**
+ * @brief Test delayed work items on a workqueue pool
+ * @see k_delayed_work_submit_to_queue(), k_delayed_work_cancel()
+ */
+void test_work_q_pool_delayed(void)
+{
+	struct k_work_q_stats stats;
+
+	k_sem_init(&sync_sema, 0, NUM_OF_WORK);
+	k_delayed_work_init(&delayed_work, work_handler);
+
+	/**TESTPOINT: delayed work is processed after its delay */
+	zassert_equal(k_delayed_work_submit_to_queue(&pool_q, &delayed_work,
+						     TIMEOUT), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT >> 1), -EAGAIN, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+
+	/**TESTPOINT: canceling a pending work item dequeues it */
+	k_sem_init(&block_sema, 0, 1);
+	block_prio_q();
+	k_work_q_stats_get(&prio_q, &stats);
+	zassert_equal(k_delayed_work_submit_to_queue(&prio_q, &delayed_work,
+						     0), 0, NULL);
+	zassert_true(k_work_pending(&delayed_work.work), NULL);
+	zassert_equal(k_delayed_work_cancel(&delayed_work), 0, NULL);
+	k_work_q_stats_get(&prio_q, &stats);
+	zassert_equal(stats.backlog, 0, NULL);
+	zassert_equal(stats.backlog_max, 1, NULL);
+
+	k_sem_give(&block_sema);
+	k_sleep(TIMEOUT);
+	zassert_equal(k_sem_take(&sync_sema, K_NO_WAIT), -EBUSY, NULL);
+}
+
+/**
+ * @brief Test the handler time and throughput statistics
+ * @see k_work_q_stats_get()
+ */
+void test_work_q_pool_stats(void)
+{
+	struct k_work_q_stats stats;
+	int i;
+
+	k_sem_init(&sync_sema, 0, NUM_OF_WORK);
+	k_work_q_stats_get(&pool_q, &stats);
+
+	for (i = 0; i < NUM_OF_WORK; i++) {
+		k_work_init(&work[i], busy_handler);
+		k_work_submit_to_queue(&pool_q, &work[i]);
+	}
+	for (i = 0; i < NUM_OF_WORK; i++) {
+		zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	}
+
+	k_work_q_stats_get(&pool_q, &stats);
+	TC_PRINT("backlog max %u, handler max %u us, %u items, %u items/s\n",
+		 stats.backlog_max, stats.handler_max_us, stats.items,
+		 stats.items_per_sec);
+	zassert_equal(stats.items, NUM_OF_WORK, NULL);
+	zassert_true(stats.items_per_sec > 0, NULL);
+	zassert_true(stats.handler_max_us >= BUSY_TIME, NULL);
+	zassert_true(stats.backlog_max >= NUM_OF_WORK - NUM_THREADS, NULL);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	k_work_q_pool_start(&prio_q, prio_threads, &prio_stacks[0][0],
+			    STACK_SIZE, 1, POOL_PRIO);
+	k_work_q_pool_start(&pool_q, pool_threads, &pool_stacks[0][0],
+			    STACK_SIZE, NUM_THREADS, POOL_PRIO);
+
+	ztest_test_suite(workqueue_pool,
+			 ztest_unit_test(test_work_q_pool_priority),
+			 ztest_unit_test(test_work_q_pool_parallel),
+			 ztest_unit_test(test_work_q_pool_delayed),
+			 ztest_unit_test(test_work_q_pool_stats));
+	ztest_run_test_suite(workqueue_pool);
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <misc/fiber.h>
+
+#define FIBER_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_FIBERS 3
+#define NUM_MANY 64
+#define NUM_SWITCHES 1000
+#define TIMEOUT 100
+
+static struct sys_fiber_host host;
+static struct sys_fiber fibers[NUM_FIBERS];
+static SYS_FIBER_STACK_DEFINE(fiber_stacks[NUM_FIBERS], FIBER_STACK_SIZE);
+static struct sys_fiber many_fibers[NUM_MANY];
+static SYS_FIBER_STACK_DEFINE(many_stacks[NUM_MANY], FIBER_STACK_SIZE);
+
+static struct k_thread tdata[2];
+static K_THREAD_STACK_ARRAY_DEFINE(tstacks, 2, STACK_SIZE);
+
+static K_SEM_DEFINE(fiber_sem, 0, NUM_MANY);
+static K_SEM_DEFINE(idle_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 2);
+static K_FIFO_DEFINE(fiber_fifo);
+
+static int order[2 * NUM_FIBERS];
+static int num_order;
+static int sleeps;
+static int woken;
+
+static void create(struct sys_fiber *fiber, void *stack,
+		   sys_fiber_entry_t entry, void *arg)
+{
+	sys_fiber_create(&host, fiber, stack, FIBER_STACK_SIZE, entry, arg);
+}
+
+static void yielder(void *arg)
+{
+	order[num_order++] = POINTER_TO_INT(arg);
+	sys_fiber_yield();
+	order[num_order++] = POINTER_TO_INT(arg);
+}
+
+/**
+ * @brief Test fibers run in turn when yielding
+ * @see sys_fiber_create(), sys_fiber_yield(), sys_fiber_host_run()
+ */
+void test_fiber_yield(void)
+{
+	sys_fiber_host_init(&host);
+	for (int i = 0; i < NUM_FIBERS; i++) {
+		create(&fibers[i], fiber_stacks[i], yielder, INT_TO_POINTER(i));
+	}
+
+	zassert_is_null(sys_fiber_current(), NULL);
+	sys_fiber_host_run(&host);
+
+	zassert_equal(num_order, 2 * NUM_FIBERS, NULL);
+	for (int i = 0; i < 2 * NUM_FIBERS; i++) {
+		zassert_equal(order[i], i % NUM_FIBERS, NULL);
+	}
+}
+
+static void giver(void *p1, void *p2, void *p3)
+{
+	k_sleep(TIMEOUT / 2);
+	k_sem_give(&fiber_sem);
+	k_fifo_put(&fiber_fifo, p1);
+}
+
+static void sem_taker(void *arg)
+{
+	zassert_equal(sys_fiber_sem_take(&idle_sem, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(sys_fiber_sem_take(&idle_sem, TIMEOUT / 10), -EAGAIN,
+		      NULL);
+	zassert_equal(sys_fiber_sem_take(&fiber_sem, K_FOREVER), 0, NULL);
+	zassert_true(sleeps > 0, NULL);
+	woken++;
+}
+
+static void queue_getter(void *arg)
+{
+	zassert_equal(sys_fiber_queue_get(&fiber_fifo._queue, TIMEOUT), arg,
+		      NULL);
+	woken++;
+}
+
+static void sleeper(void *arg)
+{
+	while (woken < 2) {
+		sys_fiber_sleep(TIMEOUT / 10);
+		sleeps++;
+	}
+}
+
+/**
+ * @brief Test fibers waiting for kernel objects do not block the others
+ * @see sys_fiber_sem_take(), sys_fiber_queue_get(), sys_fiber_sleep()
+ */
+void test_fiber_wait(void)
+{
+	static void *item[2];
+
+	sys_fiber_host_init(&host);
+	create(&fibers[0], fiber_stacks[0], sem_taker, NULL);
+	create(&fibers[1], fiber_stacks[1], queue_getter, item);
+	create(&fibers[2], fiber_stacks[2], sleeper, NULL);
+
+	k_thread_create(&tdata[0], tstacks[0], STACK_SIZE, giver, item,
+			NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+
+	sys_fiber_host_run(&host);
+	zassert_equal(woken, 2, NULL);
+	k_thread_abort(&tdata[0]);
+}
+
+static void many_taker(void *arg)
+{
+	sys_fiber_sem_take(&fiber_sem, K_FOREVER);
+	woken++;
+}
+
+static void many_giver(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < NUM_MANY; i++) {
+		k_sem_give(&fiber_sem);
+		k_sleep(1);
+	}
+}
+
+/**
+ * @brief Test many fibers waiting on a host at once
+ * @see sys_fiber_sem_take()
+ */
+void test_fiber_many(void)
+{
+	woken = 0;
+	sys_fiber_host_init(&host);
+	for (int i = 0; i < NUM_MANY; i++) {
+		create(&many_fibers[i], many_stacks[i], many_taker, NULL);
+	}
+
+	k_thread_create(&tdata[0], tstacks[0], STACK_SIZE, many_giver, NULL,
+			NULL, NULL, K_PRIO_PREEMPT(0), 0, 0);
+
+	sys_fiber_host_run(&host);
+	zassert_equal(woken, NUM_MANY, NULL);
+	k_thread_abort(&tdata[0]);
+}
+
+static void fiber_switcher(void *arg)
+{
+	for (int i = 0; i < NUM_SWITCHES; i++) {
+		sys_fiber_yield();
+	}
+}
+
+static void thread_switcher(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < NUM_SWITCHES; i++) {
+		k_yield();
+	}
+	k_sem_give(&done_sem);
+}
+
+/**
+ * @brief Compare the cost of switching fibers and threads
+ * @see sys_fiber_yield(), k_yield()
+ */
+void test_fiber_switch_perf(void)
+{
+	u32_t start, fiber_cycles, thread_cycles;
+
+	sys_fiber_host_init(&host);
+	for (int i = 0; i < 2; i++) {
+		create(&fibers[i], fiber_stacks[i], fiber_switcher, NULL);
+	}
+
+	start = k_cycle_get_32();
+	sys_fiber_host_run(&host);
+	fiber_cycles = k_cycle_get_32() - start;
+
+	/* the switchers only run once this thread waits */
+	for (int i = 0; i < 2; i++) {
+		k_thread_create(&tdata[i], tstacks[i], STACK_SIZE,
+				thread_switcher, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(0), 0, 0);
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < 2; i++) {
+		zassert_equal(k_sem_take(&done_sem, TIMEOUT * 10), 0, NULL);
+	}
+	thread_cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("cycles per yield: sys_fiber_yield() %u, k_yield() %u\n",
+		 fiber_cycles / (2 * NUM_SWITCHES),
+		 thread_cycles / (2 * NUM_SWITCHES));
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_fiber,
+			 ztest_unit_test(test_fiber_yield),
+			 ztest_unit_test(test_fiber_wait),
+			 ztest_unit_test(test_fiber_many),
+			 ztest_unit_test(test_fiber_switch_perf));
+	ztest_run_test_suite(test_fiber);
+}
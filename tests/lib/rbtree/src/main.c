@@ -26,6 +26,12 @@ static struct rbnode *walked_nodes[MAX_NODES];
 /* Node currently being inserted, for testing lessthan() argument order */
 static struct rbnode *current_insertee;
 
+/* Augmented data: number of nodes in the subtree of each node */
+static int subtree_size[MAX_NODES];
+
+/* Operations timed by the microbenchmark */
+#define PERF_OPS 1000
+
 void set_node_mask(int node, int val)
 {
 	unsigned int *p = &node_mask[node / 32];
@@ -48,6 +54,18 @@ int node_index(struct rbnode *n)
 	return (int)(n - &nodes[0]);
 }
 
+static int get_subtree_size(struct rbnode *n)
+{
+	return n ? subtree_size[node_index(n)] : 0;
+}
+
+void node_augment(struct rbnode *node)
+{
+	subtree_size[node_index(node)] = 1 +
+		get_subtree_size(_rb_child(node, 0)) +
+		get_subtree_size(_rb_child(node, 1));
+}
+
 /* Our "lessthan" is just the location of the struct */
 int node_lessthan(struct rbnode *a, struct rbnode *b)
 {
@@ -93,6 +111,11 @@ void check_rbnode(struct rbnode *node, int blacks_above)
 {
 	int side, bheight = blacks_above + _rb_is_black(node);
 
+	/* Augmented data is up to date */
+	CHECK(get_subtree_size(node) == 1 +
+	      get_subtree_size(_rb_child(node, 0)) +
+	      get_subtree_size(_rb_child(node, 1)));
+
 	for (side = 0; side < 2; side++) {
 		struct rbnode *ch = _rb_child(node, side);
 
@@ -174,8 +197,17 @@ void _check_tree(int size, int use_foreach)
 
 	CHECK(ni == nwalked);
 
+	/* The cached extremes are the first and last walked nodes */
+	if (nwalked) {
+		CHECK(rb_get_min(&tree) == walked_nodes[0]);
+		CHECK(rb_get_max(&tree) == walked_nodes[nwalked - 1]);
+	} else {
+		CHECK(!rb_get_min(&tree) && !rb_get_max(&tree));
+	}
+
 	if (tree.root) {
 		check_rb();
+		CHECK(get_subtree_size(tree.root) == nwalked);
 	}
 }
 
@@ -202,8 +234,10 @@ void test_tree(int size)
 
 	memset(&tree, 0, sizeof(tree));
 	tree.lessthan_fn = node_lessthan;
+	tree.augment_fn = node_augment;
 	memset(nodes, 0, sizeof(nodes));
 	memset(node_mask, 0, sizeof(node_mask));
+	memset(subtree_size, 0, sizeof(subtree_size));
 
 	for (j = 0; j < 10; j++) {
 		for (i = 0; i < size; i++) {
@@ -245,9 +279,63 @@ void test_rbtree_spam(void)
 	} while (size < MAX_NODES);
 }
 
+/* Finds the lowest node by walking down the tree */
+static struct rbnode *walk_min(struct rbtree *t)
+{
+	struct rbnode *n;
+
+	for (n = t->root; n && _rb_child(n, 0); n = _rb_child(n, 0)) {
+	}
+
+	return n;
+}
+
+void test_rbtree_perf(void)
+{
+	u32_t start, walk_cycles, cached_cycles, queue_cycles;
+	struct rbnode *n;
+	int i;
+
+	memset(&tree, 0, sizeof(tree));
+	tree.lessthan_fn = node_lessthan;
+	for (i = 0; i < MAX_NODES; i++) {
+		rb_insert(&tree, &nodes[i]);
+	}
+
+	start = k_cycle_get_32();
+	for (i = 0; i < PERF_OPS; i++) {
+		n = walk_min(&tree);
+		compiler_barrier();
+	}
+	walk_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < PERF_OPS; i++) {
+		n = rb_get_min(&tree);
+		compiler_barrier();
+	}
+	cached_cycles = k_cycle_get_32() - start;
+	CHECK(n == walk_min(&tree));
+
+	/* Take the best node and queue it back, as a run queue does */
+	start = k_cycle_get_32();
+	for (i = 0; i < PERF_OPS; i++) {
+		n = rb_get_min(&tree);
+		rb_remove(&tree, n);
+		rb_insert(&tree, n);
+	}
+	queue_cycles = k_cycle_get_32() - start;
+	CHECK(rb_get_min(&tree) == &nodes[0]);
+
+	TC_PRINT("%d nodes, cycles per op: walked min %u, cached min %u, "
+		 "remove/insert min %u\n", MAX_NODES, walk_cycles / PERF_OPS,
+		 cached_cycles / PERF_OPS, queue_cycles / PERF_OPS);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_rbtree,
-			 ztest_unit_test(test_rbtree_spam));
+			 ztest_unit_test(test_rbtree_spam),
+			 ztest_unit_test(test_rbtree_perf));
 	ztest_run_test_suite(test_rbtree);
 }
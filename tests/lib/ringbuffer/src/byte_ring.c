@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+#include <ring_buffer.h>
+
+#define BYTE_RING_POW 4
+#define BYTE_RING_SIZE (1 << BYTE_RING_POW)
+
+/* bytes moved by each throughput measurement, and per call */
+#define TPUT_BYTES 65536
+#define TPUT_CHUNK 32
+#define TPUT_POW 10
+
+SYS_BYTE_RING_DECLARE_POW2(byte_ring, BYTE_RING_POW);
+
+static struct byte_ring tput_ring;
+static u8_t tput_data[1 << TPUT_POW];
+SYS_RING_BUF_DECLARE_POW2(tput_item_ring, TPUT_POW - 2);
+
+static u8_t tx[2 * BYTE_RING_SIZE];
+static u8_t rx[2 * BYTE_RING_SIZE];
+static u8_t chunk[TPUT_CHUNK];
+
+static u8_t seq_tx, seq_rx;
+
+static void fill(u8_t *data, u32_t first, u32_t size)
+{
+	for (u32_t i = 0; i < size; i++) {
+		data[i] = first + i;
+	}
+}
+
+static void check(u8_t *data, u32_t first, u32_t size)
+{
+	for (u32_t i = 0; i < size; i++) {
+		zassert_equal(data[i], (u8_t)(first + i), NULL);
+	}
+}
+
+/**
+ * @brief Test copying bytes in and out of a byte ring buffer
+ * @see sys_byte_ring_put(), sys_byte_ring_get()
+ */
+void test_byte_ring_put_get(void)
+{
+	fill(tx, 0, sizeof(tx));
+
+	zassert_true(sys_byte_ring_is_empty(&byte_ring), NULL);
+	zassert_equal(sys_byte_ring_space_get(&byte_ring), BYTE_RING_SIZE,
+		      NULL);
+
+	zassert_equal(sys_byte_ring_put(&byte_ring, tx, 10), 10, NULL);
+	zassert_equal(sys_byte_ring_get(&byte_ring, rx, 6), 6, NULL);
+	check(rx, 0, 6);
+
+	/**TESTPOINT: put wraps around and fills up the whole buffer */
+	zassert_equal(sys_byte_ring_put(&byte_ring, &tx[10], sizeof(tx)),
+		      BYTE_RING_SIZE - 4, NULL);
+	zassert_equal(sys_byte_ring_space_get(&byte_ring), 0, NULL);
+	zassert_equal(sys_byte_ring_put(&byte_ring, tx, 1), 0, NULL);
+
+	/**TESTPOINT: get wraps around and empties the buffer */
+	zassert_equal(sys_byte_ring_get(&byte_ring, rx, sizeof(rx)),
+		      BYTE_RING_SIZE, NULL);
+	check(rx, 6, BYTE_RING_SIZE);
+	zassert_true(sys_byte_ring_is_empty(&byte_ring), NULL);
+	zassert_equal(sys_byte_ring_get(&byte_ring, rx, 1), 0, NULL);
+}
+
+/**
+ * @brief Test filling and draining a byte ring buffer in place
+ * @see sys_byte_ring_put_claim(), sys_byte_ring_put_commit(),
+ * sys_byte_ring_get_claim(), sys_byte_ring_get_commit()
+ */
+void test_byte_ring_claim_commit(void)
+{
+	u8_t *data;
+	u32_t size, offset;
+
+	sys_byte_ring_init(&byte_ring, BYTE_RING_SIZE, byte_ring.buf);
+
+	/* leave the positions 4 bytes before the end of the buffer */
+	zassert_equal(sys_byte_ring_put(&byte_ring, tx, BYTE_RING_SIZE - 4),
+		      BYTE_RING_SIZE - 4, NULL);
+	zassert_equal(sys_byte_ring_get(&byte_ring, rx, BYTE_RING_SIZE - 4),
+		      BYTE_RING_SIZE - 4, NULL);
+
+	/**TESTPOINT: claims stop at the end of the buffer */
+	size = sys_byte_ring_put_claim(&byte_ring, &data, BYTE_RING_SIZE);
+	zassert_equal(size, 4, NULL);
+	zassert_equal(data, &byte_ring.buf[BYTE_RING_SIZE - 4], NULL);
+	fill(data, 0, size);
+	zassert_equal(sys_byte_ring_get_claim(&byte_ring, &data, 1), 0, NULL);
+	zassert_equal(sys_byte_ring_put_commit(&byte_ring, size), 0, NULL);
+
+	size = sys_byte_ring_put_claim(&byte_ring, &data, BYTE_RING_SIZE);
+	zassert_equal(size, BYTE_RING_SIZE - 4, NULL);
+	zassert_equal(data, byte_ring.buf, NULL);
+	fill(data, 4, 8);
+	zassert_equal(sys_byte_ring_put_commit(&byte_ring, size + 1), -EINVAL,
+		      NULL);
+	zassert_equal(sys_byte_ring_put_commit(&byte_ring, 8), 0, NULL);
+
+	/**TESTPOINT: the consumer reads the same bytes in place */
+	for (offset = 0; offset < 12; offset += size) {
+		size = sys_byte_ring_get_claim(&byte_ring, &data,
+					       BYTE_RING_SIZE);
+		zassert_equal(size, offset ? 8 : 4, NULL);
+		check(data, offset, size);
+		zassert_equal(sys_byte_ring_get_commit(&byte_ring, size), 0,
+			      NULL);
+	}
+	zassert_true(sys_byte_ring_is_empty(&byte_ring), NULL);
+	zassert_equal(sys_byte_ring_get_commit(&byte_ring, 1), -EINVAL, NULL);
+}
+
+static void byte_ring_isr_put(void *p)
+{
+	u8_t *data;
+	u32_t size = sys_byte_ring_put_claim(&byte_ring, &data, (u32_t)p);
+
+	for (u32_t i = 0; i < size; i++) {
+		data[i] = seq_tx++;
+	}
+	sys_byte_ring_put_commit(&byte_ring, size);
+}
+
+/**
+ * @brief Test an ISR producer with a thread consumer
+ * @see sys_byte_ring_put_claim(), sys_byte_ring_get()
+ */
+void test_byte_ring_isr_producer(void)
+{
+	u32_t size, total = 0;
+
+	seq_tx = seq_rx = 0;
+	sys_byte_ring_init(&byte_ring, BYTE_RING_SIZE, byte_ring.buf);
+
+	while (total < 4 * BYTE_RING_SIZE) {
+		irq_offload(byte_ring_isr_put, (void *)5);
+		irq_offload(byte_ring_isr_put, (void *)3);
+
+		size = sys_byte_ring_get(&byte_ring, rx, 7);
+		check(rx, seq_rx, size);
+		seq_rx += size;
+		total += size;
+	}
+
+	size = sys_byte_ring_get(&byte_ring, rx, sizeof(rx));
+	check(rx, seq_rx, size);
+	seq_rx += size;
+	zassert_equal(seq_rx, seq_tx, NULL);
+}
+
+static u32_t bytes_per_sec(u32_t cycles)
+{
+	if (cycles == 0) {
+		return 0;
+	}
+
+	return (u64_t)TPUT_BYTES * sys_clock_hw_cycles_per_sec / cycles;
+}
+
+/**
+ * @brief Compare the throughput of the byte and item ring buffers
+ * @see sys_byte_ring_put(), sys_byte_ring_get(), sys_ring_buf_put(),
+ * sys_ring_buf_get()
+ */
+void test_byte_ring_throughput(void)
+{
+	u32_t start, item_cycles, byte_cycles, claim_cycles;
+	u32_t i, size;
+	u16_t type;
+	u8_t value, size32;
+	u8_t *data;
+
+	sys_byte_ring_init(&tput_ring, sizeof(tput_data), tput_data);
+	fill(chunk, 0, sizeof(chunk));
+
+	start = k_cycle_get_32();
+	for (i = 0; i < TPUT_BYTES; i += TPUT_CHUNK) {
+		zassert_equal(sys_ring_buf_put(&tput_item_ring, 0, 0,
+					       (u32_t *)chunk,
+					       TPUT_CHUNK / 4), 0, NULL);
+		size32 = TPUT_CHUNK / 4;
+		zassert_equal(sys_ring_buf_get(&tput_item_ring, &type, &value,
+					       (u32_t *)chunk, &size32), 0,
+			      NULL);
+	}
+	item_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < TPUT_BYTES; i += TPUT_CHUNK) {
+		zassert_equal(sys_byte_ring_put(&tput_ring, chunk, TPUT_CHUNK),
+			      TPUT_CHUNK, NULL);
+		zassert_equal(sys_byte_ring_get(&tput_ring, chunk, TPUT_CHUNK),
+			      TPUT_CHUNK, NULL);
+	}
+	byte_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < TPUT_BYTES; i += size) {
+		size = sys_byte_ring_put_claim(&tput_ring, &data, TPUT_CHUNK);
+		sys_byte_ring_put_commit(&tput_ring, size);
+		size = sys_byte_ring_get_claim(&tput_ring, &data, TPUT_CHUNK);
+		sys_byte_ring_get_commit(&tput_ring, size);
+	}
+	claim_cycles = k_cycle_get_32() - start;
+
+	check(chunk, 0, sizeof(chunk));
+
+	TC_PRINT("%d byte chunks, bytes/s: item ring %u, byte ring %u, "
+		 "claim/commit %u\n", TPUT_CHUNK, bytes_per_sec(item_cycles),
+		 bytes_per_sec(byte_cycles), bytes_per_sec(claim_cycles));
+}
@@ -227,6 +227,11 @@ void test_ringbuffer_size_put_get_thread_isr(void)
 	irq_offload(tringbuf_get, (void *)2);
 }
 
+extern void test_byte_ring_put_get(void);
+extern void test_byte_ring_claim_commit(void);
+extern void test_byte_ring_isr_producer(void);
+extern void test_byte_ring_throughput(void);
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -239,6 +244,10 @@ void test_main(void)
 			 ztest_unit_test(test_ringbuffer_put_get_thread_isr),
 			 ztest_unit_test(test_ringbuffer_pow2_put_get_thread_isr),
 			 ztest_unit_test(test_ringbuffer_size_put_get_thread_isr),
-			 ztest_unit_test(test_ring_buffer_main));
+			 ztest_unit_test(test_ring_buffer_main),
+			 ztest_unit_test(test_byte_ring_put_get),
+			 ztest_unit_test(test_byte_ring_claim_commit),
+			 ztest_unit_test(test_byte_ring_isr_producer),
+			 ztest_unit_test(test_byte_ring_throughput));
 	ztest_run_test_suite(test_ringbuffer_api);
 }
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <net/buf.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/udp.h>
+
+#include <ztest.h>
+
+#include "net_private.h"
+#include "connection.h"
+
+#define LOCAL_PORT 4242
+#define REMOTE_PORT 1000
+#define NUM_ROUNDS 1000
+
+#define NET_UDP_HDR(pkt)  ((struct net_udp_hdr *)(net_pkt_udp_data(pkt)))
+
+/* the listener takes one of the connections */
+#define NUM_CONNECTED (CONFIG_NET_MAX_CONN - 1)
+
+static int net_conn_demux_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void net_conn_demux_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static int tester_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct net_if_api net_conn_demux_if_api = {
+	.init = net_conn_demux_iface_init,
+	.send = tester_send,
+};
+
+NET_DEVICE_INIT(net_conn_demux_test, "net_conn_demux_test",
+		net_conn_demux_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&net_conn_demux_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static struct in_addr remote_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr local_addr = { { { 192, 0, 2, 2 } } };
+static struct net_conn_handle *handles[CONFIG_NET_MAX_CONN];
+static int num_handles;
+static int matched;
+
+static enum net_verdict recv_cb(struct net_conn *conn, struct net_pkt *pkt,
+				void *user_data)
+{
+	/* the packet is reused, not consumed */
+	matched = POINTER_TO_INT(user_data);
+
+	return NET_OK;
+}
+
+static struct net_pkt *create_pkt(u16_t remote_port)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+
+	pkt = net_pkt_get_reserve_rx(0, K_SECONDS(1));
+	zassert_not_null(pkt, "Out of mem");
+
+	frag = net_pkt_get_frag(pkt, K_SECONDS(1));
+	zassert_not_null(frag, "Out of mem");
+
+	net_pkt_frag_add(pkt, frag);
+	net_pkt_set_iface(pkt, net_if_get_default());
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv4_hdr));
+
+	net_buf_add(frag, sizeof(struct net_ipv4_hdr) +
+		    sizeof(struct net_udp_hdr));
+
+	NET_IPV4_HDR(pkt)->vhl = 0x45;
+	NET_IPV4_HDR(pkt)->len = htons(sizeof(struct net_ipv4_hdr) +
+				       sizeof(struct net_udp_hdr));
+	NET_IPV4_HDR(pkt)->proto = IPPROTO_UDP;
+	net_ipaddr_copy(&NET_IPV4_HDR(pkt)->src, &remote_addr);
+	net_ipaddr_copy(&NET_IPV4_HDR(pkt)->dst, &local_addr);
+
+	NET_UDP_HDR(pkt)->src_port = htons(remote_port);
+	NET_UDP_HDR(pkt)->dst_port = htons(LOCAL_PORT);
+
+	return pkt;
+}
+
+static void register_conn(u16_t remote_port, int id)
+{
+	struct sockaddr_in raddr = {
+		.sin_family = AF_INET,
+		.sin_addr = remote_addr,
+	};
+	int ret;
+
+	ret = net_conn_register(IPPROTO_UDP,
+				remote_port ? (struct sockaddr *)&raddr : NULL,
+				NULL, remote_port, LOCAL_PORT, recv_cb,
+				INT_TO_POINTER(id), &handles[num_handles]);
+	zassert_equal(ret, 0, "Cannot register connection");
+	num_handles++;
+}
+
+static void unregister_all(void)
+{
+	while (num_handles) {
+		net_conn_unregister(handles[--num_handles]);
+	}
+}
+
+static void check_input(u16_t remote_port, int id)
+{
+	struct net_pkt *pkt = create_pkt(remote_port);
+
+	matched = -1;
+	zassert_equal(net_conn_input(IPPROTO_UDP, pkt), NET_OK,
+		      "Packet not received");
+	zassert_equal(matched, id, "Packet received by the wrong connection");
+
+	net_pkt_unref(pkt);
+}
+
+/**
+ * @brief Test packets reach the best matching connection
+ * @see net_conn_register(), net_conn_input()
+ */
+void test_conn_demux_match(void)
+{
+	int i;
+
+	register_conn(0, 0);
+	for (i = 1; i <= NUM_CONNECTED; i++) {
+		register_conn(REMOTE_PORT + i, i);
+	}
+
+	check_input(REMOTE_PORT + 1, 1);
+	check_input(REMOTE_PORT + NUM_CONNECTED, NUM_CONNECTED);
+
+	/* no connected match, goes to the listener */
+	check_input(REMOTE_PORT, 0);
+
+	net_conn_unregister(handles[NUM_CONNECTED]);
+	num_handles--;
+	check_input(REMOTE_PORT + NUM_CONNECTED, 0);
+
+	unregister_all();
+}
+
+/**
+ * @brief Measure the cost of finding the connection of a packet
+ *
+ * The packet matches the connection registered last, with more and more
+ * connections registered.
+ *
+ * @see net_conn_input()
+ */
+void test_conn_demux_perf(void)
+{
+	static const int counts[] = { 1, 8, 32, NUM_CONNECTED };
+	struct net_pkt *pkt;
+	u32_t start, cycles;
+	int i, num = 0;
+
+	register_conn(0, 0);
+
+	for (int c = 0; c < ARRAY_SIZE(counts); c++) {
+		while (num < counts[c]) {
+			num++;
+			register_conn(REMOTE_PORT + num, num);
+		}
+
+		pkt = create_pkt(REMOTE_PORT + num);
+
+		start = k_cycle_get_32();
+		for (i = 0; i < NUM_ROUNDS; i++) {
+			net_conn_input(IPPROTO_UDP, pkt);
+		}
+		cycles = k_cycle_get_32() - start;
+
+		zassert_equal(matched, num, NULL);
+		net_pkt_unref(pkt);
+
+		TC_PRINT("%4d connections: %u cycles per packet\n",
+			 num + 1, cycles / NUM_ROUNDS);
+	}
+
+	unregister_all();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_conn_demux,
+			 ztest_unit_test(test_conn_demux_match),
+			 ztest_unit_test(test_conn_demux_perf));
+	ztest_run_test_suite(test_conn_demux);
+}
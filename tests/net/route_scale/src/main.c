@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <tc_util.h>
+
+#include <net/ethernet.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+
+#include "net_private.h"
+#include "ipv6.h"
+#include "nbr.h"
+#include "route.h"
+
+#define NUM_ROUTES CONFIG_NET_MAX_ROUTES
+#define NUM_NEXTHOPS 4
+#define NUM_IFACES 2
+#define NUM_ROUNDS 4
+
+static int net_route_scale_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void net_route_scale_iface_init(struct net_if *iface)
+{
+	static u8_t mac[NUM_IFACES][6];
+	u8_t *addr = mac[net_if_get_by_iface(iface) % NUM_IFACES];
+
+	addr[2] = 0x5E;
+	addr[4] = 0x53;
+	addr[5] = net_if_get_by_iface(iface);
+
+	net_if_set_link_addr(iface, addr, 6, NET_LINK_ETHERNET);
+}
+
+static int tester_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct net_if_api net_route_scale_if_api = {
+	.init = net_route_scale_iface_init,
+	.send = tester_send,
+};
+
+NET_DEVICE_INIT_INSTANCE(net_route_scale_0, "net_route_scale_0", iface0,
+			 net_route_scale_dev_init, NULL, NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_route_scale_if_api, DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+NET_DEVICE_INIT_INSTANCE(net_route_scale_1, "net_route_scale_1", iface1,
+			 net_route_scale_dev_init, NULL, NULL,
+			 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+			 &net_route_scale_if_api, DUMMY_L2,
+			 NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static struct net_if *ifaces[NUM_IFACES];
+static struct in6_addr nexthops[NUM_IFACES][NUM_NEXTHOPS];
+static struct net_route_entry *routes[NUM_ROUTES];
+static struct in6_addr dests[NUM_ROUTES];
+
+static const u8_t prefix_lens[] = { 48, 56, 64, 96, 128 };
+
+/* 2001:db8:<i>::/48 is only covered by route i */
+static void route_addr(struct in6_addr *addr, int i)
+{
+	int j;
+
+	addr->s6_addr16[0] = htons(0x2001);
+	addr->s6_addr16[1] = htons(0x0db8);
+	addr->s6_addr16[2] = htons(i);
+
+	for (j = 6; j < sizeof(struct in6_addr); j++) {
+		addr->s6_addr[j] = sys_rand32_get();
+	}
+}
+
+static void add_nexthops(void)
+{
+	static u8_t lladdrs[NUM_IFACES][NUM_NEXTHOPS][6];
+	struct net_linkaddr lladdr = { .len = 6, .type = NET_LINK_ETHERNET };
+	int i, j;
+
+	for (i = 0; i < NUM_IFACES; i++) {
+		ifaces[i] = net_if_get_default() + i;
+
+		for (j = 0; j < NUM_NEXTHOPS; j++) {
+			net_ipv6_addr_create(&nexthops[i][j], 0xfe80, 0, 0, 0,
+					     0, 0, i, j + 1);
+
+			lladdrs[i][j][4] = i;
+			lladdrs[i][j][5] = j + 1;
+			lladdr.addr = lladdrs[i][j];
+
+			zassert_not_null(net_ipv6_nbr_add(ifaces[i],
+						&nexthops[i][j], &lladdr,
+						false,
+						NET_IPV6_NBR_STATE_REACHABLE),
+					 "Cannot add neighbor");
+		}
+	}
+}
+
+/**
+ * @brief Test routes are found with many routes in the table
+ * @see net_route_add(), net_route_lookup()
+ */
+void test_route_scale_add(void)
+{
+	struct in6_addr prefix;
+	int i;
+
+	add_nexthops();
+
+	for (i = 0; i < NUM_ROUTES; i++) {
+		int iface = i % NUM_IFACES;
+		u8_t len = prefix_lens[i % ARRAY_SIZE(prefix_lens)];
+
+		route_addr(&prefix, i);
+		routes[i] = net_route_add(ifaces[iface], &prefix, len,
+				&nexthops[iface][i / NUM_IFACES % NUM_NEXTHOPS]);
+		zassert_not_null(routes[i], "Route add failed");
+
+		/* another address of the prefix */
+		dests[i] = prefix;
+		if (len < 128) {
+			dests[i].s6_addr[15] ^= 1;
+		}
+	}
+
+	for (i = 0; i < NUM_ROUTES; i++) {
+		zassert_equal_ptr(net_route_lookup(NULL, &dests[i]), routes[i],
+				  "Wrong route");
+		zassert_equal_ptr(net_route_lookup(ifaces[i % NUM_IFACES],
+						   &dests[i]),
+				  routes[i], "Wrong route on interface");
+		zassert_is_null(net_route_lookup(
+					ifaces[(i + 1) % NUM_IFACES],
+					&dests[i]),
+				"Route found on other interface");
+	}
+
+	route_addr(&prefix, NUM_ROUTES);
+	zassert_is_null(net_route_lookup(NULL, &prefix), "Unknown route found");
+}
+
+/**
+ * @brief Measure the cost of looking up a route with many routes
+ * @see net_route_lookup()
+ */
+void test_route_scale_lookup_perf(void)
+{
+	u32_t start, cycles;
+	int i, j;
+
+	start = k_cycle_get_32();
+	for (j = 0; j < NUM_ROUNDS; j++) {
+		for (i = 0; i < NUM_ROUTES; i++) {
+			net_route_lookup(NULL, &dests[i]);
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%d routes: %u cycles per lookup\n", NUM_ROUTES,
+		 cycles / (NUM_ROUNDS * NUM_ROUTES));
+}
+
+/**
+ * @brief Test routes are not found once deleted
+ * @see net_route_del(), net_route_lookup()
+ */
+void test_route_scale_del(void)
+{
+	int i;
+
+	for (i = 0; i < NUM_ROUTES; i += 2) {
+		zassert_equal(net_route_del(routes[i]), 0, "Route del failed");
+	}
+
+	for (i = 0; i < NUM_ROUTES; i++) {
+		zassert_equal_ptr(net_route_lookup(NULL, &dests[i]),
+				  i % 2 ? routes[i] : NULL, "Wrong route");
+	}
+
+	for (i = 1; i < NUM_ROUTES; i += 2) {
+		zassert_equal(net_route_del(routes[i]), 0, "Route del failed");
+	}
+}
+
+static void check_nested(struct net_route_entry **nested, int deepest)
+{
+	/* an address of each prefix only, from the longest to the shortest */
+	static const u16_t addrs[][4] = {
+		{ 0xffff, 1, 0, 1 },
+		{ 0xffff, 1, 0, 2 },
+		{ 0xffff, 2, 0, 1 },
+		{ 1, 0, 0, 1 },
+	};
+	struct in6_addr dst;
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(addrs); i++) {
+		net_ipv6_addr_create(&dst, 0x2001, 0x0db8, addrs[i][0],
+				     addrs[i][1], 0, 0, addrs[i][2],
+				     addrs[i][3]);
+
+		/* the longest prefix left that covers the address */
+		j = max(i, deepest);
+		zassert_equal_ptr(net_route_lookup(NULL, &dst),
+				  j < ARRAY_SIZE(addrs) ? nested[j] : NULL,
+				  "Wrong nested route");
+	}
+
+	net_ipv6_addr_create(&dst, 0x2001, 0x0db9, 0, 0, 0, 0, 0, 1);
+	zassert_is_null(net_route_lookup(NULL, &dst), "Unknown route found");
+}
+
+/**
+ * @brief Test the longest prefix wins among nested routes
+ *
+ * A /128, /64, /48 and /32 each cover the next one, and are added out of
+ * order so that routes get inserted both under and above the others.
+ * Deleting them from the longest one, lookups fall back to the next
+ * longest prefix.
+ *
+ * @see net_route_add(), net_route_lookup(), net_route_del()
+ */
+void test_route_scale_nested(void)
+{
+	static const u8_t lens[] = { 128, 64, 48, 32 };
+	static const u8_t add_order[] = { 0, 3, 1, 2 };
+	struct net_route_entry *nested[ARRAY_SIZE(lens)];
+	struct in6_addr prefix;
+	int i;
+
+	net_ipv6_addr_create(&prefix, 0x2001, 0x0db8, 0xffff, 1, 0, 0, 0, 1);
+
+	for (i = 0; i < ARRAY_SIZE(add_order); i++) {
+		int j = add_order[i];
+
+		nested[j] = net_route_add(ifaces[0], &prefix, lens[j],
+					  &nexthops[0][j]);
+		zassert_not_null(nested[j], "Route add failed");
+	}
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		zassert_equal(nested[i]->prefix_len, lens[i], "Route replaced");
+	}
+
+	check_nested(nested, 0);
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		zassert_equal(net_route_del(nested[i]), 0, "Route del failed");
+		check_nested(nested, i + 1);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_route_scale,
+			 ztest_unit_test(test_route_scale_add),
+			 ztest_unit_test(test_route_scale_lookup_perf),
+			 ztest_unit_test(test_route_scale_del),
+			 ztest_unit_test(test_route_scale_nested));
+	ztest_run_test_suite(test_route_scale);
+}
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <net/buf.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/net_context.h>
+#include <net/tcp.h>
+
+#include <ztest.h>
+#include <tc_util.h>
+
+#include "net_private.h"
+#include "tcp_internal.h"
+
+#define MTU 576
+#define PORT 4242
+#define CHUNK 256
+#define WINDOW 4096
+#define TRANSFER (16 * 1024)
+/* chunks sent but not received yet, per direction, so that the packets
+ * queued by the senders leave some for the ACKs
+ */
+#define MAX_QUEUED (WINDOW / CHUNK)
+#define TIMEOUT K_SECONDS(120)
+
+/* The interface sends the packets of one end of the connection to the
+ * other one, with the addresses swapped: both ends are local, but each
+ * one sees the other one at peer_addr. Every loss_every'th data segment
+ * is dropped.
+ */
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static int loss_every;
+static int data_segs;
+static int dropped;
+
+static struct net_context *listener, *client, *server;
+static K_SEM_DEFINE(accepted, 0, 1);
+
+/* data flowing in one direction of the connection */
+struct stream {
+	struct net_context **sender;
+	size_t sent;
+	size_t received;
+	size_t expected;
+	bool corrupted;
+	struct k_sem received_all;
+};
+
+static struct stream upstream = { .sender = &client };
+static struct stream downstream = { .sender = &server };
+
+static int net_tcp_loss_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void net_tcp_loss_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_ETHERNET);
+}
+
+static bool has_data(struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+
+	return tcp_hdr && net_pkt_get_len(pkt) >
+		net_pkt_ip_hdr_len(pkt) + NET_TCP_HDR_LEN(tcp_hdr);
+}
+
+static int tester_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_pkt *rx;
+	struct in_addr addr;
+
+	if (has_data(pkt)) {
+		data_segs++;
+
+		if (loss_every && data_segs % loss_every == 0) {
+			dropped++;
+			net_pkt_unref(pkt);
+			return 0;
+		}
+	}
+
+	/* The sender keeps the packet for retransmissions */
+	rx = net_pkt_clone(pkt, K_NO_WAIT);
+	net_pkt_unref(pkt);
+	if (!rx) {
+		return 0;
+	}
+
+	net_pkt_set_context(rx, NULL);
+
+	net_ipaddr_copy(&addr, &NET_IPV4_HDR(rx)->src);
+	net_ipaddr_copy(&NET_IPV4_HDR(rx)->src, &NET_IPV4_HDR(rx)->dst);
+	net_ipaddr_copy(&NET_IPV4_HDR(rx)->dst, &addr);
+
+	if (net_recv_data(iface, rx) < 0) {
+		net_pkt_unref(rx);
+	}
+
+	return 0;
+}
+
+static struct net_if_api net_tcp_loss_if_api = {
+	.init = net_tcp_loss_iface_init,
+	.send = tester_send,
+};
+
+NET_DEVICE_INIT(net_tcp_loss_test, "net_tcp_loss_test",
+		net_tcp_loss_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&net_tcp_loss_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), MTU);
+
+static void recv_cb(struct net_context *context, struct net_pkt *pkt,
+		    int status, void *user_data)
+{
+	static u8_t buf[MTU];
+	struct stream *stream = user_data;
+	struct net_buf *frag;
+	u16_t len, pos;
+	int i;
+
+	if (!pkt) {
+		return;
+	}
+
+	len = min(net_pkt_appdatalen(pkt), sizeof(buf));
+	frag = net_frag_read(pkt->frags, net_pkt_get_len(pkt) - len, &pos,
+			     len, buf);
+	if (!frag && pos) {
+		stream->corrupted = true;
+	}
+
+	for (i = 0; i < len; i++) {
+		if (buf[i] != (u8_t)(stream->received + i)) {
+			stream->corrupted = true;
+		}
+	}
+
+	stream->received += len;
+	net_pkt_unref(pkt);
+
+	if (stream->received == stream->expected) {
+		k_sem_give(&stream->received_all);
+	}
+}
+
+/* let the window hold more segments than the duplicate ACK threshold */
+static void open_recv_wnd(struct net_context *context)
+{
+	net_context_update_recv_wnd(context,
+				    WINDOW - net_tcp_get_recv_wnd(context->tcp));
+}
+
+static void accept_cb(struct net_context *new_context, struct sockaddr *addr,
+		      socklen_t addrlen, int status, void *user_data)
+{
+	if (status) {
+		return;
+	}
+
+	server = new_context;
+	net_context_recv(server, recv_cb, K_NO_WAIT, &upstream);
+	open_recv_wnd(server);
+
+	k_sem_give(&accepted);
+}
+
+/**
+ * @brief Set up a connection between two local contexts
+ * @see net_context_connect(), net_context_accept()
+ */
+void test_tcp_loss_connect(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct sockaddr_in any = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+	};
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+		.sin_addr = peer_addr,
+	};
+
+	k_sem_init(&upstream.received_all, 0, 1);
+	k_sem_init(&downstream.received_all, 0, 1);
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &my_addr, NET_ADDR_MANUAL,
+					      0), "Cannot add address");
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	zassert_equal(net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP,
+				      &listener), 0, "Cannot get context");
+	zassert_equal(net_context_bind(listener, (struct sockaddr *)&any,
+				       sizeof(any)), 0, "Cannot bind");
+	zassert_equal(net_context_listen(listener, 0), 0, "Cannot listen");
+	zassert_equal(net_context_accept(listener, accept_cb, K_NO_WAIT, NULL),
+		      0, "Cannot accept");
+
+	zassert_equal(net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP,
+				      &client), 0, "Cannot get context");
+	zassert_equal(net_context_connect(client, (struct sockaddr *)&peer,
+					  sizeof(peer), NULL, K_SECONDS(1),
+					  NULL), 0, "Cannot connect");
+	zassert_equal(k_sem_take(&accepted, K_SECONDS(1)), 0,
+		      "Connection not accepted");
+
+	net_context_recv(client, recv_cb, K_NO_WAIT, &downstream);
+	open_recv_wnd(client);
+}
+
+static void send_chunk(struct stream *stream)
+{
+	static u8_t buf[CHUNK];
+	struct net_pkt *pkt;
+	int i;
+
+	while (stream->sent - stream->received >= MAX_QUEUED * CHUNK) {
+		k_sleep(K_MSEC(1));
+	}
+
+	for (i = 0; i < CHUNK; i++) {
+		buf[i] = stream->sent + i;
+	}
+
+	pkt = net_pkt_get_tx(*stream->sender, K_FOREVER);
+	zassert_not_null(pkt, "Out of mem");
+	zassert_true(net_pkt_append_all(pkt, CHUNK, buf, K_FOREVER),
+		     "Out of mem");
+	zassert_equal(net_context_send(pkt, NULL, K_NO_WAIT, NULL, NULL), 0,
+		      "Cannot send");
+	stream->sent += CHUNK;
+}
+
+static void wait_received(struct stream *stream)
+{
+	zassert_equal(k_sem_take(&stream->received_all, TIMEOUT), 0,
+		      "Transfer did not complete");
+	zassert_false(stream->corrupted, "Data received out of order");
+}
+
+/* Transfers from the client, and at the same time from the server too if
+ * both_ways is set, and reports the goodput in each direction.
+ */
+static void measure_goodput(int every, bool both_ways)
+{
+	u32_t start, ms;
+	size_t len;
+
+	loss_every = every;
+	data_segs = 0;
+	dropped = 0;
+	upstream.expected = upstream.received + TRANSFER;
+	downstream.expected = downstream.received + TRANSFER;
+
+	start = k_uptime_get_32();
+	for (len = 0; len < TRANSFER; len += CHUNK) {
+		send_chunk(&upstream);
+		if (both_ways) {
+			send_chunk(&downstream);
+		}
+	}
+
+	wait_received(&upstream);
+	if (both_ways) {
+		wait_received(&downstream);
+	}
+	ms = max(k_uptime_get_32() - start, 1);
+
+	TC_PRINT("loss 1/%-3d%s: %6u bytes/s, %3d data segments, "
+		 "%2d dropped\n", every, both_ways ? ", both ways" : "",
+		 (u32_t)((u64_t)TRANSFER * MSEC_PER_SEC / ms),
+		 data_segs, dropped);
+}
+
+static const int loss[] = { 0, 64, 16 };
+
+/**
+ * @brief Measure the goodput of a transfer with packet losses
+ * @see net_context_send()
+ */
+void test_tcp_loss_goodput(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(loss); i++) {
+		measure_goodput(loss[i], false);
+	}
+
+	loss_every = 0;
+}
+
+/**
+ * @brief Measure the goodput of transfers in both directions at once,
+ * where the ACKs of each end are sent along its data
+ * @see net_context_send()
+ */
+void test_tcp_loss_goodput_both_ways(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(loss); i++) {
+		measure_goodput(loss[i], true);
+	}
+
+	loss_every = 0;
+}
+
+/**
+ * @brief Close the connection
+ * @see net_context_put()
+ */
+void test_tcp_loss_close(void)
+{
+	net_context_put(client);
+	net_context_put(server);
+	net_context_put(listener);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_tcp_loss,
+			 ztest_unit_test(test_tcp_loss_connect),
+			 ztest_unit_test(test_tcp_loss_goodput),
+			 ztest_unit_test(test_tcp_loss_goodput_both_ways),
+			 ztest_unit_test(test_tcp_loss_close));
+	ztest_run_test_suite(test_tcp_loss);
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2018 hackin zhao
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <net/buf.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/net_context.h>
+
+#include <ztest.h>
+#include <tc_util.h>
+
+#include "net_private.h"
+
+#define MTU 1500
+#define PORT 4242
+#define DATAGRAM 1400
+#define NUM_DATAGRAMS 100
+#define HDR_LEN (sizeof(struct net_ipv4_hdr) + sizeof(struct net_udp_hdr))
+
+/* Datagrams are sent on two interfaces: one gathers the fragments, the
+ * other one copies them into a frame buffer, as drivers without
+ * scatter-gather support do.
+ */
+static struct in_addr sg_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr sg_peer = { { { 192, 0, 2, 2 } } };
+static struct in_addr flat_addr = { { { 198, 51, 100, 1 } } };
+static struct in_addr flat_peer = { { { 198, 51, 100, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static struct net_if *sg_iface, *flat_iface;
+
+static u8_t frame[MTU];
+static bool check_frame;
+static bool frame_ok;
+static int frame_iovcnt;
+static K_SEM_DEFINE(sent, 0, UINT_MAX);
+
+static int net_tx_sg_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void set_link_addr(struct net_if *iface, u8_t id)
+{
+	static u8_t mac[2][6] = {
+		{ 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 },
+		{ 0x00, 0x00, 0x5E, 0x00, 0x53, 0x02 },
+	};
+
+	net_if_set_link_addr(iface, mac[id], sizeof(mac[id]),
+			     NET_LINK_ETHERNET);
+}
+
+static void sg_iface_init(struct net_if *iface)
+{
+	sg_iface = iface;
+	set_link_addr(iface, 0);
+}
+
+static void flat_iface_init(struct net_if *iface)
+{
+	flat_iface = iface;
+	set_link_addr(iface, 1);
+}
+
+/* Folds 16 bit words, starting from an odd byte if odd is set */
+static u32_t sum_words(u32_t sum, const u8_t *data, size_t len, bool *odd)
+{
+	while (len--) {
+		sum += *odd ? *data : *data << 8;
+		*odd = !*odd;
+		data++;
+	}
+
+	return sum;
+}
+
+static void check(size_t len)
+{
+	struct net_ipv4_hdr *ip = (struct net_ipv4_hdr *)frame;
+	bool odd = false;
+	u32_t sum;
+	int i;
+
+	frame_ok = len == HDR_LEN + DATAGRAM && ntohs(ip->len) == len;
+	if (!frame_ok) {
+		return;
+	}
+
+	for (i = 0; i < DATAGRAM; i++) {
+		if (frame[HDR_LEN + i] != (u8_t)i) {
+			frame_ok = false;
+		}
+	}
+
+	/* the UDP checksum over the pseudo header */
+	sum = sum_words(IPPROTO_UDP + len - sizeof(*ip), (u8_t *)&ip->src,
+			2 * sizeof(struct in_addr), &odd);
+	sum = sum_words(sum, frame + sizeof(*ip), len - sizeof(*ip), &odd);
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	if (sum != 0xffff) {
+		frame_ok = false;
+	}
+}
+
+static int tester_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	int len = net_frag_linearize(frame, sizeof(frame), pkt, 0,
+				     net_pkt_get_len(pkt));
+
+	if (check_frame) {
+		frame_iovcnt = 0;
+		check(len);
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&sent);
+
+	return 0;
+}
+
+/* A DMA engine would read the fragments as they are */
+static int tester_send_iov(struct net_if *iface, struct net_pkt *pkt,
+			   const struct net_iovec *iov, int iovcnt)
+{
+	size_t len = 0;
+	int i;
+
+	if (check_frame) {
+		for (i = 0; i < iovcnt && len + iov[i].len <= sizeof(frame);
+		     i++) {
+			memcpy(frame + len, iov[i].base, iov[i].len);
+			len += iov[i].len;
+		}
+
+		frame_iovcnt = iovcnt;
+		check(i == iovcnt ? len : 0);
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&sent);
+
+	return 0;
+}
+
+static struct net_if_api net_tx_sg_if_api = {
+	.init = sg_iface_init,
+	.send = tester_send,
+	.send_iov = tester_send_iov,
+};
+
+static struct net_if_api net_tx_flat_if_api = {
+	.init = flat_iface_init,
+	.send = tester_send,
+};
+
+NET_DEVICE_INIT(net_tx_sg_test, "net_tx_sg_test",
+		net_tx_sg_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&net_tx_sg_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), MTU);
+
+NET_DEVICE_INIT(net_tx_flat_test, "net_tx_flat_test",
+		net_tx_sg_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&net_tx_flat_if_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), MTU);
+
+static struct net_context *sg_ctx, *flat_ctx;
+
+static struct net_context *get_context(struct net_if *iface,
+				       struct in_addr *addr)
+{
+	struct net_context *ctx;
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+		.sin_addr = *addr,
+	};
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, addr, NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	zassert_equal(net_context_get(AF_INET, SOCK_DGRAM, IPPROTO_UDP, &ctx),
+		      0, "Cannot get context");
+	zassert_equal(net_context_bind(ctx, (struct sockaddr *)&local,
+				       sizeof(local)), 0, "Cannot bind");
+
+	return ctx;
+}
+
+static void send_datagram(struct net_context *ctx, struct in_addr *peer)
+{
+	static u8_t buf[DATAGRAM];
+	struct sockaddr_in dst = {
+		.sin_family = AF_INET,
+		.sin_port = htons(PORT),
+		.sin_addr = *peer,
+	};
+	struct net_pkt *pkt;
+	int i;
+
+	for (i = 0; i < DATAGRAM; i++) {
+		buf[i] = i;
+	}
+
+	pkt = net_pkt_get_tx(ctx, K_FOREVER);
+	zassert_not_null(pkt, "Out of mem");
+	zassert_true(net_pkt_append_all(pkt, DATAGRAM, buf, K_FOREVER),
+		     "Out of mem");
+	zassert_equal(net_context_sendto(pkt, (struct sockaddr *)&dst,
+					 sizeof(dst), NULL, K_NO_WAIT, NULL,
+					 NULL), 0, "Cannot send");
+}
+
+/**
+ * @brief Test the capability follows the send_iov() callback
+ * @see net_if_is_tx_sg()
+ */
+void test_tx_sg_capability(void)
+{
+	zassert_true(net_if_is_tx_sg(sg_iface), "No scatter-gather");
+	zassert_false(net_if_is_tx_sg(flat_iface), "Scatter-gather");
+
+	sg_ctx = get_context(sg_iface, &sg_addr);
+	flat_ctx = get_context(flat_iface, &flat_addr);
+}
+
+static void check_sent(struct net_context *ctx, struct in_addr *peer)
+{
+	check_frame = true;
+	send_datagram(ctx, peer);
+	zassert_equal(k_sem_take(&sent, K_SECONDS(1)), 0, "Not sent");
+	check_frame = false;
+
+	zassert_true(frame_ok, "Wrong frame");
+}
+
+/**
+ * @brief Test datagrams are sent from their fragments
+ * @see net_pkt_get_iovec()
+ */
+void test_tx_sg_data(void)
+{
+	check_sent(sg_ctx, &sg_peer);
+	zassert_true(frame_iovcnt > 1, "Fragments not gathered");
+
+	check_sent(flat_ctx, &flat_peer);
+}
+
+static void measure(const char *name, struct net_context *ctx,
+		    struct in_addr *peer)
+{
+	u32_t start, cycles;
+	int i;
+
+	start = k_cycle_get_32();
+	for (i = 0; i < NUM_DATAGRAMS; i++) {
+		send_datagram(ctx, peer);
+	}
+
+	for (i = 0; i < NUM_DATAGRAMS; i++) {
+		zassert_equal(k_sem_take(&sent, K_SECONDS(1)), 0, "Not sent");
+	}
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%s: %d byte datagrams, %u cycles per datagram\n", name,
+		 DATAGRAM, cycles / NUM_DATAGRAMS);
+}
+
+/**
+ * @brief Measure the cost of sending large datagrams with and without
+ * scatter-gather
+ * @see net_context_sendto()
+ */
+void test_tx_sg_throughput(void)
+{
+	measure("scatter-gather", sg_ctx, &sg_peer);
+	measure("copy", flat_ctx, &flat_peer);
+}
+
+void test_tx_sg_close(void)
+{
+	net_context_put(sg_ctx);
+	net_context_put(flat_ctx);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_tx_sg,
+			 ztest_unit_test(test_tx_sg_capability),
+			 ztest_unit_test(test_tx_sg_data),
+			 ztest_unit_test(test_tx_sg_throughput),
+			 ztest_unit_test(test_tx_sg_close));
+	ztest_run_test_suite(test_tx_sg);
+}
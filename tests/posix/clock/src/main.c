@@ -36,9 +36,49 @@ void test_posix_clock(void)
 	printk("POSIX clock APIs test done\n");
 }
 
+void test_posix_clock_nanosleep(void)
+{
+	struct timespec deadline, now, req = { 0, 0 };
+	int i;
+
+	printk("POSIX clock_nanosleep() test\n");
+
+	/* absolute deadlines do not drift with the time spent between them */
+	clock_gettime(CLOCK_MONOTONIC, &deadline);
+	for (i = 0; i < 4; i++) {
+		deadline.tv_nsec += NSEC_PER_SEC / 4;
+		if (deadline.tv_nsec >= NSEC_PER_SEC) {
+			deadline.tv_nsec -= NSEC_PER_SEC;
+			deadline.tv_sec++;
+		}
+		k_busy_wait(USEC_PER_MSEC);
+		zassert_equal(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+					      &deadline, NULL), 0, NULL);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	zassert_true(now.tv_sec > deadline.tv_sec ||
+		     (now.tv_sec == deadline.tv_sec &&
+		      now.tv_nsec >= deadline.tv_nsec),
+		     "woke up before the deadline");
+
+	/* a deadline in the past returns right away */
+	zassert_equal(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME,
+				      &req, NULL), 0, NULL);
+
+	req.tv_nsec = NSEC_PER_SEC;
+	zassert_equal(clock_nanosleep(CLOCK_MONOTONIC, 0, &req, NULL),
+		      EINVAL, NULL);
+	zassert_equal(clock_nanosleep(CLOCK_REALTIME, 0, &now, NULL),
+		      EINVAL, NULL);
+
+	printk("POSIX clock_nanosleep() test done\n");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_posix_clock_api,
-			ztest_unit_test(test_posix_clock));
+			ztest_unit_test(test_posix_clock),
+			ztest_unit_test(test_posix_clock_nanosleep));
 	ztest_run_test_suite(test_posix_clock_api);
 }